@@ -1,11 +1,112 @@
 import React, { useRef, useEffect, useState } from 'react';
 import { videoService } from '../../services/videoService';
 import { videoFileService } from '../../services/videoFileService';
+import { wasmVideoService } from '../../services/wasmVideoService';
 import { useVideoProjectStore } from '../../stores/videoProjectStore';
+import type { ExtractedFrame } from '../../services/videoFileService';
+import type { EngineEffect } from '../../services/wasmVideoService';
+import type { VideoClip, VideoEffect } from '../../stores/videoProjectStore';
 import type { VideoDecoder, VideoFrame } from '../../wasm/video-engine.d.ts';
 
+// Position of each effect type the engine can run in its chain, which
+// always applies color, then filters, then transforms
+const ENGINE_CHAIN_ORDER: { [type: string]: number } = {
+  'color_correction': 1,
+  'blur': 2,
+  'noise_reduction': 2,
+  'sharpen': 2,
+  'edge_detection': 2,
+  'transform': 3
+};
+
+// A numeric parameter, or the fallback when it is unset or 0 (as `||`)
+const numberParameter = (effect: VideoEffect, name: string, fallback: number): number => {
+  const value = effect.parameters[name];
+  return typeof value === 'number' && value !== 0 ? value : fallback;
+};
+
+// The clip's effects for the effects engine, with the kernel parameters the
+// per-effect loop in renderVideoAtTime uses. null when an effect has no
+// chain kernel or the clip applies effects in an order the chain would not.
+const toEngineEffects = (effects: VideoEffect[]): EngineEffect[] | null => {
+  const engineEffects: EngineEffect[] = [];
+  let lastOrder = 0;
+
+  for (const effect of effects) {
+    if (!effect.enabled) continue;
+
+    const order = ENGINE_CHAIN_ORDER[effect.type];
+    if (!order || order < lastOrder) return null;
+    lastOrder = order;
+
+    switch (effect.type) {
+      case 'color_correction':
+        engineEffects.push({
+          type: 'color_correction',
+          enabled: true,
+          brightness: numberParameter(effect, 'brightness', 0),
+          contrast: numberParameter(effect, 'contrast', 0),
+          saturation: numberParameter(effect, 'saturation', 0),
+          hue: numberParameter(effect, 'hue', 0),
+          gamma: numberParameter(effect, 'gamma', 1),
+          exposure: numberParameter(effect, 'exposure', 0)
+        });
+        break;
+      case 'blur':
+        engineEffects.push({ type: 'blur', enabled: true, radius: numberParameter(effect, 'radius', 1), gaussian: false });
+        break;
+      case 'noise_reduction':
+        // js_apply_noise_reduction is a gaussian blur of radius strength * 2
+        engineEffects.push({ type: 'blur', enabled: true, radius: numberParameter(effect, 'strength', 0.5) * 2, gaussian: true });
+        break;
+      case 'sharpen':
+        engineEffects.push({ type: 'sharpen', enabled: true, intensity: numberParameter(effect, 'intensity', 0.5) });
+        break;
+      case 'edge_detection':
+        engineEffects.push({ type: 'edgeDetection', enabled: true, intensity: numberParameter(effect, 'intensity', 0.5) });
+        break;
+      case 'transform':
+        engineEffects.push({
+          type: 'transform',
+          enabled: true,
+          scale: numberParameter(effect, 'scale', 100),
+          rotation: numberParameter(effect, 'rotation', 0),
+          flipHorizontal: Boolean(effect.parameters.flipHorizontal),
+          flipVertical: Boolean(effect.parameters.flipVertical),
+          cropX: numberParameter(effect, 'cropX', 0),
+          cropY: numberParameter(effect, 'cropY', 0),
+          cropWidth: numberParameter(effect, 'cropWidth', 100),
+          cropHeight: numberParameter(effect, 'cropHeight', 100)
+        });
+        break;
+    }
+  }
+
+  return engineEffects;
+};
+
+// Source ids name decoded frames for the engine's caches: the same video
+// element and frame number always get the same id
+const videoSourceIds = new WeakMap<HTMLVideoElement, number>();
+let nextVideoSourceId = 1;
+const frameSourceId = (video: HTMLVideoElement, frameNumber: number): number => {
+  let videoId = videoSourceIds.get(video);
+  if (videoId === undefined) {
+    videoId = nextVideoSourceId++;
+    videoSourceIds.set(video, videoId);
+  }
+  return videoId * 0x1000000 + frameNumber + 1;
+};
+
 const VideoPreview: React.FC = () => {
   const canvasRef = useRef<HTMLCanvasElement>(null);
+  // Effects engine for paused renders, and the last frame it was given: while
+  // only effect parameters change (slider drags) the frame is reused, so the
+  // engine's stage cache can resume the chain at the edited effect
+  const engineReady = useRef<Promise<boolean> | null>(null);
+  const engineFrame = useRef<{ video: HTMLVideoElement; videoTime: number; frame: ExtractedFrame } | null>(null);
+  // Renders finish out of order; only the latest may draw
+  const renderGeneration = useRef(0);
   const { project, setCurrentTime, setPlaying, renderVersion } = useVideoProjectStore();
   const [decoder, setDecoder] = useState<VideoDecoder | null>(null);
   const [currentFrame, setCurrentFrame] = useState<VideoFrame | null>(null);
@@ -393,8 +494,45 @@ const VideoPreview: React.FC = () => {
     }
   };
 
+  // Render a clip's frame through the effects engine. False when the engine
+  // or the frame is unavailable, so the caller falls back to per-effect kernels.
+  const renderWithEngine = async (clip: VideoClip, time: number, effects: EngineEffect[],
+                                  generation: number): Promise<boolean> => {
+    if (!engineReady.current) {
+      engineReady.current = wasmVideoService.initialize().then(() => true, error => {
+        console.error('Effects engine unavailable, using per-effect kernels:', error);
+        return false;
+      });
+    }
+    if (!(await engineReady.current)) return false;
+
+    const video = clip.videoInfo.videoElement;
+    const videoTime = time - clip.startTime;
+    let cached = engineFrame.current;
+    if (!cached || cached.video !== video || cached.videoTime !== videoTime) {
+      const frame = await videoFileService.extractFrame(clip.videoInfo, videoTime);
+      if (!frame) return false;
+      cached = engineFrame.current = { video, videoTime, frame };
+    }
+    if (generation !== renderGeneration.current) return true; // Superseded
+
+    wasmVideoService.configureEffects(effects);
+    const output = wasmVideoService.processFrame(cached.frame.imageData, time,
+      frameSourceId(video, cached.frame.frameNumber));
+
+    const canvas = canvasRef.current;
+    const ctx = canvas?.getContext('2d');
+    if (canvas && ctx) {
+      canvas.width = output.width;
+      canvas.height = output.height;
+      ctx.putImageData(output, 0, 0);
+    }
+    return true;
+  };
+
   const renderVideoAtTime = async (time: number) => {
     if (!project) return;
+    const generation = ++renderGeneration.current;
 
     const videoTrack = project.tracks.find(t => t.type === 'video');
     if (!videoTrack || videoTrack.clips.length === 0) return;
@@ -414,6 +552,11 @@ const VideoPreview: React.FC = () => {
 
     if (activeClip) {
       try {
+        const engineEffects = project.isPlaying ? null : toEngineEffects(activeClip.effects);
+        if (engineEffects && await renderWithEngine(activeClip, time, engineEffects, generation)) {
+          return;
+        }
+
         // Extract frame from the video file
         const videoTime = time - activeClip.startTime;
         const frame = await videoFileService.extractFrame(activeClip.videoInfo, videoTime);
@@ -528,7 +671,7 @@ const VideoPreview: React.FC = () => {
 
           // Draw to canvas
           const canvas = canvasRef.current;
-          if (canvas) {
+          if (canvas && generation === renderGeneration.current) {
             const ctx = canvas.getContext('2d');
             if (ctx) {
               canvas.width = frame.imageData.width;
@@ -1,6 +1,72 @@
 import { VideoClip, Effect } from '../stores/videoProjectStore';
 import { videoService } from './videoService';
 
+// Command buffer layout; mirrors EFFECTS_COMMAND_* in effects_engine.h
+const COMMAND_MAGIC = 0x42434556; // "VECB"
+const COMMAND_VERSION = 2;
+const COMMAND_HEADER_WORDS = 16;
+const COMMAND_RECORD_WORDS = 10;
+const COMMAND_FLAGS_WORD = 2;
+const COMMAND_COUNT_WORD = 3;
+const COMMAND_TIMESTAMP_WORD = 4; // f64
+const COMMAND_BUDGET_WORD = 6;
+const COMMAND_CHAIN_COUNT_WORD = 9;
+const COMMAND_FRAMES_WORD = 12;
+const COMMAND_KEYFRAME_COUNT_WORD = 13;
+const COMMAND_SOURCE_WORD = 14; // u64
+const COMMAND_KEYFRAME_WORDS = 9;
+const COMMAND_MAX_KEYFRAMES = 128;
+const COMMAND_PROCESS = 0x1;
+const COMMAND_STATUS_FAILED = -1;
+
+// effect_type_t
+const EFFECT_TYPE_FILTER = 0;
+const EFFECT_TYPE_TRANSFORM = 2;
+const EFFECT_TYPE_COLOR_CORRECTION = 3;
+const EFFECT_TYPE_BLUR = 4;
+
+// filter_type_t, for the filters the effects chain runs
+const FILTER_TYPES: { [key: string]: number } = {
+  'sharpen': 5,
+  'edgeDetection': 7
+};
+
+// keyframe_interp_t
+const KEYFRAME_INTERPOLATION = { linear: 0, bezier: 1, hold: 2 };
+
+/** One keyframe of an animated effect parameter */
+export interface EffectKeyframe {
+  param: number; // effect_param_t (EFFECT_PARAM_* in effects_engine.h)
+  time: number; // timeline seconds
+  value: number;
+  interpolation?: keyof typeof KEYFRAME_INTERPOLATION; // of the segment starting here
+  ease?: [number, number, number, number]; // Bezier x1, y1, x2, y2
+}
+
+/** An effect as configureEffects reads it, with its parameters flattened onto it */
+export interface EngineEffect {
+  type: string;
+  enabled: boolean;
+  brightness?: number;
+  contrast?: number;
+  saturation?: number;
+  hue?: number;
+  gamma?: number;
+  exposure?: number;
+  intensity?: number;
+  radius?: number; // blur, in pixels; defaults to intensity * 20
+  gaussian?: boolean; // blur; defaults to true
+  scale?: number;
+  rotation?: number;
+  flipHorizontal?: boolean;
+  flipVertical?: boolean;
+  cropX?: number;
+  cropY?: number;
+  cropWidth?: number;
+  cropHeight?: number;
+  keyframes?: EffectKeyframe[];
+}
+
 export interface WasmExportOptions {
   format: 'webm' | 'mp4';
   fps: number;
@@ -28,6 +94,18 @@ export class WasmVideoService {
   private wasmModule: any = null;
   private effectsEnginePtr: number = 0;
   private exportJobPtr: number = 0;
+  private sessionWidth: number = 0;
+  private sessionHeight: number = 0;
+  private outputWidth: number = 0;
+  private outputHeight: number = 0;
+  private inputSlotPtr: number = 0;
+  private outputSlotPtr: number = 0;
+  private commandPtr: number = 0;
+  private commandViews: { u32: Uint32Array; f32: Float32Array; f64: Float64Array } | null = null;
+  private commandBufferSupported: boolean = false;
+  private static readonly MAX_EFFECTS_CHAIN = 32;
+  private static readonly COMMAND_KEYFRAME_OFFSET = COMMAND_HEADER_WORDS +
+    WasmVideoService.MAX_EFFECTS_CHAIN * COMMAND_RECORD_WORDS;
   private canvas: HTMLCanvasElement;
   private ctx: CanvasRenderingContext2D;
   private framesProcessed: number = 0;
@@ -38,6 +116,9 @@ export class WasmVideoService {
   }
 
   async initialize(): Promise<void> {
+    // Preview and export share the engine (and its caches and command buffer)
+    if (this.effectsEnginePtr !== 0) return;
+
     // Reuse the existing video service WASM module
     await videoService.initialize();
     this.wasmModule = (videoService as any).wasmModule;
@@ -52,76 +133,171 @@ export class WasmVideoService {
       throw new Error('Failed to create effects engine');
     }
 
+    // Modules built before the command-buffer engine only have the
+    // per-effect js_effect_chain_* bindings; fall back to those
+    this.commandBufferSupported = typeof this.wasmModule._js_engine_submit_commands === 'function';
+    if (!this.commandBufferSupported) {
+      console.warn('WASM module predates the command-buffer engine; rebuild it for keyframes, sessions and render scale');
+    }
+
     console.log('✅ WasmVideoService initialized with effects engine:', this.effectsEnginePtr);
   }
 
   /**
-   * Apply effects configuration to the WASM effects engine
+   * Apply effects configuration to the WASM effects engine.
+   *
+   * The chain is encoded into the engine's command buffer and submitted in
+   * one call; the engine diffs it against its current chain.
    */
-  configureEffects(effects: Effect[]): void {
+  configureEffects(effects: EngineEffect[]): void {
     if (this.effectsEnginePtr === 0) {
       console.warn('Effects engine not initialized');
       return;
     }
+    if (!this.commandBufferSupported) {
+      this.configureEffectsPerCall(effects);
+      return;
+    }
 
-    // Clear existing effects
-    this.wasmModule.ccall('js_effect_chain_clear', 'void', ['number'], [this.effectsEnginePtr]);
+    const commands = this.getCommandViews();
+    let count = 0;
+    let keyframeCount = 0;
 
-    // Add each effect to the chain
     for (const effect of effects) {
       if (!effect.enabled) continue;
+      if (count >= WasmVideoService.MAX_EFFECTS_CHAIN) {
+        console.warn(`Effects chain is limited to ${WasmVideoService.MAX_EFFECTS_CHAIN} effects`);
+        break;
+      }
+
+      const record = COMMAND_HEADER_WORDS + count * COMMAND_RECORD_WORDS;
+      commands.u32.fill(0, record, record + COMMAND_RECORD_WORDS);
+      const params = record + 2;
+
+      switch (effect.type) {
+        case 'color_correction':
+        case 'colorCorrection':
+          commands.u32[record] = EFFECT_TYPE_COLOR_CORRECTION;
+          commands.f32.set([effect.brightness || 0, effect.contrast || 0, effect.saturation || 0,
+                            effect.hue || 0, effect.gamma || 1.0, effect.exposure || 0], params);
+          break;
+
+        case 'blur':
+          commands.u32[record] = EFFECT_TYPE_BLUR;
+          commands.f32.set([effect.radius || (effect.intensity || 0) * 20,
+                            effect.gaussian === false ? 0 : 1, 1], params); // one iteration
+          break;
+
+        case 'transform':
+          commands.u32[record] = EFFECT_TYPE_TRANSFORM;
+          commands.f32.set([effect.scale || 100, effect.rotation || 0,
+                            effect.flipHorizontal ? 1 : 0, effect.flipVertical ? 1 : 0,
+                            effect.cropX || 0, effect.cropY || 0,
+                            effect.cropWidth || 100, effect.cropHeight || 100], params);
+          break;
+
+        case 'sharpen':
+        case 'edgeDetection':
+          commands.u32[record] = EFFECT_TYPE_FILTER;
+          commands.u32[record + 1] = FILTER_TYPES[effect.type];
+          commands.f32[params] = effect.intensity || 1.0;
+          break;
+
+        case 'sepia':
+        case 'blackAndWhite':
+        case 'vintage':
+        case 'vignette':
+          console.warn(`The effects chain has no ${effect.type} kernel`);
+          continue;
+
+        default:
+          console.warn(`Unknown effect type: ${effect.type}`);
+          continue;
+      }
 
-      try {
-        switch (effect.type) {
-          case 'color_correction':
-          case 'colorCorrection':
-            this.wasmModule.ccall('js_effect_chain_add_color_correction', 'number',
-              ['number', 'number', 'number', 'number', 'number'],
-              [this.effectsEnginePtr, effect.brightness || 0, effect.contrast || 0,
-               effect.saturation || 0, effect.hue || 0]);
-            break;
-
-          case 'blur':
-            this.wasmModule.ccall('js_effect_chain_add_blur', 'number',
-              ['number', 'number', 'number'],
-              [this.effectsEnginePtr, effect.intensity * 20, 1]); // gaussian blur
-            break;
-
-          case 'transform':
-            this.wasmModule.ccall('js_effect_chain_add_transform', 'number',
-              ['number', 'number', 'number', 'number', 'number'],
-              [this.effectsEnginePtr, effect.scale || 100, effect.rotation || 0,
-               effect.flipHorizontal ? 1 : 0, effect.flipVertical ? 1 : 0]);
-            break;
-
-          case 'sepia':
-          case 'blackAndWhite':
-          case 'vintage':
-          case 'vignette':
-          case 'sharpen':
-          case 'edgeDetection':
-            // Map string effect types to filter enum values
-            const filterTypeMap: { [key: string]: number } = {
-              'sepia': 6,
-              'blackAndWhite': 7,
-              'vintage': 8,
-              'vignette': 9,
-              'sharpen': 2,
-              'edgeDetection': 3
-            };
-
-            const filterType = filterTypeMap[effect.type] || 0;
-            this.wasmModule.ccall('js_effect_chain_add_filter', 'number',
-              ['number', 'number', 'number'],
-              [this.effectsEnginePtr, filterType, effect.intensity || 1.0]);
-            break;
-
-          default:
-            console.warn(`Unknown effect type: ${effect.type}`);
-            break;
+      const keyframes: EffectKeyframe[] = effect.keyframes || [];
+      for (const keyframe of keyframes) {
+        if (keyframeCount >= COMMAND_MAX_KEYFRAMES) {
+          console.warn(`Effects chain is limited to ${COMMAND_MAX_KEYFRAMES} keyframes`);
+          break;
         }
-      } catch (error) {
-        console.error(`Failed to add effect ${effect.type}:`, error);
+        const word = WasmVideoService.COMMAND_KEYFRAME_OFFSET + keyframeCount * COMMAND_KEYFRAME_WORDS;
+        commands.u32[word] = count;
+        commands.u32[word + 1] = keyframe.param;
+        commands.u32[word + 2] = KEYFRAME_INTERPOLATION[keyframe.interpolation || 'linear'];
+        commands.f32.set([keyframe.time, keyframe.value, ...(keyframe.ease || [0, 0, 1, 1])], word + 3);
+        keyframeCount++;
+      }
+      count++;
+    }
+
+    commands.u32[COMMAND_COUNT_WORD] = count;
+    commands.u32[COMMAND_KEYFRAME_COUNT_WORD] = keyframeCount;
+    commands.u32[COMMAND_FLAGS_WORD] = 0;
+    const status = this.wasmModule.ccall('js_engine_submit_commands', 'number', ['number'], [this.effectsEnginePtr]);
+    if (status === COMMAND_STATUS_FAILED) {
+      console.error('WASM engine rejected the effects command buffer');
+      return;
+    }
+
+    const effectCount = this.getCommandViews().u32[COMMAND_CHAIN_COUNT_WORD];
+    console.log(`🎨 Applied ${effectCount} effects to WASM engine`);
+  }
+
+  /**
+   * configureEffects for modules without the command buffer: rebuild the
+   * chain one binding call per effect. Keyframes are not supported there.
+   */
+  private configureEffectsPerCall(effects: EngineEffect[]): void {
+    this.wasmModule.ccall('js_effect_chain_clear', 'void', ['number'], [this.effectsEnginePtr]);
+
+    for (const effect of effects) {
+      if (!effect.enabled) continue;
+
+      switch (effect.type) {
+        case 'color_correction':
+        case 'colorCorrection':
+          this.wasmModule.ccall('js_effect_chain_add_color_correction', 'number',
+            ['number', 'number', 'number', 'number', 'number'],
+            [this.effectsEnginePtr, effect.brightness || 0, effect.contrast || 0,
+             effect.saturation || 0, effect.hue || 0]);
+          break;
+
+        case 'blur':
+          this.wasmModule.ccall('js_effect_chain_add_blur', 'number',
+            ['number', 'number', 'number'],
+            [this.effectsEnginePtr, effect.radius || (effect.intensity || 0) * 20,
+             effect.gaussian === false ? 0 : 1]);
+          break;
+
+        case 'transform':
+          this.wasmModule.ccall('js_effect_chain_add_transform', 'number',
+            ['number', 'number', 'number', 'number', 'number'],
+            [this.effectsEnginePtr, effect.scale || 100, effect.rotation || 0,
+             effect.flipHorizontal ? 1 : 0, effect.flipVertical ? 1 : 0]);
+          break;
+
+        case 'sharpen':
+        case 'edgeDetection':
+          this.wasmModule.ccall('js_effect_chain_add_filter', 'number',
+            ['number', 'number', 'number'],
+            [this.effectsEnginePtr, FILTER_TYPES[effect.type], effect.intensity || 1.0]);
+          break;
+
+        case 'sepia':
+        case 'blackAndWhite':
+        case 'vintage':
+        case 'vignette':
+          console.warn(`The effects chain has no ${effect.type} kernel`);
+          continue;
+
+        default:
+          console.warn(`Unknown effect type: ${effect.type}`);
+          continue;
+      }
+
+      if (effect.keyframes?.length) {
+        console.warn(`Keyframes on ${effect.type} need a rebuilt WASM module; using static values`);
       }
     }
 
@@ -131,47 +307,188 @@ export class WasmVideoService {
   }
 
   /**
-   * Process a single frame with all configured effects
+   * Typed-array views over the engine's command buffer. Recreated when
+   * memory growth replaces the WASM heap buffer.
+   */
+  private getCommandViews(): { u32: Uint32Array; f32: Float32Array; f64: Float64Array } {
+    const buffer = this.wasmModule.HEAPU8.buffer;
+    if (!this.commandViews || this.commandViews.u32.buffer !== buffer) {
+      if (this.commandPtr === 0) {
+        this.commandPtr = this.wasmModule.ccall('js_engine_get_command_buffer', 'number',
+          ['number'], [this.effectsEnginePtr]);
+      }
+
+      const words = WasmVideoService.COMMAND_KEYFRAME_OFFSET + COMMAND_MAX_KEYFRAMES * COMMAND_KEYFRAME_WORDS;
+      this.commandViews = {
+        u32: new Uint32Array(buffer, this.commandPtr, words),
+        f32: new Float32Array(buffer, this.commandPtr, words),
+        f64: new Float64Array(buffer, this.commandPtr, words / 2),
+      };
+
+      // Header fields that never change
+      this.commandViews.u32[0] = COMMAND_MAGIC;
+      this.commandViews.u32[1] = COMMAND_VERSION;
+    }
+    return this.commandViews;
+  }
+
+  /**
+   * Process a single frame with all configured effects.
+   *
+   * Frames go through the engine's session slots: the pixels are written
+   * straight into the input slot and the result is returned as an ImageData
+   * view over the output slot, with no per-frame WASM allocations and no copy
+   * back out. The returned ImageData aliases engine memory and is only valid
+   * until the next processed frame; copy it if it must outlive that.
+   * frameData itself is never modified.
+   *
+   * sourceId names the input pixels (e.g. a decoded frame's index + 1);
+   * re-processing the same id while one effect's parameters change (a
+   * slider drag) resumes the chain at that effect. 0 means unknown and
+   * disables that reuse.
    */
-  processFrame(frameData: ImageData, timestamp: number): ImageData {
+  processFrame(frameData: ImageData, timestamp: number, sourceId: number = 0): ImageData {
     if (this.effectsEnginePtr === 0) {
       return frameData; // Return unprocessed if no effects engine
     }
 
-    try {
-      // Allocate WASM memory for frame data
-      const frameSize = frameData.width * frameData.height * 4; // RGBA
-      const wasmFramePtr = this.wasmModule.ccall('js_malloc', 'number', ['number'], [frameSize]);
+    if (!this.commandBufferSupported) {
+      return this.processFramePerCall(frameData, timestamp);
+    }
 
-      if (wasmFramePtr === 0) {
-        console.error('Failed to allocate WASM memory for frame');
+    try {
+      const input = this.getInputView(frameData.width, frameData.height);
+      if (!input) {
+        console.error('Failed to size WASM session slots');
         return frameData;
       }
 
-      // Copy frame data to WASM memory
-      this.wasmModule.HEAPU8.set(frameData.data, wasmFramePtr);
+      input.set(frameData.data);
+      return this.processSession(timestamp, 0, sourceId) ?? frameData;
+    } catch (error) {
+      console.error('Error processing frame:', error);
+      return frameData;
+    }
+  }
+
+  /**
+   * processFrame for modules without session slots: copy the frame into a
+   * temporary WASM buffer, process it there and copy the result out.
+   */
+  private processFramePerCall(frameData: ImageData, timestamp: number): ImageData {
+    const frameSize = frameData.width * frameData.height * 4; // RGBA
+    const wasmFramePtr = this.wasmModule.ccall('js_malloc', 'number', ['number'], [frameSize]);
+    if (wasmFramePtr === 0) {
+      console.error('Failed to allocate WASM memory for frame');
+      return frameData;
+    }
 
-      // Process frame with effects
+    try {
+      this.wasmModule.HEAPU8.set(frameData.data, wasmFramePtr);
       const success = this.wasmModule.ccall('js_effects_process_frame', 'number',
         ['number', 'number', 'number', 'number', 'number', 'number'],
         [this.effectsEnginePtr, wasmFramePtr, frameData.width, frameData.height, 1, timestamp]);
 
-      if (success) {
-        // Copy processed data back to ImageData
-        const processedData = new Uint8ClampedArray(
-          this.wasmModule.HEAPU8.subarray(wasmFramePtr, wasmFramePtr + frameSize)
-        );
-        frameData.data.set(processedData);
-      }
-
-      // Free WASM memory
-      this.wasmModule.ccall('js_free', 'void', ['number'], [wasmFramePtr]);
-
-      return frameData;
+      if (!success) return frameData;
+      const pixels = new Uint8ClampedArray(this.wasmModule.HEAPU8.buffer.slice(wasmFramePtr, wasmFramePtr + frameSize));
+      return new ImageData(pixels, frameData.width, frameData.height);
     } catch (error) {
       console.error('Error processing frame:', error);
       return frameData;
+    } finally {
+      this.wasmModule.ccall('js_free', 'void', ['number'], [wasmFramePtr]);
+    }
+  }
+
+  /**
+   * View of the engine's input slot for a width x height frame. Producers
+   * that can render into a buffer (VideoFrame.copyTo, decoders) should write
+   * here directly and then call processSession.
+   */
+  getInputView(width: number, height: number): Uint8ClampedArray | null {
+    if (!this.commandBufferSupported) return null;
+    if (!this.ensureSession(width, height)) return null;
+
+    // Re-read HEAPU8 each time: memory growth replaces the underlying buffer
+    return new Uint8ClampedArray(this.wasmModule.HEAPU8.buffer, this.inputSlotPtr, width * height * 4);
+  }
+
+  /**
+   * Run the effects chain on the input slot; returns the output slot as an
+   * ImageData view, or null if processing failed or was cancelled. One WASM
+   * call: the request rides in the command buffer with the current chain.
+   * sourceId is as for processFrame; the same id must mean the same pixels.
+   */
+  processSession(timestamp: number, budgetMs: number = 0, sourceId: number = 0): ImageData | null {
+    if (!this.commandBufferSupported) return null;
+
+    const commands = this.getCommandViews();
+    commands.u32[COMMAND_FLAGS_WORD] = COMMAND_PROCESS;
+    commands.f64[COMMAND_TIMESTAMP_WORD / 2] = timestamp;
+    commands.f32[COMMAND_BUDGET_WORD] = budgetMs;
+    commands.u32[COMMAND_SOURCE_WORD] = sourceId % 0x100000000; // Exact for any safe integer
+    commands.u32[COMMAND_SOURCE_WORD + 1] = Math.floor(sourceId / 0x100000000);
+
+    const quality = this.wasmModule.ccall('js_engine_submit_commands', 'number', ['number'], [this.effectsEnginePtr]);
+    if (quality < 0) return null;
+
+    const pixels = new Uint8ClampedArray(this.wasmModule.HEAPU8.buffer, this.outputSlotPtr,
+      this.outputWidth * this.outputHeight * 4);
+    return new ImageData(pixels, this.outputWidth, this.outputHeight);
+  }
+
+  /**
+   * After processSession had to drop quality to meet its budget (paused on a
+   * heavy chain), re-render at full quality up to maxBands row bands at a
+   * time; call from idle callbacks until it returns 0. The ImageData from
+   * processSession views the output slot, so redrawing it after each call
+   * shows the refined rows. Returns the bands left, or -1 on failure.
+   */
+  refineSession(maxBands: number = 1): number {
+    if (this.effectsEnginePtr === 0 || !this.commandBufferSupported) return -1;
+
+    return this.wasmModule.ccall('js_engine_refine_session', 'number',
+      ['number', 'number'], [this.effectsEnginePtr, maxBands]);
+  }
+
+  /**
+   * Resize the engine's session slots when the frame size changes
+   */
+  private ensureSession(width: number, height: number): boolean {
+    if (this.sessionWidth === width && this.sessionHeight === height) {
+      return true;
     }
+
+    const ok = this.wasmModule.ccall('js_engine_set_session_size', 'number',
+      ['number', 'number', 'number'], [this.effectsEnginePtr, width, height]);
+    if (!ok) return false;
+
+    this.inputSlotPtr = this.wasmModule.ccall('js_engine_get_input_slot', 'number', ['number'], [this.effectsEnginePtr]);
+    this.outputSlotPtr = this.wasmModule.ccall('js_engine_get_output_slot', 'number', ['number'], [this.effectsEnginePtr]);
+    this.sessionWidth = width;
+    this.sessionHeight = height;
+    this.readOutputSize();
+    return true;
+  }
+
+  /**
+   * Preview at 1/scale resolution (1, 2 or 4). Frames are downscaled on
+   * ingest and spatial effect parameters are scaled to match, so processed
+   * frames come back smaller but look like a downscaled full-resolution
+   * render; draw them scaled up to the display size.
+   */
+  setRenderScale(scale: 1 | 2 | 4): boolean {
+    if (this.effectsEnginePtr === 0 || !this.commandBufferSupported) return false;
+
+    const ok = this.wasmModule.ccall('js_engine_set_render_scale', 'number',
+      ['number', 'number'], [this.effectsEnginePtr, scale]);
+    if (ok) this.readOutputSize();
+    return ok === 1;
+  }
+
+  private readOutputSize(): void {
+    this.outputWidth = this.wasmModule.ccall('js_engine_get_output_width', 'number', ['number'], [this.effectsEnginePtr]);
+    this.outputHeight = this.wasmModule.ccall('js_engine_get_output_height', 'number', ['number'], [this.effectsEnginePtr]);
   }
 
   /**
@@ -761,6 +1078,10 @@ export class WasmVideoService {
     if (this.effectsEnginePtr !== 0) {
       this.wasmModule.ccall('js_effects_engine_destroy', 'void', ['number'], [this.effectsEnginePtr]);
       this.effectsEnginePtr = 0;
+      this.sessionWidth = 0; // Slots and command buffer die with the engine
+      this.sessionHeight = 0;
+      this.commandPtr = 0;
+      this.commandViews = null;
     }
   }
 }
@@ -0,0 +1,49 @@
+#ifndef ADAPTIVE_QUALITY_H
+#define ADAPTIVE_QUALITY_H
+
+#include "video_engine.h"
+
+// Preview quality levels, most expensive first. Each level includes the
+// savings of the previous ones.
+typedef enum {
+    RENDER_QUALITY_FULL = 0,    // Full resolution, full quality kernels
+    RENDER_QUALITY_REDUCED = 1, // Halved blur radius, nearest resampling, no denoise
+    RENDER_QUALITY_HALF = 2,    // Reduced kernels on a half resolution proxy
+    RENDER_QUALITY_QUARTER = 3, // Reduced kernels on a quarter resolution proxy
+    RENDER_QUALITY_COUNT
+} render_quality_t;
+
+// Kernels whose cost is tracked separately
+typedef enum {
+    EFFECT_COST_COLOR_CORRECTION = 0,
+    EFFECT_COST_BLUR,              // Per pixel and kernel tap
+    EFFECT_COST_SHARPEN,
+    EFFECT_COST_EDGE_DETECTION,
+    EFFECT_COST_NOISE_REDUCTION,
+    EFFECT_COST_FILTER,            // Other generic filters
+    EFFECT_COST_TRANSFORM,         // Bilinear resampling
+    EFFECT_COST_TRANSFORM_NEAREST,
+    EFFECT_COST_RESAMPLE,          // Proxy down + upscale, per full-res pixel
+    EFFECT_COST_COUNT
+} effect_cost_kind_t;
+
+// Online cost model: moving average of nanoseconds per work unit (a pixel,
+// or a pixel-tap for blur) per kernel, seeded with conservative priors until
+// the kernel has actually been measured on this machine
+typedef struct effect_cost_model_t {
+    double ns_per_unit[EFFECT_COST_COUNT];
+    int samples[EFFECT_COST_COUNT];
+} effect_cost_model_t;
+
+EMSCRIPTEN_KEEPALIVE void effect_cost_model_init(effect_cost_model_t* model);
+EMSCRIPTEN_KEEPALIVE void effect_cost_model_record(effect_cost_model_t* model, effect_cost_kind_t kind,
+                                                   double units, uint64_t elapsed_ns);
+EMSCRIPTEN_KEEPALIVE double effect_cost_model_estimate(const effect_cost_model_t* model, effect_cost_kind_t kind,
+                                                       double units);
+EMSCRIPTEN_KEEPALIVE const char* effect_cost_kind_name(effect_cost_kind_t kind);
+
+// Quality level properties
+EMSCRIPTEN_KEEPALIVE int render_quality_proxy_factor(render_quality_t quality);
+EMSCRIPTEN_KEEPALIVE bool render_quality_reduced(render_quality_t quality);
+
+#endif // ADAPTIVE_QUALITY_H
@@ -0,0 +1,59 @@
+#ifndef DISK_CACHE_H
+#define DISK_CACHE_H
+
+#include "video_engine.h"
+#include <stddef.h>
+
+// Full-quality rendered frames spilled to a local directory, keyed like the
+// result cache (source identity, canonical chain hash, size, scale), so
+// re-renders, multi-rendition exports and resumed jobs reuse work across
+// processes and restarts. Source ids must name the same pixels in every
+// process sharing the directory.
+//
+// One file per frame, QOI-compressed when that is smaller, written by a
+// background thread to a temporary name and renamed into place, so readers
+// never see a partial frame. Least recently used files (by mtime, refreshed
+// on every hit) are deleted to stay within the byte budget. Frames are
+// stored under the caller's key mixed with VIDEO_ENGINE_RENDER_VERSION, so a
+// build with different kernels never reads them. Native builds only:
+// elsewhere disk_cache_open returns NULL and the engine skips the cache.
+//
+// A native render host (an exporter or batch renderer linking the engine
+// directly) attaches one cache to its engines and names every frame:
+//   disk_cache_t* cache = disk_cache_open(directory, budget);
+//   effects_engine_set_disk_cache(engine, cache);       // Shareable by engines
+//   per frame:
+//     effects_engine_set_source_id(engine, source_id);  // Same id = same pixels
+//     effects_process_frame(engine, frame, timestamp);  // Read, or render and store
+//   effects_engine_set_disk_cache(engine, NULL);        // Every engine, then
+//   disk_cache_close(cache);
+#if !defined(__EMSCRIPTEN__)
+#define DISK_CACHE_AVAILABLE 1
+#else
+#define DISK_CACHE_AVAILABLE 0
+#endif
+
+#define DISK_CACHE_MAX_PENDING (256u << 20) // Queued frames; writes beyond are dropped
+#define DISK_CACHE_STALE_TMP_SECONDS 600    // Leftovers of a crashed writer
+
+typedef struct disk_cache_t disk_cache_t;
+
+// Open (creating if needed) a cache directory and index the frames already
+// in it; NULL on failure or when unavailable
+EMSCRIPTEN_KEEPALIVE disk_cache_t* disk_cache_open(const char* directory, uint64_t budget);
+// Finishes queued writes, then frees the cache; the files stay
+EMSCRIPTEN_KEEPALIVE void disk_cache_close(disk_cache_t* cache);
+// Evicts down to the new budget
+EMSCRIPTEN_KEEPALIVE void disk_cache_set_budget(disk_cache_t* cache, uint64_t budget);
+EMSCRIPTEN_KEEPALIVE uint64_t disk_cache_get_used(disk_cache_t* cache);
+
+// Read the frame cached under key into frame (same size). Also finds frames
+// other processes wrote since the directory was indexed.
+EMSCRIPTEN_KEEPALIVE bool disk_cache_lookup(disk_cache_t* cache, uint64_t key, video_frame_t* frame);
+// Queue a full-quality frame for writing; returns at once. False when the
+// write was dropped because the queue is full.
+EMSCRIPTEN_KEEPALIVE bool disk_cache_store(disk_cache_t* cache, uint64_t key, const video_frame_t* frame);
+// Wait until every queued frame is on disk
+EMSCRIPTEN_KEEPALIVE void disk_cache_flush(disk_cache_t* cache);
+
+#endif // DISK_CACHE_H
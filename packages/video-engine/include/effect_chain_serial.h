@@ -0,0 +1,40 @@
+#ifndef EFFECT_CHAIN_SERIAL_H
+#define EFFECT_CHAIN_SERIAL_H
+
+#include "effects_engine.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary chain format (little-endian):
+//   u32 magic, u16 version, u16 effect count, then per effect:
+//   u8 type, u8 flags (bit 0 enabled), u8 priority, u8 reserved, f64 start, f64 end,
+//   type-specific parameters, i32 track count, then per keyframe track:
+//   u8 effect_param_t, u8 keyframe count, u16 reserved, then per keyframe:
+//   u8 keyframe_interp_t, f32 time, f32 value, f32 Bezier x1, y1, x2, y2.
+// Version 1 chains (an unused f32 curve in place of the tracks) still load.
+#define CHAIN_SERIAL_MAGIC 0x4E484345u // "ECHN"
+#define CHAIN_SERIAL_VERSION 2
+
+// Serialize into out; returns the size the chain needs, which may exceed
+// capacity (nothing past capacity is written). Pass out = NULL to size.
+EMSCRIPTEN_KEEPALIVE size_t effect_chain_serialize(const effect_chain_t* chain, uint8_t* out, size_t capacity);
+// Replace the chain's effects; the chain is untouched on malformed input
+EMSCRIPTEN_KEEPALIVE bool effect_chain_deserialize(effect_chain_t* chain, const uint8_t* data, size_t size);
+
+// Canonical identity of "the same look": effects hashed in processing order,
+// disabled effects skipped, only the parameters a type uses, and floats
+// normalised (-0 = 0, one NaN, mantissa rounded to 15 bits)
+EMSCRIPTEN_KEEPALIVE uint64_t effect_chain_hash(const effect_chain_t* chain);
+// As above, restricted to effects active at timestamp (the chain's active
+// plan, so it may sort the chain), with keyframed parameters hashed as
+// evaluated there; time ranges and tracks excluded. 0 when out of memory.
+EMSCRIPTEN_KEEPALIVE uint64_t effect_chain_hash_at(effect_chain_t* chain, double timestamp);
+// Canonical hash of a single effect, chained from seed (0 to start)
+EMSCRIPTEN_KEEPALIVE uint64_t effect_hash(const effect_t* effect, uint64_t seed);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE int js_effects_chain_serialize(engine_handle_t engine_handle, uint8_t* out, int capacity);
+EMSCRIPTEN_KEEPALIVE int js_effects_chain_deserialize(engine_handle_t engine_handle, const uint8_t* data, int size);
+EMSCRIPTEN_KEEPALIVE const char* js_effects_chain_hash(engine_handle_t engine_handle);
+
+#endif // EFFECT_CHAIN_SERIAL_H
@@ -4,16 +4,29 @@
 #include "video_engine.h"
 #include "filters.h"
 #include "transitions.h"
+#include "frame_ring.h"
+#include "render_scheduler.h"
+#include "adaptive_quality.h"
+#include "latency_histogram.h"
+#include "handle_table.h"
+#include "stage_cache.h"
+#include "result_cache.h"
+#include "disk_cache.h"
+#include "keyframe_track.h"
+#include "interval_index.h"
 
-// Maximum number of effects in a chain
+// Maximum number of effects active at one timestamp (and in a command buffer)
 #define MAX_EFFECTS_CHAIN 32
+// Maximum number of time-ranged effects a chain holds across a timeline
+#define EFFECT_CHAIN_MAX_EFFECTS 4096
 
 // Effect types
 typedef enum {
     EFFECT_TYPE_FILTER,
     EFFECT_TYPE_TRANSITION,
     EFFECT_TYPE_TRANSFORM,
-    EFFECT_TYPE_COLOR_CORRECTION
+    EFFECT_TYPE_COLOR_CORRECTION,
+    EFFECT_TYPE_BLUR               // params.blur
 } effect_type_t;
 
 // Effect processing order/priority
@@ -24,6 +37,27 @@ typedef enum {
     EFFECT_PRIORITY_TRANSITION = 4         // Last: Transitions
 } effect_priority_t;
 
+// Animatable parameters, each belonging to one effect type
+typedef enum {
+    EFFECT_PARAM_BRIGHTNESS = 0,   // Color correction
+    EFFECT_PARAM_CONTRAST,
+    EFFECT_PARAM_SATURATION,
+    EFFECT_PARAM_HUE,
+    EFFECT_PARAM_GAMMA,
+    EFFECT_PARAM_EXPOSURE,
+    EFFECT_PARAM_BLUR_RADIUS,      // Blur
+    EFFECT_PARAM_SCALE,            // Transform
+    EFFECT_PARAM_ROTATION,
+    EFFECT_PARAM_INTENSITY,        // Filter
+    EFFECT_PARAM_COUNT
+} effect_param_t;
+
+// Animated parameters per effect
+#define EFFECT_MAX_TRACKS 4
+
+// Tone LUTs an effect chain keeps for its color corrections
+#define EFFECT_CHAIN_LUTS 4
+
 // Generic effect structure
 typedef struct effect_t {
     effect_type_t type;
@@ -41,36 +75,204 @@ typedef struct effect_t {
     // Effect metadata
     double start_time;
     double end_time;
-    float intensity_curve[8]; // For keyframe animation
-    int keyframe_count;
+
+    // Keyframed parameters; the values in params apply where none is set.
+    // Must stay last: evaluated copies skip them.
+    int track_count;
+    keyframe_track_t tracks[EFFECT_MAX_TRACKS];
 } effect_t;
 
+// Effects active at a timestamp, in processing order, and the window of
+// timestamps around it where the same effects are active
+typedef struct effect_chain_plan_t {
+    int count;
+    int indices[MAX_EFFECTS_CHAIN];  // Into the chain's effects
+    interval_window_t window;
+    uint32_t revision;               // Chain revision it was made for
+    bool valid;
+} effect_chain_plan_t;
+
 // Effect chain structure
 typedef struct effect_chain_t {
-    effect_t effects[MAX_EFFECTS_CHAIN];
+    effect_t* effects;      // Grown as needed up to EFFECT_CHAIN_MAX_EFFECTS
     int count;
+    int capacity;
     bool sorted;
-    memory_pool_t* memory_pool;
+    uint32_t revision;      // Bumped by every change to the effects
 
-    // Processing state
-    video_frame_t* temp_frame_1;
-    video_frame_t* temp_frame_2;
-    bool temp_frames_allocated;
+    // Enabled effects by time range, rebuilt when the revision moves on, and
+    // the plan of the last timestamp looked up, reused while frames stay in
+    // its window
+    interval_index_t index;
+    uint32_t index_revision;
+    bool index_valid;
+    effect_chain_plan_t plan;
+
+    // Animation state of the processing thread
+    uint8_t (*keyframe_hints)[EFFECT_MAX_TRACKS]; // Last segment per track, per effect
+    effect_t evaluated[MAX_EFFECTS_CHAIN]; // Planned effects at the frame's time
+    color_lut_t luts[EFFECT_CHAIN_LUTS];
+    uint32_t lut_last_used[EFFECT_CHAIN_LUTS];
+    uint32_t lut_clock;
 } effect_chain_t;
 
+// Command buffer: one packed little-endian buffer describing the whole chain
+// plus a frame request, filled by JS through typed-array views and submitted
+// with a single call. Layout in 32-bit words:
+//   header   [0] magic  [1] version  [2] flags  [3] record count
+//            [4-5] timestamp (f64)  [6] budget ms (f32)  [7] reserved
+//   results  [8] status: quality used, -1 failed, -2 not processed (i32)
+//            [9] chain count  [10] effects changed  [11] process ms (f32)
+//            [12] frames processed
+//   input    [13] keyframe record count (0 when nothing is animated)
+//            [14-15] source id (u64, 0 = unknown)
+//   records  from word 16, EFFECTS_COMMAND_RECORD_WORDS each:
+//            [0] effect_type_t  [1] subtype  [2-9] parameters (f32)
+//   keyframes from EFFECTS_COMMAND_KEYFRAME_OFFSET, EFFECTS_COMMAND_KEYFRAME_WORDS each:
+//            [0] record index  [1] effect_param_t  [2] keyframe_interp_t
+//            [3] time (f32)  [4] value (f32)  [5-8] Bezier x1, y1, x2, y2 (f32)
+// Record parameters by type (subtype in brackets):
+//   color correction: brightness, contrast, saturation, hue, gamma, exposure
+//   blur:             radius, gaussian (0/1), iterations
+//   transform [interpolation]: scale, rotation, flip h, flip v, crop x, y, w, h
+//   filter [filter_type_t]:    intensity, param1, param2, param3
+#define EFFECTS_COMMAND_MAGIC 0x42434556u // "VECB"
+#define EFFECTS_COMMAND_VERSION 2
+#define EFFECTS_COMMAND_HEADER_WORDS 16
+#define EFFECTS_COMMAND_RECORD_WORDS 10
+#define EFFECTS_COMMAND_KEYFRAME_OFFSET (EFFECTS_COMMAND_HEADER_WORDS + MAX_EFFECTS_CHAIN * EFFECTS_COMMAND_RECORD_WORDS)
+#define EFFECTS_COMMAND_KEYFRAME_WORDS 9
+#define EFFECTS_COMMAND_MAX_KEYFRAMES 128
+#define EFFECTS_COMMAND_WORDS (EFFECTS_COMMAND_KEYFRAME_OFFSET + EFFECTS_COMMAND_MAX_KEYFRAMES * EFFECTS_COMMAND_KEYFRAME_WORDS)
+
+#define EFFECTS_COMMAND_PROCESS 0x1u // Render the session input slot after applying
+
+typedef enum {
+    EFFECTS_COMMAND_MAGIC_WORD = 0,
+    EFFECTS_COMMAND_VERSION_WORD = 1,
+    EFFECTS_COMMAND_FLAGS_WORD = 2,
+    EFFECTS_COMMAND_COUNT_WORD = 3,
+    EFFECTS_COMMAND_TIMESTAMP_WORD = 4,
+    EFFECTS_COMMAND_BUDGET_WORD = 6,
+    EFFECTS_COMMAND_STATUS_WORD = 8,
+    EFFECTS_COMMAND_CHAIN_COUNT_WORD = 9,
+    EFFECTS_COMMAND_CHANGED_WORD = 10,
+    EFFECTS_COMMAND_PROCESS_MS_WORD = 11,
+    EFFECTS_COMMAND_FRAMES_WORD = 12,
+    EFFECTS_COMMAND_KEYFRAME_COUNT_WORD = 13,
+    EFFECTS_COMMAND_SOURCE_WORD = 14
+} effects_command_word_t;
+
+// Pipeline stages timed besides the effect kernels themselves
+typedef enum {
+    PROFILE_STAGE_FRAME = 0,   // Whole effects_process_frame call
+    PROFILE_STAGE_COPY,        // Copies between effect intermediates
+    PROFILE_STAGE_DOWNSCALE,   // Proxy downscale
+    PROFILE_STAGE_UPSCALE,     // Proxy upscale
+    PROFILE_STAGE_COUNT
+} profile_stage_t;
+
+// Summary of one rolling histogram (times in milliseconds)
+typedef struct profile_stat_t {
+    uint32_t count;
+    float mean_ms;
+    float p50_ms;
+    float p95_ms;
+    float p99_ms;
+    float max_ms;
+} profile_stat_t;
+
+// Compact profile snapshot, laid out for reading from the JS heap
+typedef struct effects_profile_t {
+    uint32_t effect_count;                      // EFFECT_COST_COUNT
+    uint32_t stage_count;                       // PROFILE_STAGE_COUNT
+    profile_stat_t effects[EFFECT_COST_COUNT];  // Indexed by effect_cost_kind_t
+    profile_stat_t stages[PROFILE_STAGE_COUNT]; // Indexed by profile_stage_t
+} effects_profile_t;
+
 // Effects engine structure
+// Each instance is self-contained (chain, caches, metrics); separate
+// instances may be driven concurrently from different threads/workers.
+// One thread renders at a time: a render claims the engine, and ring work
+// that finds it claimed is deferred until the claim is released. Chain
+// edits from another thread take the chain lock, which renders hold for a
+// frame at a time.
+#define EFFECTS_DEFERRED_RINGS 4
+
 typedef struct effects_engine_t {
     effect_chain_t* chain;
-    memory_pool_t* memory_pool;
     bool initialized;
 
-    // Performance metrics
+    // Performance metrics (monotonic wall-clock time)
     double last_process_time_ms;
+    uint64_t total_process_ns;
     int frames_processed;
+    int frames_cancelled;
+    latency_histogram_t effect_latency[EFFECT_COST_COUNT];
+    latency_histogram_t stage_latency[PROFILE_STAGE_COUNT];
+    effects_profile_t profile;     // Last snapshot handed to JS
 
     // Export state
     bool export_mode;
     video_encoder_t* encoder;
+
+    // Scheduling: kernels yield to queued jobs more urgent than `priority`
+    render_scheduler_t* scheduler; // Not owned, may be shared between engines
+    render_priority_t priority;
+    _Atomic bool processing;       // Claimed by the render in flight
+    // Rings whose processing found the engine claimed, requeued when the
+    // claim is released; priority and job kind ride in the pointer's low bits
+    _Atomic uintptr_t deferred[EFFECTS_DEFERRED_RINGS];
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_t chain_lock;    // Held while a frame reads the chain
+#endif
+
+    // Cancellation: bumping the token abandons the frame in flight at the
+    // next row band; frames started afterwards are unaffected
+    render_cancel_token_t cancel;
+    bool last_frame_cancelled;
+    bool drop_stale_frames;        // Ring processing skips all but the newest frame
+
+    // Deadline-aware preview quality
+    effect_cost_model_t costs;
+    render_quality_t last_quality;
+    video_frame_t proxy_frame;     // Reduced resolution working frame
+    size_t proxy_capacity;
+
+    // Session I/O: persistent frames at the session resolution that JS
+    // writes and reads in place. Pointers stay valid until the next
+    // effects_engine_set_session_size. With a render scale the input is
+    // downscaled on ingest and the chain runs on the smaller output.
+    video_frame_t input_slot;
+    video_frame_t output_slot;
+    size_t session_capacity;       // Bytes per slot
+    int render_scale;              // Output at 1/render_scale of the input (1, 2 or 4)
+
+    // Input of the effect being edited on the last frame. Only used when the
+    // caller names the input: source_id identifies the pixels of the next frame
+    // processed (same id = same pixels) and is cleared once it is used.
+    stage_cache_t stage_cache;
+    uint64_t source_id;
+    result_cache_t result_cache;   // Finished frames of named sources
+    disk_cache_t* disk_cache;      // Full-quality frames on disk; not owned, may be shared
+
+    // Pre-render of frames ahead of the playhead into the result cache
+    _Atomic bool prerendering;     // Frames stored now count as prefetched
+    uint32_t prerender_revision;   // Chain revision the prefetched frames show
+
+    // Refinement of a reduced-quality session frame to full quality, one
+    // band of output rows at a time
+    bool refine_pending;
+    double refine_timestamp;
+    uint64_t refine_source_id;
+    uint32_t refine_revision;      // Chain revision the preview shows
+    int refine_next_row;           // First output row not yet refined
+    video_frame_t refine_band;     // Band plus halo rows, at the output scale
+    size_t refine_capacity;
+
+    // Command buffer JS fills in place; 8-byte aligned for the f64 timestamp
+    _Alignas(8) uint32_t commands[EFFECTS_COMMAND_WORDS];
+    effect_t command_effects[MAX_EFFECTS_CHAIN]; // Records decoded from it
 } effects_engine_t;
 
 // Core engine functions
@@ -82,14 +284,88 @@ EMSCRIPTEN_KEEPALIVE void effects_engine_cleanup(effects_engine_t* engine);
 // Effect chain management
 EMSCRIPTEN_KEEPALIVE effect_chain_t* effect_chain_create(void);
 EMSCRIPTEN_KEEPALIVE void effect_chain_destroy(effect_chain_t* chain);
+// The chain stays in processing order: add returns the effect's index in
+// it, and later effects shift up by one (or down by one on removal)
 EMSCRIPTEN_KEEPALIVE int effect_chain_add(effect_chain_t* chain, effect_t* effect);
 EMSCRIPTEN_KEEPALIVE bool effect_chain_remove(effect_chain_t* chain, int index);
 EMSCRIPTEN_KEEPALIVE void effect_chain_clear(effect_chain_t* chain);
 EMSCRIPTEN_KEEPALIVE void effect_chain_sort(effect_chain_t* chain);
+// Room for capacity effects without reallocating; false past EFFECT_CHAIN_MAX_EFFECTS
+EMSCRIPTEN_KEEPALIVE bool effect_chain_reserve(effect_chain_t* chain, int capacity);
+// Effects active at timestamp, found through the chain's interval index and
+// reused for every timestamp in the plan's window (sorts the chain first).
+// Valid until the next call; NULL on allocation failure.
+EMSCRIPTEN_KEEPALIVE const effect_chain_plan_t* effect_chain_plan(effect_chain_t* chain, double timestamp);
 
 // Effect processing
 EMSCRIPTEN_KEEPALIVE bool effects_process_frame(effects_engine_t* engine, video_frame_t* frame, double timestamp);
+EMSCRIPTEN_KEEPALIVE bool effects_process_frame_budget(effects_engine_t* engine, video_frame_t* frame, double timestamp,
+                                                       double budget_ms, render_quality_t* quality_used);
 EMSCRIPTEN_KEEPALIVE bool effects_process_frame_chain(effect_chain_t* chain, video_frame_t* frame, double timestamp);
+EMSCRIPTEN_KEEPALIVE int effects_engine_process_ring(effects_engine_t* engine, frame_ring_t* ring, int max_frames);
+
+// Session I/O
+EMSCRIPTEN_KEEPALIVE bool effects_engine_set_session_size(effects_engine_t* engine, int width, int height);
+EMSCRIPTEN_KEEPALIVE bool effects_engine_set_render_scale(effects_engine_t* engine, int scale);
+EMSCRIPTEN_KEEPALIVE bool effects_engine_process_session(effects_engine_t* engine, double timestamp, double budget_ms,
+                                                         render_quality_t* quality_used);
+// Progressive refinement. A session frame rendered below full quality (the
+// deadline forced a proxy, as when playback pauses on a heavy chain) is
+// re-rendered at full quality in the background, up to max_bands row bands
+// per call (<= 0 = all), each written over the preview in the output slot.
+// Frames up to 1080p refine in one band. Returns the bands still to render:
+// 0 once the output slot holds the full-quality frame or nothing is pending
+// (a chain edit since the preview drops the refinement), -1 on failure.
+#define EFFECTS_REFINE_BAND_PIXELS (1920 * 1080)
+EMSCRIPTEN_KEEPALIVE int effects_engine_refine_session(effects_engine_t* engine, int max_bands);
+EMSCRIPTEN_KEEPALIVE bool effects_engine_submit_refine(effects_engine_t* engine);
+
+// Stage cache
+EMSCRIPTEN_KEEPALIVE void effects_engine_set_source_id(effects_engine_t* engine, uint64_t source_id);
+EMSCRIPTEN_KEEPALIVE void effects_engine_set_stage_cache_budget(effects_engine_t* engine, size_t bytes);
+EMSCRIPTEN_KEEPALIVE void effects_engine_set_result_cache(effects_engine_t* engine, size_t bytes, bool compress);
+EMSCRIPTEN_KEEPALIVE void effects_engine_clear_caches(effects_engine_t* engine);
+// Native render hosts: read full-quality frames of named sources from, and
+// spill them to, a disk cache (NULL to detach)
+EMSCRIPTEN_KEEPALIVE void effects_engine_set_disk_cache(effects_engine_t* engine, disk_cache_t* cache);
+
+// Command buffer
+EMSCRIPTEN_KEEPALIVE int effects_engine_apply_commands(effects_engine_t* engine, uint32_t* commands, size_t size);
+EMSCRIPTEN_KEEPALIVE int effects_engine_submit_commands(effects_engine_t* engine, uint32_t* commands, size_t size);
+
+// Scheduling
+EMSCRIPTEN_KEEPALIVE void effects_engine_set_scheduler(effects_engine_t* engine, render_scheduler_t* scheduler, render_priority_t priority);
+EMSCRIPTEN_KEEPALIVE bool effects_engine_submit_ring(effects_engine_t* engine, frame_ring_t* ring, render_priority_t priority);
+
+// Pre-render. JS publishes upcoming source frames to a ring in play
+// direction (forward or backward) when idle; they are rendered at prefetch
+// priority into the result cache, where playback finds them.
+#define EFFECTS_PRERENDER_EDITED -1    // The chain changed; remaining frames stay queued
+#define EFFECTS_PRERENDER_FULL -2      // Prefetched frames fill their share of the cache
+#define EFFECTS_PRERENDER_PREEMPTED -3 // Yielded to more urgent ring work; resumes after it
+EMSCRIPTEN_KEEPALIVE int effects_engine_prerender_ring(effects_engine_t* engine, frame_ring_t* ring, int max_frames);
+EMSCRIPTEN_KEEPALIVE bool effects_engine_submit_prerender(effects_engine_t* engine, frame_ring_t* ring);
+
+// Chain edits, and chain reads outside the engine's own renders, from any
+// thread. Locking cancels a pre-render in flight rather than waiting out
+// its frame.
+EMSCRIPTEN_KEEPALIVE void effects_engine_lock_chain(effects_engine_t* engine);
+EMSCRIPTEN_KEEPALIVE void effects_engine_unlock_chain(effects_engine_t* engine);
+
+// Cancellation
+EMSCRIPTEN_KEEPALIVE void effects_engine_cancel(effects_engine_t* engine);
+EMSCRIPTEN_KEEPALIVE void effects_engine_set_drop_stale_frames(effects_engine_t* engine, bool drop);
+
+// Keyframe animation. Times are timeline seconds, like start/end times.
+EMSCRIPTEN_KEEPALIVE bool effect_set_keyframe(effect_t* effect, effect_param_t param, float time, float value,
+                                              keyframe_interp_t interpolation, const float* ease);
+// Drop one parameter's keyframes, or all with EFFECT_PARAM_COUNT
+EMSCRIPTEN_KEEPALIVE void effect_clear_keyframes(effect_t* effect, effect_param_t param);
+// The effect as it renders at timestamp: itself when nothing is animated,
+// else a copy in scratch with keyframed values filled in and no tracks.
+// hints (EFFECT_MAX_TRACKS entries, may be NULL) speeds up playback.
+EMSCRIPTEN_KEEPALIVE const effect_t* effect_evaluate(const effect_t* effect, double timestamp, uint8_t* hints,
+                                                     effect_t* scratch);
 
 // Individual effect builders
 EMSCRIPTEN_KEEPALIVE effect_t* effect_create_color_correction(float brightness, float contrast, float saturation, float hue);
@@ -103,18 +379,52 @@ EMSCRIPTEN_KEEPALIVE bool effects_engine_export_frame(effects_engine_t* engine,
 EMSCRIPTEN_KEEPALIVE bool effects_engine_finish_export(effects_engine_t* engine);
 
 // JavaScript bindings
-EMSCRIPTEN_KEEPALIVE int js_effects_engine_create(void);
-EMSCRIPTEN_KEEPALIVE void js_effects_engine_destroy(int engine_ptr);
-EMSCRIPTEN_KEEPALIVE int js_effect_chain_add_color_correction(int engine_ptr, float brightness, float contrast, float saturation, float hue);
-EMSCRIPTEN_KEEPALIVE int js_effect_chain_add_blur(int engine_ptr, float radius, int gaussian);
-EMSCRIPTEN_KEEPALIVE int js_effect_chain_add_transform(int engine_ptr, float scale, float rotation, int flip_h, int flip_v);
-EMSCRIPTEN_KEEPALIVE int js_effects_process_frame(int engine_ptr, uint8_t* frame_data, int width, int height, int format, double timestamp);
-EMSCRIPTEN_KEEPALIVE int js_effects_start_export(int engine_ptr, const char* output_path, int width, int height, double fps);
-EMSCRIPTEN_KEEPALIVE int js_effects_export_frame(int engine_ptr, uint8_t* frame_data, int width, int height, double timestamp);
-EMSCRIPTEN_KEEPALIVE int js_effects_finish_export(int engine_ptr);
+EMSCRIPTEN_KEEPALIVE engine_handle_t js_effects_engine_create(void);
+EMSCRIPTEN_KEEPALIVE void js_effects_engine_destroy(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_effect_chain_add_color_correction(engine_handle_t engine_handle, float brightness, float contrast, float saturation, float hue);
+EMSCRIPTEN_KEEPALIVE int js_effect_chain_add_blur(engine_handle_t engine_handle, float radius, int gaussian);
+EMSCRIPTEN_KEEPALIVE int js_effect_set_keyframe(engine_handle_t engine_handle, int index, int param, float time, float value,
+                                                int interpolation, float x1, float y1, float x2, float y2);
+EMSCRIPTEN_KEEPALIVE int js_effect_clear_keyframes(engine_handle_t engine_handle, int index, int param);
+EMSCRIPTEN_KEEPALIVE int js_effect_set_time_range(engine_handle_t engine_handle, int index, double start_time, double end_time);
+EMSCRIPTEN_KEEPALIVE int js_effect_chain_add_transform(engine_handle_t engine_handle, float scale, float rotation, int flip_h, int flip_v);
+EMSCRIPTEN_KEEPALIVE int js_effects_process_frame(engine_handle_t engine_handle, uint8_t* frame_data, int width, int height, int format, double timestamp);
+EMSCRIPTEN_KEEPALIVE int js_effects_process_frame_budget(engine_handle_t engine_handle, uint8_t* frame_data, int width, int height, int format,
+                                                         double timestamp, double budget_ms);
+EMSCRIPTEN_KEEPALIVE int js_effects_get_last_quality(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_engine_set_session_size(engine_handle_t engine_handle, int width, int height);
+EMSCRIPTEN_KEEPALIVE uint8_t* js_engine_get_input_slot(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE uint8_t* js_engine_get_output_slot(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_engine_set_render_scale(engine_handle_t engine_handle, int scale);
+EMSCRIPTEN_KEEPALIVE int js_engine_get_output_width(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_engine_get_output_height(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_engine_process_session(engine_handle_t engine_handle, double timestamp, double budget_ms);
+EMSCRIPTEN_KEEPALIVE int js_engine_refine_session(engine_handle_t engine_handle, int max_bands);
+EMSCRIPTEN_KEEPALIVE int js_engine_submit_refine(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE void js_engine_set_source_id(engine_handle_t engine_handle, double source_id);
+EMSCRIPTEN_KEEPALIVE void js_engine_set_stage_cache_budget(engine_handle_t engine_handle, int megabytes);
+EMSCRIPTEN_KEEPALIVE void js_engine_set_result_cache(engine_handle_t engine_handle, int megabytes, int compress);
+EMSCRIPTEN_KEEPALIVE void js_engine_clear_caches(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE uint32_t* js_engine_get_command_buffer(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_engine_submit_commands(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_effects_process_ring(engine_handle_t engine_handle, engine_handle_t ring_handle, int max_frames);
+EMSCRIPTEN_KEEPALIVE void js_effects_engine_set_scheduler(engine_handle_t engine_handle, engine_handle_t scheduler_handle, int priority);
+EMSCRIPTEN_KEEPALIVE int js_effects_submit_ring(engine_handle_t engine_handle, engine_handle_t ring_handle, int priority);
+EMSCRIPTEN_KEEPALIVE int js_engine_prerender_ring(engine_handle_t engine_handle, engine_handle_t ring_handle, int max_frames);
+EMSCRIPTEN_KEEPALIVE int js_engine_submit_prerender(engine_handle_t engine_handle, engine_handle_t ring_handle);
+EMSCRIPTEN_KEEPALIVE void js_effects_cancel(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE void js_effects_set_drop_stale_frames(engine_handle_t engine_handle, int drop);
+EMSCRIPTEN_KEEPALIVE int js_effects_get_frames_cancelled(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_effects_start_export(engine_handle_t engine_handle, const char* output_path, int width, int height, double fps);
+EMSCRIPTEN_KEEPALIVE int js_effects_export_frame(engine_handle_t engine_handle, uint8_t* frame_data, int width, int height, double timestamp);
+EMSCRIPTEN_KEEPALIVE int js_effects_finish_export(engine_handle_t engine_handle);
 
 // Performance and debugging
 EMSCRIPTEN_KEEPALIVE double effects_engine_get_last_process_time(effects_engine_t* engine);
 EMSCRIPTEN_KEEPALIVE void effects_engine_get_stats(effects_engine_t* engine, int* frames_processed, double* avg_time);
+EMSCRIPTEN_KEEPALIVE void effects_engine_get_profile(effects_engine_t* engine, effects_profile_t* profile);
+EMSCRIPTEN_KEEPALIVE void effects_engine_reset_profile(effects_engine_t* engine);
+EMSCRIPTEN_KEEPALIVE const effects_profile_t* js_effects_get_profile(engine_handle_t engine_handle);
+EMSCRIPTEN_KEEPALIVE void js_effects_reset_profile(engine_handle_t engine_handle);
 
 #endif // EFFECTS_ENGINE_H
\ No newline at end of file
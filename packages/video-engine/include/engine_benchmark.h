@@ -0,0 +1,39 @@
+#ifndef ENGINE_BENCHMARK_H
+#define ENGINE_BENCHMARK_H
+
+#include "video_engine.h"
+#include <stdbool.h>
+
+// Benchmark cases shared by the native build and test-wasm.js. Names and
+// parameters match the JS runner case for case, so native and WASM
+// results can be joined on (case, width, height).
+typedef struct engine_benchmark_result_t {
+    const char* name;
+    int width;
+    int height;
+    int iterations;
+    double min_ms;
+    double median_ms;
+    double mean_ms;
+    double fps;             // From the median
+    double mpix_per_s;
+} engine_benchmark_result_t;
+
+EMSCRIPTEN_KEEPALIVE int engine_benchmark_case_count(void);
+EMSCRIPTEN_KEEPALIVE const char* engine_benchmark_case_name(int index);
+
+// Time one case in-process: kernel time only, the input is restored
+// between iterations outside the timed region
+EMSCRIPTEN_KEEPALIVE bool engine_benchmark_run(int index, int width, int height, int iterations,
+                                               engine_benchmark_result_t* result);
+
+// Run every case; returns malloc'd JSON lines (one object per case)
+EMSCRIPTEN_KEEPALIVE char* engine_benchmark_report(const char* runtime, int width, int height, int iterations);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE int js_engine_benchmark_case_count(void);
+EMSCRIPTEN_KEEPALIVE const char* js_engine_benchmark_case_name(int index);
+// Returns a pointer to {min_ms, median_ms, mean_ms, iterations} doubles, NULL on failure
+EMSCRIPTEN_KEEPALIVE const double* js_engine_benchmark_run(int index, int width, int height, int iterations);
+
+#endif // ENGINE_BENCHMARK_H
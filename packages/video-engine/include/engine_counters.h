@@ -0,0 +1,90 @@
+#ifndef ENGINE_COUNTERS_H
+#define ENGINE_COUNTERS_H
+
+#include "video_engine.h"
+#include "adaptive_quality.h"
+#include <stddef.h>
+
+// Build with -DENGINE_COUNTERS=0 to compile all counting out
+#ifndef ENGINE_COUNTERS
+#define ENGINE_COUNTERS 1
+#endif
+
+// Engine-wide event and traffic counters, monotonic since start or reset
+typedef enum {
+    ENGINE_COUNTER_FRAMES = 0,         // Frames completed by effects engines
+    ENGINE_COUNTER_CHAIN_COPY_BYTES,   // memcpy between an effect chain's frames
+    ENGINE_COUNTER_SCRATCH_COPY_BYTES, // Kernels copying their input to scratch
+    ENGINE_COUNTER_HEAP_ALLOCS,        // malloc/realloc on the frame path
+    ENGINE_COUNTER_HEAP_ALLOC_BYTES,
+    ENGINE_COUNTER_POOL_ALLOCS,        // Successful memory_pool_alloc calls
+    ENGINE_COUNTER_POOL_EXHAUSTED,     // memory_pool_alloc with no free block
+    ENGINE_COUNTER_FRAME_CACHE_HITS,   // Chain stages reused from the stage cache
+    ENGINE_COUNTER_FRAME_CACHE_MISSES, // Stages rendered while the cache was in use
+    ENGINE_COUNTER_LUT_REBUILDS,       // Color correction tone LUTs rebuilt
+    ENGINE_COUNTER_RESULT_CACHE_HITS,   // Frames served from the result cache
+    ENGINE_COUNTER_RESULT_CACHE_MISSES, // Named-source frames rendered
+    ENGINE_COUNTER_DISK_CACHE_HITS,     // Frames read back from the disk cache
+    ENGINE_COUNTER_DISK_CACHE_WRITES,   // Frames written by the disk cache writer
+    ENGINE_COUNTER_DISK_CACHE_DROPPED,  // Writes dropped (queue full or I/O error)
+    ENGINE_COUNTER_PLAN_BUILDS,         // Active effect sets looked up in a chain's interval index
+    ENGINE_COUNTER_COUNT
+} engine_counter_t;
+
+// Counter values. Pixel traffic is nominal: every pass of a kernel reads and
+// writes the whole frame once.
+typedef struct engine_counters_t {
+    uint64_t values[ENGINE_COUNTER_COUNT];
+    uint64_t kernel_bytes_read[EFFECT_COST_COUNT];
+    uint64_t kernel_bytes_written[EFFECT_COST_COUNT];
+} engine_counters_t;
+
+#define ENGINE_COUNTERS_TOTAL (ENGINE_COUNTER_COUNT + 2 * EFFECT_COST_COUNT)
+
+// Counts accumulate in a per-thread batch without atomics and are published
+// into the shared registry at frame and job boundaries, so a snapshot always
+// sees whole frames, never half of one.
+extern _Thread_local engine_counters_t engine_counters_pending;
+
+static inline void engine_counter_add(engine_counter_t counter, uint64_t amount) {
+#if ENGINE_COUNTERS
+    engine_counters_pending.values[counter] += amount;
+#else
+    (void)counter;
+    (void)amount;
+#endif
+}
+
+static inline void engine_counter_alloc(size_t bytes) {
+    engine_counter_add(ENGINE_COUNTER_HEAP_ALLOCS, 1);
+    engine_counter_add(ENGINE_COUNTER_HEAP_ALLOC_BYTES, bytes);
+}
+
+static inline void engine_counter_kernel(effect_cost_kind_t kind, uint64_t bytes_read, uint64_t bytes_written) {
+#if ENGINE_COUNTERS
+    engine_counters_pending.kernel_bytes_read[kind] += bytes_read;
+    engine_counters_pending.kernel_bytes_written[kind] += bytes_written;
+#else
+    (void)kind;
+    (void)bytes_read;
+    (void)bytes_written;
+#endif
+}
+
+// Fold the calling thread's batch into the registry
+EMSCRIPTEN_KEEPALIVE void engine_counters_publish(void);
+
+// Consistent copy of the registry (publishes the caller's batch first)
+EMSCRIPTEN_KEEPALIVE void engine_counters_snapshot(engine_counters_t* out);
+EMSCRIPTEN_KEEPALIVE void engine_counters_reset(void);
+
+// Name of flat counter `index` (values, then per-kernel reads, then writes)
+EMSCRIPTEN_KEEPALIVE const char* engine_counter_name(int index);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE const double* js_engine_counters_snapshot(void);
+EMSCRIPTEN_KEEPALIVE int js_engine_counters_count(void);
+EMSCRIPTEN_KEEPALIVE const char* js_engine_counter_name(int index);
+EMSCRIPTEN_KEEPALIVE void js_engine_counters_reset(void);
+
+#endif // ENGINE_COUNTERS_H
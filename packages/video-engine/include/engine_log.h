@@ -0,0 +1,115 @@
+#ifndef ENGINE_LOG_H
+#define ENGINE_LOG_H
+
+#include "video_engine.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+// Log levels (plain defines so the preprocessor can compare them)
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+#define LOG_LEVEL_FRAME 4   // Per-frame processing detail
+
+// Statements above this level are compiled out entirely
+#ifndef ENGINE_LOG_COMPILE_LEVEL
+#define ENGINE_LOG_COMPILE_LEVEL LOG_LEVEL_FRAME
+#endif
+
+// Runtime default: per-frame and debug logs off
+#define ENGINE_LOG_DEFAULT_LEVEL LOG_LEVEL_INFO
+
+#define ENGINE_LOG_MAX_ARGS 8
+#define ENGINE_LOG_RING_SIZE 1024 // Records, power of two
+#define ENGINE_LOG_TEXT_SIZE 128  // Bytes per record for copied %s arguments
+
+// A captured argument. String arguments are copied into the record when it
+// is written (truncated to fit ENGINE_LOG_TEXT_SIZE), so any string may be
+// logged with %s, including stack buffers.
+typedef enum {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING
+} log_arg_type_t;
+
+typedef struct log_arg_t {
+    log_arg_type_t type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const char* s;
+    } value;
+} log_arg_t;
+
+// Logging is process-wide. Records are written as binary (format pointer +
+// typed arguments) into a lock-free multi-producer ring and only formatted
+// when drained, so an enabled log statement never leaves WASM or blocks.
+// When producers lap the reader the oldest records are dropped and counted.
+extern _Atomic int engine_log_level;
+
+static inline bool engine_log_enabled(int level) {
+    return level <= atomic_load_explicit(&engine_log_level, memory_order_relaxed);
+}
+
+EMSCRIPTEN_KEEPALIVE void engine_log_set_level(int level);
+EMSCRIPTEN_KEEPALIVE void engine_log_set_echo_level(int level);
+EMSCRIPTEN_KEEPALIVE void engine_log_write(int level, const char* format, const log_arg_t* args, int arg_count);
+
+// Format and remove all pending records ("[time ms] LEVEL message" lines).
+// Returns a malloc'd string the caller frees. Single consumer.
+EMSCRIPTEN_KEEPALIVE char* engine_log_drain(size_t* length);
+
+static inline log_arg_t log_arg_int(int64_t v) { log_arg_t a = { .type = LOG_ARG_INT, .value.i = v }; return a; }
+static inline log_arg_t log_arg_uint(uint64_t v) { log_arg_t a = { .type = LOG_ARG_UINT, .value.u = v }; return a; }
+static inline log_arg_t log_arg_double(double v) { log_arg_t a = { .type = LOG_ARG_DOUBLE, .value.d = v }; return a; }
+static inline log_arg_t log_arg_string(const char* v) { log_arg_t a = { .type = LOG_ARG_STRING, .value.s = v }; return a; }
+
+#define LOG_ARG(x) _Generic((x),                                        \
+    float: log_arg_double, double: log_arg_double,                      \
+    char*: log_arg_string, const char*: log_arg_string,                 \
+    unsigned char: log_arg_uint, unsigned short: log_arg_uint,          \
+    unsigned int: log_arg_uint, unsigned long: log_arg_uint,            \
+    unsigned long long: log_arg_uint,                                   \
+    default: log_arg_int)(x)
+
+// Argument list -> "LOG_ARG(a), LOG_ARG(b), ..." (up to ENGINE_LOG_MAX_ARGS)
+#define LOG_NARGS(...) LOG_NARGS_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+#define LOG_CAT(a, b) LOG_CAT_(a, b)
+#define LOG_CAT_(a, b) a##b
+#define LOG_MAP(...) LOG_CAT(LOG_MAP_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_MAP_0()
+#define LOG_MAP_1(a) LOG_ARG(a),
+#define LOG_MAP_2(a, ...) LOG_ARG(a), LOG_MAP_1(__VA_ARGS__)
+#define LOG_MAP_3(a, ...) LOG_ARG(a), LOG_MAP_2(__VA_ARGS__)
+#define LOG_MAP_4(a, ...) LOG_ARG(a), LOG_MAP_3(__VA_ARGS__)
+#define LOG_MAP_5(a, ...) LOG_ARG(a), LOG_MAP_4(__VA_ARGS__)
+#define LOG_MAP_6(a, ...) LOG_ARG(a), LOG_MAP_5(__VA_ARGS__)
+#define LOG_MAP_7(a, ...) LOG_ARG(a), LOG_MAP_6(__VA_ARGS__)
+#define LOG_MAP_8(a, ...) LOG_ARG(a), LOG_MAP_7(__VA_ARGS__)
+
+// printf-style log statement; arguments are not evaluated when disabled
+#define ENGINE_LOG(level, format, ...)                                          \
+    do {                                                                        \
+        if ((level) <= ENGINE_LOG_COMPILE_LEVEL && engine_log_enabled(level)) { \
+            const log_arg_t log_args_[] = { LOG_MAP(__VA_ARGS__) log_arg_int(0) }; \
+            engine_log_write((level), (format), log_args_,                      \
+                             LOG_NARGS(__VA_ARGS__));                           \
+        }                                                                       \
+    } while (0)
+
+#define LOG_ERROR(...) ENGINE_LOG(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) ENGINE_LOG(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) ENGINE_LOG(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) ENGINE_LOG(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_FRAME(...) ENGINE_LOG(LOG_LEVEL_FRAME, __VA_ARGS__)
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE void js_engine_log_set_level(int level);
+EMSCRIPTEN_KEEPALIVE void js_engine_log_set_echo_level(int level);
+EMSCRIPTEN_KEEPALIVE char* js_engine_log_drain(void);
+
+#endif // ENGINE_LOG_H
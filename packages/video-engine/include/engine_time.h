@@ -0,0 +1,15 @@
+#ifndef ENGINE_TIME_H
+#define ENGINE_TIME_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Monotonic wall-clock time in nanoseconds. clock() measures CPU time of the
+// whole process, which is meaningless for worker threads and frame deadlines.
+static inline uint64_t engine_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif // ENGINE_TIME_H
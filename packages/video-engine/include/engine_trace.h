@@ -0,0 +1,58 @@
+#ifndef ENGINE_TRACE_H
+#define ENGINE_TRACE_H
+
+#include "video_engine.h"
+#include "engine_time.h"
+#include <stddef.h>
+
+// Build with -DENGINE_TRACE=0 to compile all instrumentation out. When
+// compiled in, tracing is still off until engine_trace_enable(true) and a
+// disabled scope costs one relaxed atomic load.
+#ifndef ENGINE_TRACE
+#define ENGINE_TRACE 1
+#endif
+
+#define TRACE_MAX_THREADS 32 // Live tracing threads; rings of exited threads are reused
+#define TRACE_BUFFER_EVENTS 4096 // Per thread, power of two
+#define TRACE_NO_FRAME (-1)
+
+// One complete ("X") trace event. category and name must be string
+// literals: only the pointers are stored.
+typedef struct trace_event_t {
+    const char* category;
+    const char* name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    int frame_number;
+} trace_event_t;
+
+// Tracing is process-wide, like the timeline it produces. Every thread
+// records into its own ring (single writer, no locks); the oldest events are
+// overwritten when a ring wraps.
+EMSCRIPTEN_KEEPALIVE void engine_trace_enable(bool enabled);
+EMSCRIPTEN_KEEPALIVE bool engine_trace_enabled(void);
+EMSCRIPTEN_KEEPALIVE void engine_trace_clear(void);
+EMSCRIPTEN_KEEPALIVE void engine_trace_set_thread_name(const char* name);
+
+// Scope timing: start = engine_trace_begin(); ...; engine_trace_end(...)
+EMSCRIPTEN_KEEPALIVE uint64_t engine_trace_begin(void);
+EMSCRIPTEN_KEEPALIVE void engine_trace_end(const char* category, const char* name, uint64_t start_ns, int frame_number);
+
+// Chrome trace-event JSON (loads in Perfetto and chrome://tracing).
+// Returns a malloc'd NUL-terminated string the caller frees.
+EMSCRIPTEN_KEEPALIVE char* engine_trace_dump_json(size_t* length);
+
+#if ENGINE_TRACE
+#define TRACE_BEGIN(var) uint64_t var = engine_trace_begin()
+#define TRACE_END(var, category, name, frame) engine_trace_end((category), (name), (var), (frame))
+#else
+#define TRACE_BEGIN(var) ((void)0)
+#define TRACE_END(var, category, name, frame) ((void)0)
+#endif
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE void js_engine_trace_enable(int enabled);
+EMSCRIPTEN_KEEPALIVE void js_engine_trace_clear(void);
+EMSCRIPTEN_KEEPALIVE char* js_engine_trace_dump(void);
+
+#endif // ENGINE_TRACE_H
@@ -35,6 +35,16 @@ typedef struct {
     float exposure;    // -5.0 to 5.0
 } color_correction_t;
 
+// Per-channel tone curve of a color correction (brightness, contrast,
+// gamma, exposure) for every 8-bit input level, so the pixel loop does table
+// lookups instead of powf. Saturation and hue mix channels and still run
+// per pixel.
+typedef struct {
+    float key[4];      // brightness, contrast, gamma, exposure it was built for
+    bool valid;
+    uint8_t tone[256];
+} color_lut_t;
+
 // Blur parameters
 typedef struct {
     float radius;      // 0.0 to 100.0
@@ -42,6 +52,12 @@ typedef struct {
     bool gaussian;     // true for Gaussian, false for box blur
 } blur_params_t;
 
+// Transform resampling
+typedef enum {
+    TRANSFORM_INTERP_BILINEAR = 0,
+    TRANSFORM_INTERP_NEAREST = 1   // Cheaper, used by reduced preview quality
+} transform_interp_t;
+
 // Transform parameters
 typedef struct {
     float scale;           // Scale factor (100 = 100%, 200 = 200%, etc.)
@@ -52,11 +68,17 @@ typedef struct {
     int crop_y;           // Crop Y position (percentage) 
     int crop_width;       // Crop width (percentage)
     int crop_height;      // Crop height (percentage)
+    int interpolation;    // transform_interp_t
 } transform_params_t;
 
 // Filter functions
 EMSCRIPTEN_KEEPALIVE void filter_apply(video_frame_t* frame, filter_params_t* params);
 EMSCRIPTEN_KEEPALIVE void filter_color_correction(video_frame_t* frame, color_correction_t* params);
+// Build lut for params unless it already matches them; true if it was rebuilt
+EMSCRIPTEN_KEEPALIVE bool color_lut_prepare(color_lut_t* lut, const color_correction_t* params);
+// filter_color_correction with a LUT prepared for params
+EMSCRIPTEN_KEEPALIVE void filter_color_correction_lut(video_frame_t* frame, const color_correction_t* params,
+                                                      const color_lut_t* lut);
 EMSCRIPTEN_KEEPALIVE void filter_blur(video_frame_t* frame, blur_params_t* params);
 EMSCRIPTEN_KEEPALIVE void filter_sharpen(video_frame_t* frame, float intensity);
 EMSCRIPTEN_KEEPALIVE void filter_edge_detection(video_frame_t* frame, float threshold);
@@ -0,0 +1,79 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include "video_engine.h"
+#include "handle_table.h"
+#include <stdatomic.h>
+
+// Maximum number of frame slots in a ring
+#define FRAME_RING_MAX_SLOTS 16
+
+// Slot status set by the engine
+#define FRAME_RING_STATUS_FAILED 0
+#define FRAME_RING_STATUS_DONE 1
+#define FRAME_RING_STATUS_CANCELLED 2 // Abandoned; pixels are unspecified
+
+// Slot metadata, written by the stage that owns the slot before it hands
+// the slot on to the next stage
+typedef struct frame_ring_slot_t {
+    uint8_t* data;      // slot_size bytes of RGBA pixels
+    int width;
+    int height;
+    double timestamp;
+    int frame_number;
+    uint64_t source_id; // Names the pixels for the engine's caches (0 = unknown)
+    int status;         // FRAME_RING_STATUS_*, set by the engine
+} frame_ring_slot_t;
+
+// Fixed-capacity lock-free frame ring living in (shared) WASM memory.
+//
+// The same slots pass through two single-producer/single-consumer hand-offs,
+// so a frame is never copied between an input and an output ring:
+//
+//   producer (JS)  --write_index-->  engine (worker)  --process_index-->  reader (JS)
+//        ^                                                                  |
+//        +-------------------------- read_index ----------------------------+
+//
+// Each index has exactly one writer. Indices increase monotonically and are
+// masked into the slot array, so read <= process <= write <= read + capacity.
+typedef struct frame_ring_t {
+    _Alignas(64) _Atomic uint32_t write_index;   // Owned by the producer
+    _Alignas(64) _Atomic uint32_t process_index; // Owned by the engine
+    _Alignas(64) _Atomic uint32_t read_index;    // Owned by the reader
+
+    _Alignas(64) uint32_t capacity;              // Power of two
+    uint32_t mask;
+    size_t slot_size;
+    uint8_t* buffer;
+    frame_ring_slot_t slots[FRAME_RING_MAX_SLOTS];
+} frame_ring_t;
+
+// Ring lifetime
+EMSCRIPTEN_KEEPALIVE frame_ring_t* frame_ring_create(int capacity, int width, int height);
+EMSCRIPTEN_KEEPALIVE void frame_ring_destroy(frame_ring_t* ring);
+
+// Producer side: claim the next free slot, fill slot->data, then publish
+EMSCRIPTEN_KEEPALIVE frame_ring_slot_t* frame_ring_begin_write(frame_ring_t* ring);
+EMSCRIPTEN_KEEPALIVE bool frame_ring_publish(frame_ring_t* ring, int width, int height, double timestamp,
+                                             uint64_t source_id);
+
+// Engine side: take the oldest published slot, process it in place, hand it on
+EMSCRIPTEN_KEEPALIVE frame_ring_slot_t* frame_ring_begin_process(frame_ring_t* ring);
+EMSCRIPTEN_KEEPALIVE void frame_ring_end_process(frame_ring_t* ring, int status);
+EMSCRIPTEN_KEEPALIVE int frame_ring_get_pending(frame_ring_t* ring);
+
+// Reader side: take the oldest processed slot, read it, then release it
+EMSCRIPTEN_KEEPALIVE frame_ring_slot_t* frame_ring_begin_read(frame_ring_t* ring);
+EMSCRIPTEN_KEEPALIVE void frame_ring_release(frame_ring_t* ring);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE engine_handle_t js_frame_ring_create(int capacity, int width, int height);
+EMSCRIPTEN_KEEPALIVE void js_frame_ring_destroy(engine_handle_t ring_handle);
+EMSCRIPTEN_KEEPALIVE uint8_t* js_frame_ring_acquire_write(engine_handle_t ring_handle);
+EMSCRIPTEN_KEEPALIVE int js_frame_ring_publish(engine_handle_t ring_handle, int width, int height, double timestamp,
+                                              double source_id);
+EMSCRIPTEN_KEEPALIVE uint8_t* js_frame_ring_acquire_read(engine_handle_t ring_handle);
+EMSCRIPTEN_KEEPALIVE int js_frame_ring_read_status(engine_handle_t ring_handle);
+EMSCRIPTEN_KEEPALIVE void js_frame_ring_release(engine_handle_t ring_handle);
+
+#endif // FRAME_RING_H
@@ -0,0 +1,48 @@
+#ifndef HANDLE_TABLE_H
+#define HANDLE_TABLE_H
+
+#include "video_engine.h"
+
+// Opaque 32-bit handles for objects handed to JavaScript. JS never sees a raw
+// pointer, so bindings stay correct when pointers outgrow 32 bits (Memory64,
+// native hosts), and a stale or mistyped handle is rejected instead of being
+// dereferenced.
+//
+// Layout: bits 0-15 slot index (0 reserved, so handle 0 is never valid),
+// bits 16-30 slot generation (bumped on release). Bit 31 stays clear so a
+// handle is a positive JS number.
+typedef uint32_t engine_handle_t;
+
+#define HANDLE_INVALID 0u
+#define HANDLE_INDEX_BITS 16
+#define HANDLE_GENERATION_BITS 15
+#define HANDLE_TABLE_CAPACITY ((1u << HANDLE_INDEX_BITS) - 1)
+
+// Type tag checked on every lookup
+typedef enum {
+    HANDLE_TYPE_NONE = 0,
+    HANDLE_TYPE_EFFECTS_ENGINE,
+    HANDLE_TYPE_DECODER,
+    HANDLE_TYPE_FRAME,
+    HANDLE_TYPE_MEMORY_POOL,
+    HANDLE_TYPE_EXPORTER,
+    HANDLE_TYPE_ENCODER,
+    HANDLE_TYPE_EXPORT_JOB,
+    HANDLE_TYPE_SCHEDULER,
+    HANDLE_TYPE_FRAME_RING,
+    HANDLE_TYPE_QUALITY_METRICS,
+    HANDLE_TYPE_COUNT
+} handle_type_t;
+
+// Register an object; HANDLE_INVALID for NULL or a full table. Slots retire
+// after 2^15 reuses, so the table serves ~2^31 registrations in total.
+EMSCRIPTEN_KEEPALIVE engine_handle_t handle_register(void* object, handle_type_t type);
+// O(1) and lock-free; NULL if the handle is stale, released or of another type
+EMSCRIPTEN_KEEPALIVE void* handle_get(engine_handle_t handle, handle_type_t type);
+// Invalidate the handle and return its object (NULL if it was not live), so
+// the caller destroys each object exactly once
+EMSCRIPTEN_KEEPALIVE void* handle_release(engine_handle_t handle, handle_type_t type);
+// Live handles, for leak checks
+EMSCRIPTEN_KEEPALIVE int handle_table_live_count(void);
+
+#endif // HANDLE_TABLE_H
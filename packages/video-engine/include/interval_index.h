@@ -0,0 +1,45 @@
+#ifndef INTERVAL_INDEX_H
+#define INTERVAL_INDEX_H
+
+#include "video_engine.h"
+
+// Closed time intervals [start, end] answering "which contain t": a
+// balanced tree laid out implicitly over the intervals sorted by start, each
+// node holding the latest end in its subtree, so a query skips every
+// subtree that ended before t or starts after it. Built once per change
+// to the interval set.
+typedef struct interval_index_t {
+    int count;
+    int capacity;
+    double* starts;       // Ascending; node of the implicit tree at each position
+    double* ends;         // End of the interval at each position
+    double* max_ends;     // Latest end in the subtree rooted at each position
+    double* sorted_ends;  // Every end, ascending
+    int* ids;             // Caller's id of the interval at each position
+    int* hits;            // Query results
+} interval_index_t;
+
+// Timestamps around a query that contain exactly the same intervals:
+// t' > after && t' >= from && t' <= to && t' < before
+typedef struct interval_window_t {
+    double after;         // Latest end before the query time
+    double from;          // Latest start among the hits
+    double to;            // Earliest end among the hits
+    double before;        // Earliest start after the query time
+} interval_window_t;
+
+// Index count intervals (copied); false on allocation failure
+EMSCRIPTEN_KEEPALIVE bool interval_index_build(interval_index_t* index, const double* starts, const double* ends,
+                                               const int* ids, int count);
+EMSCRIPTEN_KEEPALIVE void interval_index_free(interval_index_t* index);
+// Ids of the intervals containing t, in start order (the caller may reorder
+// them; valid until the next query or build), and the window of timestamps
+// that share them
+EMSCRIPTEN_KEEPALIVE int* interval_index_query(interval_index_t* index, double t, int* count,
+                                               interval_window_t* window);
+
+static inline bool interval_window_contains(const interval_window_t* window, double t) {
+    return t > window->after && t >= window->from && t <= window->to && t < window->before;
+}
+
+#endif // INTERVAL_INDEX_H
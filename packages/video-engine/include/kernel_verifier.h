@@ -0,0 +1,34 @@
+#ifndef KERNEL_VERIFIER_H
+#define KERNEL_VERIFIER_H
+
+#include "video_engine.h"
+#include <stddef.h>
+
+// Outcome of checking one production kernel against its frozen reference
+typedef struct kernel_verify_result_t {
+    const char* kernel;
+    int cases;
+    int max_abs_error;      // Largest per-byte difference seen
+    double mean_abs_error;  // Over every compared byte of every case
+    int max_tolerance;
+    double mean_tolerance;
+    bool overrun;           // Production wrote past its output
+    bool passed;
+} kernel_verify_result_t;
+
+// Differential verification: each kernel runs on `cases` random inputs
+// (sizes down to 1x1 and odd widths, random parameters and content) through
+// both the production and the reference implementation. Deterministic for
+// a given seed.
+EMSCRIPTEN_KEEPALIVE int kernel_verifier_count(void);
+EMSCRIPTEN_KEEPALIVE const char* kernel_verifier_name(int index);
+EMSCRIPTEN_KEEPALIVE bool kernel_verifier_run(int index, uint32_t seed, int cases, kernel_verify_result_t* result);
+
+// Run every kernel; returns a malloc'd text report the caller frees, or
+// NULL when cases <= 0
+EMSCRIPTEN_KEEPALIVE char* kernel_verifier_report(uint32_t seed, int cases, bool* passed);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE char* js_kernel_verify(int seed, int cases);
+
+#endif // KERNEL_VERIFIER_H
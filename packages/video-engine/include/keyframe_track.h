@@ -0,0 +1,39 @@
+#ifndef KEYFRAME_TRACK_H
+#define KEYFRAME_TRACK_H
+
+#include "video_engine.h"
+
+// Animation of one scalar effect parameter: keyframes in increasing time
+// order, each carrying the interpolation of the segment that starts at it.
+// The value holds before the first keyframe and after the last.
+#define KEYFRAME_TRACK_MAX_KEYS 8
+
+typedef enum {
+    KEYFRAME_INTERP_LINEAR = 0,
+    KEYFRAME_INTERP_BEZIER = 1,  // Cubic easing curve, as CSS cubic-bezier()
+    KEYFRAME_INTERP_HOLD = 2,    // Value jumps at the next keyframe
+    KEYFRAME_INTERP_COUNT
+} keyframe_interp_t;
+
+typedef struct keyframe_t {
+    float time;                  // Timeline seconds, like effect start/end times
+    float value;
+    float ease[4];               // Bezier x1, y1, x2, y2 over the unit square
+} keyframe_t;
+
+typedef struct keyframe_track_t {
+    uint8_t param;               // effect_param_t it drives
+    uint8_t count;
+    uint8_t interpolation[KEYFRAME_TRACK_MAX_KEYS];
+    keyframe_t keys[KEYFRAME_TRACK_MAX_KEYS];
+} keyframe_track_t;
+
+// Insert a keyframe, replacing one at the same time. ease may be NULL for
+// interpolations other than Bezier. False when the track is full.
+EMSCRIPTEN_KEEPALIVE bool keyframe_track_set(keyframe_track_t* track, float time, float value,
+                                             keyframe_interp_t interpolation, const float* ease);
+// Value at time. hint (may be NULL) holds the segment the last lookup found;
+// any value is safe, and playback moving forward skips the binary search.
+EMSCRIPTEN_KEEPALIVE float keyframe_track_evaluate(const keyframe_track_t* track, double time, uint8_t* hint);
+
+#endif // KEYFRAME_TRACK_H
@@ -0,0 +1,43 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "video_engine.h"
+
+// Log-linear (HDR-style) buckets: every power of two is split into
+// 2^LATENCY_SUB_BUCKET_BITS linear sub-buckets, so any recorded value is
+// known to within ~6% from 1 ns up to 2^LATENCY_MAX_BITS ns (~18 minutes).
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_BITS 40
+#define LATENCY_BUCKET_COUNT ((LATENCY_MAX_BITS - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+// Samples per rolling window
+#define LATENCY_DEFAULT_WINDOW 512
+
+typedef struct latency_window_t {
+    uint32_t counts[LATENCY_BUCKET_COUNT];
+    uint32_t total;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+} latency_window_t;
+
+// Rolling histogram. Samples go into the current window; once it is full
+// the older window is cleared and becomes current. Queries cover both, i.e.
+// the last window_size to 2 * window_size samples.
+typedef struct latency_histogram_t {
+    latency_window_t windows[2];
+    int current;
+    uint32_t window_size;
+} latency_histogram_t;
+
+EMSCRIPTEN_KEEPALIVE void latency_histogram_init(latency_histogram_t* histogram, uint32_t window_size);
+EMSCRIPTEN_KEEPALIVE void latency_histogram_reset(latency_histogram_t* histogram);
+EMSCRIPTEN_KEEPALIVE void latency_histogram_record(latency_histogram_t* histogram, uint64_t value_ns);
+
+// Queries over the rolling window (0 when empty)
+EMSCRIPTEN_KEEPALIVE uint32_t latency_histogram_count(const latency_histogram_t* histogram);
+EMSCRIPTEN_KEEPALIVE uint64_t latency_histogram_percentile(const latency_histogram_t* histogram, double percentile);
+EMSCRIPTEN_KEEPALIVE uint64_t latency_histogram_max(const latency_histogram_t* histogram);
+EMSCRIPTEN_KEEPALIVE double latency_histogram_mean(const latency_histogram_t* histogram);
+
+#endif // LATENCY_HISTOGRAM_H
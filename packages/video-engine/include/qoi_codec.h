@@ -0,0 +1,17 @@
+#ifndef QOI_CODEC_H
+#define QOI_CODEC_H
+
+#include "video_engine.h"
+#include <stddef.h>
+
+// Lossless RGBA compression with the QOI op set (https://qoiformat.org),
+// without the file header and end marker: callers keep the dimensions. One
+// pass each way, fast enough to run on every cached frame. Typical video
+// frames shrink 2-4x; noise barely at all.
+
+// Encode into out; returns the encoded size, 0 if it would exceed capacity
+size_t qoi_encode(const uint8_t* rgba, size_t pixel_count, uint8_t* out, size_t capacity);
+// Decode exactly pixel_count pixels; false on truncated or overlong input
+bool qoi_decode(const uint8_t* data, size_t size, uint8_t* rgba, size_t pixel_count);
+
+#endif // QOI_CODEC_H
@@ -0,0 +1,72 @@
+#ifndef QUALITY_METRICS_H
+#define QUALITY_METRICS_H
+
+#include "video_engine.h"
+#include "handle_table.h"
+
+// Metrics to compute in a comparison (bit mask)
+#define QUALITY_METRIC_PSNR 1
+#define QUALITY_METRIC_SSIM 2
+#define QUALITY_METRIC_MS_SSIM 4
+#define QUALITY_METRIC_ALL (QUALITY_METRIC_PSNR | QUALITY_METRIC_SSIM | QUALITY_METRIC_MS_SSIM)
+
+// PSNR reported for identical frames instead of infinity
+#define QUALITY_PSNR_MAX 100.0
+
+#define QUALITY_SSIM_WINDOW 11 // Gaussian window, sigma 1.5
+#define QUALITY_MS_SSIM_SCALES 5
+
+// Objective difference between two RGBA frames. PSNR is over RGB; SSIM and
+// MS-SSIM are over BT.601 luma. Metrics not requested are left at 0.
+typedef struct quality_result_t {
+    double mse;
+    double psnr;    // dB
+    double ssim;    // 1 = identical
+    double ms_ssim; // 1 = identical; fewer scales on small frames
+} quality_result_t;
+
+// Running statistics over a stream of comparisons
+typedef struct quality_summary_t {
+    double frames;
+    double psnr_mean;
+    double psnr_min;
+    double ssim_mean;
+    double ssim_min;
+    double ms_ssim_mean;
+    double ms_ssim_min;
+} quality_summary_t;
+
+// Comparison context: owns the luma/pyramid scratch, reused across frames,
+// and accumulates a summary for stream comparisons. Not thread-safe; use
+// one context per thread.
+typedef struct quality_metrics_t {
+    float* scratch;
+    size_t scratch_capacity; // In floats
+    quality_result_t last;
+    quality_summary_t summary;
+} quality_metrics_t;
+
+// Stateless PSNR/MSE; no allocation
+EMSCRIPTEN_KEEPALIVE double quality_mse(const video_frame_t* a, const video_frame_t* b);
+EMSCRIPTEN_KEEPALIVE double quality_psnr_from_mse(double mse);
+
+// Context lifetime
+EMSCRIPTEN_KEEPALIVE quality_metrics_t* quality_metrics_create(void);
+EMSCRIPTEN_KEEPALIVE void quality_metrics_destroy(quality_metrics_t* metrics);
+EMSCRIPTEN_KEEPALIVE void quality_metrics_reset(quality_metrics_t* metrics);
+
+// Compare two frames of equal size and fold the result into the summary.
+// Returns false on mismatched frames, frames smaller than the SSIM window
+// (when SSIM is requested) or allocation failure.
+EMSCRIPTEN_KEEPALIVE bool quality_metrics_compare(quality_metrics_t* metrics, const video_frame_t* a,
+                                                  const video_frame_t* b, int which, quality_result_t* result);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE engine_handle_t js_quality_metrics_create(void);
+EMSCRIPTEN_KEEPALIVE void js_quality_metrics_destroy(engine_handle_t metrics_handle);
+EMSCRIPTEN_KEEPALIVE void js_quality_metrics_reset(engine_handle_t metrics_handle);
+EMSCRIPTEN_KEEPALIVE int js_quality_metrics_compare(engine_handle_t metrics_handle, uint8_t* a, uint8_t* b, int width, int height, int which);
+EMSCRIPTEN_KEEPALIVE const quality_result_t* js_quality_metrics_get_last(engine_handle_t metrics_handle);
+EMSCRIPTEN_KEEPALIVE const quality_summary_t* js_quality_metrics_get_summary(engine_handle_t metrics_handle);
+
+#endif // QUALITY_METRICS_H
@@ -0,0 +1,41 @@
+#ifndef REFERENCE_KERNELS_H
+#define REFERENCE_KERNELS_H
+
+#include "video_engine.h"
+#include "filters.h"
+
+// Frozen scalar reference for every production kernel, with identical
+// signatures and semantics. Used by kernel_verifier only; not exported.
+
+// Filters
+void reference_filter_color_correction(video_frame_t* frame, color_correction_t* params);
+void reference_filter_blur(video_frame_t* frame, blur_params_t* params);
+void reference_filter_sharpen(video_frame_t* frame, float intensity);
+void reference_filter_edge_detection_new(video_frame_t* frame, float intensity);
+void reference_filter_noise_reduction(video_frame_t* frame, float strength);
+void reference_filter_transform(video_frame_t* frame, transform_params_t* params);
+void reference_filter_sepia(video_frame_t* frame, float intensity);
+void reference_filter_black_and_white(video_frame_t* frame, float intensity);
+void reference_filter_vintage(video_frame_t* frame, float intensity);
+void reference_filter_vignette(video_frame_t* frame, float intensity);
+
+// Transitions
+void reference_transition_fade(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress);
+void reference_transition_dissolve(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress);
+void reference_transition_wipe_left(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress);
+void reference_transition_wipe_right(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress);
+void reference_transition_wipe_up(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress);
+void reference_transition_wipe_down(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress);
+
+// Conversions
+void reference_convert_rgb_to_yuv420(uint8_t* rgb_data, uint8_t* yuv_data, int width, int height);
+void reference_convert_yuv420_to_rgb(uint8_t* yuv_data, uint8_t* rgb_data, int width, int height);
+void reference_convert_rgba_to_rgb(uint8_t* rgba_data, uint8_t* rgb_data, int width, int height);
+void reference_convert_rgb_to_rgba(uint8_t* rgb_data, uint8_t* rgba_data, int width, int height, uint8_t alpha);
+
+// Resampling
+void reference_frame_resize(video_frame_t* src, video_frame_t* dst, int new_width, int new_height);
+void reference_frame_downscale_area(video_frame_t* src, video_frame_t* dst, int factor);
+void reference_frame_upscale(video_frame_t* src, video_frame_t* dst, int new_width, int new_height);
+
+#endif // REFERENCE_KERNELS_H
@@ -0,0 +1,120 @@
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+#include "video_engine.h"
+#include "handle_table.h"
+#include <stdatomic.h>
+
+// Worker threads are only available in native builds and -pthread WASM builds.
+// Without them the scheduler is pumped with render_scheduler_run_pending().
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define RENDER_SCHEDULER_THREADS 1
+#include <pthread.h>
+#else
+#define RENDER_SCHEDULER_THREADS 0
+#endif
+
+#define RENDER_SCHEDULER_MAX_THREADS 16
+#define RENDER_SCHEDULER_MAX_JOBS 256
+
+// Kernels poll for preemption once per band of this many rows. A band of a
+// 4K frame through the heaviest kernel (full color correction) is ~0.8 ms.
+#define RENDER_CHECKPOINT_ROWS 4
+
+// Priority classes, most urgent first
+typedef enum {
+    RENDER_PRIORITY_INTERACTIVE = 0, // Frame the user is looking at right now
+    RENDER_PRIORITY_PREFETCH = 1,    // Frames about to be shown
+    RENDER_PRIORITY_EXPORT = 2,      // Background export
+    RENDER_PRIORITY_ANALYSIS = 3,    // Metrics, thumbnails, verification
+    RENDER_PRIORITY_COUNT
+} render_priority_t;
+
+typedef void (*render_job_fn)(void* context, void* payload);
+
+// Queued unit of work
+typedef struct render_job_t {
+    render_job_fn fn;
+    void* context;
+    void* payload;
+    render_priority_t priority;
+    struct render_job_t* next;
+} render_job_t;
+
+// Priority scheduler over an optional pool of worker threads.
+//
+// Workers always take the most urgent queued job. Running jobs are not
+// interrupted; instead kernels call render_checkpoint() at row-band
+// boundaries, which runs any queued job of a strictly higher priority inline
+// on the same thread before the kernel continues. A preview frame therefore
+// waits at most one band even when every worker is busy exporting.
+typedef struct render_scheduler_t {
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    pthread_cond_t work_done;
+    pthread_t threads[RENDER_SCHEDULER_MAX_THREADS];
+#endif
+    int thread_count;
+    bool shutting_down;
+
+    render_job_t* queue_head[RENDER_PRIORITY_COUNT];
+    render_job_t* queue_tail[RENDER_PRIORITY_COUNT];
+    _Atomic uint32_t pending_mask; // Bit p set while priority p has queued jobs
+    int queued_jobs;
+    int running_jobs;
+
+    // Fixed job storage, no allocation per submitted job
+    render_job_t jobs[RENDER_SCHEDULER_MAX_JOBS];
+    render_job_t* free_jobs;
+} render_scheduler_t;
+
+// Scheduler lifetime (thread_count 0 = cooperative, caller pumps the queue)
+EMSCRIPTEN_KEEPALIVE render_scheduler_t* render_scheduler_create(int thread_count);
+EMSCRIPTEN_KEEPALIVE void render_scheduler_destroy(render_scheduler_t* scheduler);
+
+// Job submission and execution
+EMSCRIPTEN_KEEPALIVE bool render_scheduler_submit(render_scheduler_t* scheduler, render_priority_t priority,
+                                                  render_job_fn fn, void* context, void* payload);
+EMSCRIPTEN_KEEPALIVE int render_scheduler_run_pending(render_scheduler_t* scheduler, int max_jobs);
+EMSCRIPTEN_KEEPALIVE void render_scheduler_wait_idle(render_scheduler_t* scheduler);
+EMSCRIPTEN_KEEPALIVE int render_scheduler_get_queued(render_scheduler_t* scheduler, render_priority_t priority);
+
+// Cancellation token. Work captures the epoch when it starts; bumping the
+// epoch cancels everything started before, leaving later work unaffected.
+typedef struct render_cancel_token_t {
+    _Atomic uint32_t epoch;
+} render_cancel_token_t;
+
+EMSCRIPTEN_KEEPALIVE void render_cancel_token_init(render_cancel_token_t* token);
+EMSCRIPTEN_KEEPALIVE void render_cancel_token_cancel(render_cancel_token_t* token);
+
+// Execution context of the calling thread. Work done outside the scheduler
+// (e.g. a direct effects_process_frame call) can enter a context so its
+// kernels still yield to more urgent queued jobs and observe cancellation.
+typedef struct render_context_t {
+    render_scheduler_t* scheduler;
+    render_priority_t priority;
+    render_cancel_token_t* cancel; // May be NULL
+    uint32_t epoch;                // Token epoch captured on entry
+    struct render_context_t* previous;
+} render_context_t;
+
+EMSCRIPTEN_KEEPALIVE void render_context_enter(render_context_t* context, render_scheduler_t* scheduler,
+                                               render_priority_t priority, render_cancel_token_t* cancel);
+EMSCRIPTEN_KEEPALIVE void render_context_leave(render_context_t* context);
+EMSCRIPTEN_KEEPALIVE render_context_t* render_context_current(void);
+
+// Cooperative yield point for kernels. Runs more urgent queued jobs and
+// returns false once the current work has been cancelled, in which case the
+// kernel stops and leaves its output unspecified.
+EMSCRIPTEN_KEEPALIVE bool render_checkpoint(void);
+EMSCRIPTEN_KEEPALIVE bool render_cancelled(void);
+
+// JavaScript bindings
+EMSCRIPTEN_KEEPALIVE engine_handle_t js_render_scheduler_create(int thread_count);
+EMSCRIPTEN_KEEPALIVE void js_render_scheduler_destroy(engine_handle_t scheduler_handle);
+EMSCRIPTEN_KEEPALIVE int js_render_scheduler_run_pending(engine_handle_t scheduler_handle, int max_jobs);
+EMSCRIPTEN_KEEPALIVE int js_render_scheduler_get_queued(engine_handle_t scheduler_handle, int priority);
+
+#endif // RENDER_SCHEDULER_H
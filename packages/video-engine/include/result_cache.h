@@ -0,0 +1,63 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "video_engine.h"
+#include "adaptive_quality.h"
+#include <stddef.h>
+
+// Rendered frames, keyed by source identity and the canonical hash of the
+// chain as evaluated at the frame's time, so scrubbing back over viewed frames
+// or replaying a loop costs a copy instead of a render. Least recently used
+// frames are evicted to stay within a byte budget; frames are optionally
+// stored QOI-compressed to fit 2-4x more.
+#define RESULT_CACHE_ENTRIES 256
+#define RESULT_CACHE_DEFAULT_BUDGET (128u << 20) // Sixteen raw 1080p frames
+
+typedef struct result_cache_entry_t {
+    uint64_t key;                // 0 while empty
+    uint8_t* data;
+    size_t size;                 // Bytes held (encoded size when compressed)
+    int width;
+    int height;
+    render_quality_t quality;    // Quality the frame was rendered at
+    bool compressed;
+    bool prefetched;             // Pre-rendered and not yet looked up
+    uint64_t last_used;
+} result_cache_entry_t;
+
+typedef struct result_cache_t {
+    result_cache_entry_t entries[RESULT_CACHE_ENTRIES];
+    size_t budget;               // 0 disables the cache
+    size_t used;
+    size_t prefetched_bytes;
+    bool compress;
+    uint64_t clock;              // Bumped on every hit and store
+    uint8_t* scratch;            // Encoder output, one raw frame
+    size_t scratch_capacity;
+} result_cache_t;
+
+EMSCRIPTEN_KEEPALIVE void result_cache_init(result_cache_t* cache, size_t budget);
+EMSCRIPTEN_KEEPALIVE void result_cache_destroy(result_cache_t* cache);
+EMSCRIPTEN_KEEPALIVE void result_cache_clear(result_cache_t* cache);
+// Evicts down to the new budget
+EMSCRIPTEN_KEEPALIVE void result_cache_set_budget(result_cache_t* cache, size_t budget);
+// Applies to frames stored from now on
+EMSCRIPTEN_KEEPALIVE void result_cache_set_compression(result_cache_t* cache, bool compress);
+
+// Copy the frame cached under key into frame (same size) if it was rendered
+// at max_quality or better; the quality is reported through quality
+EMSCRIPTEN_KEEPALIVE bool result_cache_lookup(result_cache_t* cache, uint64_t key, video_frame_t* frame,
+                                              render_quality_t max_quality, render_quality_t* quality);
+// Cache a rendered frame, evicting LRU frames to make room. A frame already
+// cached under key at a better quality is kept. Prefetched frames count
+// against the prefetch share until they are first looked up.
+EMSCRIPTEN_KEEPALIVE bool result_cache_store(result_cache_t* cache, uint64_t key, const video_frame_t* frame,
+                                             render_quality_t quality, bool prefetched);
+
+// Pre-rendered frames not yet shown may fill half the budget, so lookahead
+// never pushes out everything else
+EMSCRIPTEN_KEEPALIVE bool result_cache_can_prefetch(const result_cache_t* cache, size_t bytes);
+// Drop prefetched frames nobody looked up, e.g. rendered for an old chain
+EMSCRIPTEN_KEEPALIVE void result_cache_evict_prefetched(result_cache_t* cache);
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,45 @@
+#ifndef STAGE_CACHE_H
+#define STAGE_CACHE_H
+
+#include "video_engine.h"
+#include <stddef.h>
+
+// Input of the effect being edited on the frame last rendered, so
+// re-rendering the same source after a parameter change (dragging a slider
+// on a paused frame) resumes at that effect. Stage keys hash the source
+// identity and every effect up to and including the stage, so a match
+// proves the whole prefix is unchanged. The edited stage is the first whose
+// key differs from the previous render's; only the output of the stage
+// before it is kept, and the chain otherwise runs in place with no copies.
+#define STAGE_CACHE_STAGES 32                    // MAX_EFFECTS_CHAIN
+#define STAGE_CACHE_DEFAULT_BUDGET (64u << 20)   // One 4K frame
+
+typedef struct stage_cache_t {
+    uint64_t keys[STAGE_CACHE_STAGES];  // Stage keys of the last render
+    int count;
+    uint64_t key;          // Key of the stage the snapshot holds; 0 while empty
+    video_frame_t frame;   // Snapshot
+    size_t capacity;
+    size_t budget;         // Bytes the snapshot may hold; 0 disables the cache
+} stage_cache_t;
+
+EMSCRIPTEN_KEEPALIVE void stage_cache_init(stage_cache_t* cache, size_t budget);
+EMSCRIPTEN_KEEPALIVE void stage_cache_destroy(stage_cache_t* cache);
+// Drops the snapshot, then caches within the new budget
+EMSCRIPTEN_KEEPALIVE void stage_cache_set_budget(stage_cache_t* cache, size_t budget);
+
+// Key of the chain's input: source identity plus everything besides the
+// effects that changes what the stages compute
+EMSCRIPTEN_KEEPALIVE uint64_t stage_cache_seed(uint64_t source_id, double timestamp, int width, int height, int quality,
+                                               int scale);
+// Stage below count whose output the snapshot holds, -1 if none
+EMSCRIPTEN_KEEPALIVE int stage_cache_find(const stage_cache_t* cache, const uint64_t* keys, int count);
+// Stage whose output this render should keep, -1 for none: the input of the
+// first stage that changed since the last render, when that lies past
+// resume. Remembers keys as the last render's.
+EMSCRIPTEN_KEEPALIVE int stage_cache_plan(stage_cache_t* cache, const uint64_t* keys, int count, int resume);
+// Copy frame in as the output of the stage with key; false when it does not
+// fit the budget
+EMSCRIPTEN_KEEPALIVE bool stage_cache_store(stage_cache_t* cache, const video_frame_t* frame, uint64_t key);
+
+#endif // STAGE_CACHE_H
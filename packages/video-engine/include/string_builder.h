@@ -0,0 +1,24 @@
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include "video_engine.h"
+#include <stddef.h>
+
+// Growable malloc'd string for building diagnostics dumps
+typedef struct string_builder_t {
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool failed;      // Sticky: set once an allocation fails
+} string_builder_t;
+
+bool string_builder_init(string_builder_t* builder, size_t initial_capacity);
+void string_builder_append(string_builder_t* builder, const char* format, ...) __attribute__((format(printf, 2, 3)));
+// Append text as a quoted JSON string, escaping quotes, backslashes and
+// control characters
+void string_builder_append_json_string(string_builder_t* builder, const char* text);
+
+// Hand the NUL-terminated string to the caller (NULL if anything failed)
+char* string_builder_finish(string_builder_t* builder, size_t* length);
+
+#endif // STRING_BUILDER_H
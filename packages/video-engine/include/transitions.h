@@ -2,7 +2,6 @@
 #define TRANSITIONS_H
 
 #include "video_engine.h"
-#include <emscripten.h>
 
 // Transition types
 typedef enum {
@@ -3,6 +3,7 @@
 
 #include "video_engine.h"
 #include "effects_engine.h"
+#include "quality_metrics.h"
 
 // Video encoder structure
 typedef struct video_encoder_t {
@@ -48,7 +49,7 @@ typedef struct export_job_t {
     int output_width;
     int output_height;
     double output_fps;
-    const char* output_path;
+    char output_path[256]; // Owned copy; callers' strings don't outlive the call. Paths that don't fit are rejected
 
     // Progress tracking
     double start_time;
@@ -62,6 +63,11 @@ typedef struct export_job_t {
     bool is_complete;
     bool has_error;
     char error_message[256];
+
+    // QA mode: every exported frame is compared against a reference render
+    quality_metrics_t* qa_metrics; // NULL when QA is off
+    uint8_t* qa_reference;
+    size_t qa_reference_size;
 } export_job_t;
 
 // Core encoder functions
@@ -88,6 +94,8 @@ EMSCRIPTEN_KEEPALIVE bool export_job_start(export_job_t* job);
 EMSCRIPTEN_KEEPALIVE bool export_job_process_frame(export_job_t* job, uint8_t* frame_data, double timestamp);
 EMSCRIPTEN_KEEPALIVE bool export_job_finish(export_job_t* job);
 EMSCRIPTEN_KEEPALIVE double export_job_get_progress(export_job_t* job);
+EMSCRIPTEN_KEEPALIVE bool export_job_set_qa(export_job_t* job, bool enabled);
+EMSCRIPTEN_KEEPALIVE const quality_summary_t* export_job_get_qa_summary(export_job_t* job);
 
 // Settings and configuration
 EMSCRIPTEN_KEEPALIVE void video_encoder_set_quality(video_encoder_t* encoder, int quality);
@@ -100,35 +108,37 @@ EMSCRIPTEN_KEEPALIVE int video_encoder_get_frames_exported(video_encoder_t* enco
 EMSCRIPTEN_KEEPALIVE bool video_encoder_is_exporting(video_encoder_t* encoder);
 
 // JavaScript bindings
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_create(int width, int height, double fps);
-EMSCRIPTEN_KEEPALIVE void js_video_encoder_destroy(int encoder_ptr);
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_start_export(int encoder_ptr, const char* output_path);
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_add_frame(int encoder_ptr, uint8_t* frame_data, double timestamp);
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_finish_export(int encoder_ptr);
-EMSCRIPTEN_KEEPALIVE void js_video_encoder_cancel_export(int encoder_ptr);
+EMSCRIPTEN_KEEPALIVE engine_handle_t js_video_encoder_create(int width, int height, double fps);
+EMSCRIPTEN_KEEPALIVE void js_video_encoder_destroy(engine_handle_t encoder_handle);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_start_export(engine_handle_t encoder_handle, const char* output_path);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_add_frame(engine_handle_t encoder_handle, uint8_t* frame_data, double timestamp);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_finish_export(engine_handle_t encoder_handle);
+EMSCRIPTEN_KEEPALIVE void js_video_encoder_cancel_export(engine_handle_t encoder_handle);
 
 // Advanced export with effects
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_set_effects_engine(int encoder_ptr, int effects_engine_ptr);
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_process_and_export_frame(int encoder_ptr, uint8_t* frame_data, int width, int height, double timestamp);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_set_effects_engine(engine_handle_t encoder_handle, engine_handle_t effects_engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_process_and_export_frame(engine_handle_t encoder_handle, uint8_t* frame_data, int width, int height, double timestamp);
 
 // Export job JavaScript bindings
-EMSCRIPTEN_KEEPALIVE int js_export_job_create(int source_width, int source_height, double source_fps, double duration);
-EMSCRIPTEN_KEEPALIVE void js_export_job_destroy(int job_ptr);
-EMSCRIPTEN_KEEPALIVE int js_export_job_configure(int job_ptr, int output_width, int output_height, double output_fps, const char* output_path);
-EMSCRIPTEN_KEEPALIVE int js_export_job_set_effects_engine(int job_ptr, int effects_engine_ptr);
-EMSCRIPTEN_KEEPALIVE int js_export_job_start(int job_ptr);
-EMSCRIPTEN_KEEPALIVE int js_export_job_process_frame(int job_ptr, uint8_t* frame_data, double timestamp);
-EMSCRIPTEN_KEEPALIVE int js_export_job_finish(int job_ptr);
-EMSCRIPTEN_KEEPALIVE double js_export_job_get_progress(int job_ptr);
+EMSCRIPTEN_KEEPALIVE engine_handle_t js_export_job_create(int source_width, int source_height, double source_fps, double duration);
+EMSCRIPTEN_KEEPALIVE void js_export_job_destroy(engine_handle_t job_handle);
+EMSCRIPTEN_KEEPALIVE int js_export_job_configure(engine_handle_t job_handle, int output_width, int output_height, double output_fps, const char* output_path);
+EMSCRIPTEN_KEEPALIVE int js_export_job_set_effects_engine(engine_handle_t job_handle, engine_handle_t effects_engine_handle);
+EMSCRIPTEN_KEEPALIVE int js_export_job_start(engine_handle_t job_handle);
+EMSCRIPTEN_KEEPALIVE int js_export_job_process_frame(engine_handle_t job_handle, uint8_t* frame_data, double timestamp);
+EMSCRIPTEN_KEEPALIVE int js_export_job_finish(engine_handle_t job_handle);
+EMSCRIPTEN_KEEPALIVE double js_export_job_get_progress(engine_handle_t job_handle);
+EMSCRIPTEN_KEEPALIVE int js_export_job_set_qa(engine_handle_t job_handle, int enabled);
+EMSCRIPTEN_KEEPALIVE const quality_summary_t* js_export_job_get_qa_summary(engine_handle_t job_handle);
 
 // Configuration JavaScript bindings
-EMSCRIPTEN_KEEPALIVE void js_video_encoder_set_quality(int encoder_ptr, int quality);
-EMSCRIPTEN_KEEPALIVE void js_video_encoder_set_bitrate(int encoder_ptr, int bitrate);
-EMSCRIPTEN_KEEPALIVE void js_video_encoder_set_format(int encoder_ptr, const char* format);
+EMSCRIPTEN_KEEPALIVE void js_video_encoder_set_quality(engine_handle_t encoder_handle, int quality);
+EMSCRIPTEN_KEEPALIVE void js_video_encoder_set_bitrate(engine_handle_t encoder_handle, int bitrate);
+EMSCRIPTEN_KEEPALIVE void js_video_encoder_set_format(engine_handle_t encoder_handle, const char* format);
 
 // Status JavaScript bindings
-EMSCRIPTEN_KEEPALIVE double js_video_encoder_get_progress(int encoder_ptr);
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_get_frames_exported(int encoder_ptr);
-EMSCRIPTEN_KEEPALIVE int js_video_encoder_is_exporting(int encoder_ptr);
+EMSCRIPTEN_KEEPALIVE double js_video_encoder_get_progress(engine_handle_t encoder_handle);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_get_frames_exported(engine_handle_t encoder_handle);
+EMSCRIPTEN_KEEPALIVE int js_video_encoder_is_exporting(engine_handle_t encoder_handle);
 
 #endif // VIDEO_ENCODER_H
\ No newline at end of file
@@ -3,7 +3,13 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+// Native builds (benchmarks, render hosts) export nothing to JavaScript
+#define EMSCRIPTEN_KEEPALIVE
+#endif
 
 // Forward declarations
 typedef struct video_frame_t video_frame_t;
@@ -60,11 +66,24 @@ EMSCRIPTEN_KEEPALIVE void memory_pool_free(memory_pool_t* pool, uint8_t* ptr);
 // Frame processing
 EMSCRIPTEN_KEEPALIVE void video_frame_resize(video_frame_t* src, video_frame_t* dst, int new_width, int new_height);
 EMSCRIPTEN_KEEPALIVE void video_frame_crop(video_frame_t* src, video_frame_t* dst, int x, int y, int width, int height);
+EMSCRIPTEN_KEEPALIVE void video_frame_downscale_area(video_frame_t* src, video_frame_t* dst, int factor);
+EMSCRIPTEN_KEEPALIVE void video_frame_upscale(video_frame_t* src, video_frame_t* dst, int new_width, int new_height);
 EMSCRIPTEN_KEEPALIVE void video_frame_convert_rgb_to_rgba(video_frame_t* src, video_frame_t* dst);
 
+// Pixel format conversion. YUV 4:2:0 buffers hold a width x height luma
+// plane followed by two ceil(width / 2) x ceil(height / 2) chroma planes.
+EMSCRIPTEN_KEEPALIVE void convert_rgb_to_yuv420(uint8_t* rgb_data, uint8_t* yuv_data, int width, int height);
+EMSCRIPTEN_KEEPALIVE void convert_yuv420_to_rgb(uint8_t* yuv_data, uint8_t* rgb_data, int width, int height);
+EMSCRIPTEN_KEEPALIVE void convert_rgba_to_rgb(uint8_t* rgba_data, uint8_t* rgb_data, int width, int height);
+EMSCRIPTEN_KEEPALIVE void convert_rgb_to_rgba(uint8_t* rgb_data, uint8_t* rgba_data, int width, int height, uint8_t alpha);
+
 // Utility functions
 EMSCRIPTEN_KEEPALIVE void video_engine_init(void);
 EMSCRIPTEN_KEEPALIVE void video_engine_cleanup(void);
 EMSCRIPTEN_KEEPALIVE const char* video_engine_version(void);
 
+// Bump whenever a change alters the pixels any kernel or chain produces:
+// persistent caches key frames by it, so older output is never served
+#define VIDEO_ENGINE_RENDER_VERSION 1
+
 #endif // VIDEO_ENGINE_H
\ No newline at end of file
@@ -1,26 +1,28 @@
 #include "video_engine.h"
 #include "filters.h"
 #include "transitions.h"
+#include "engine_trace.h"
+#include "engine_log.h"
+#include "handle_table.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 
-// Global engine state
-static bool engine_initialized = false;
 static const char* engine_version_string = "CinemaStudio Pro Video Engine v1.0.0";
 
+// The engine keeps no process-wide mutable state: every effects engine,
+// encoder and export job owns its chain, pools and buffers, so several can
+// run side by side (preview + background export, one job per worker). The
+// exceptions are the trace recorder (engine_trace.h), the log ring
+// (engine_log.h) and the counters (engine_counters.h), which are
+// process-wide by nature.
+// init/cleanup are kept for API compatibility and are safe to call any
+// number of times from any thread.
 void video_engine_init(void) {
-    if (engine_initialized) return;
-    
-    // Initialize any global state here
-    engine_initialized = true;
 }
 
 void video_engine_cleanup(void) {
-    if (!engine_initialized) return;
-    
-    // Clean up global state
-    engine_initialized = false;
 }
 
 const char* video_engine_version(void) {
@@ -29,92 +31,98 @@ const char* video_engine_version(void) {
 
 // JavaScript-callable wrapper functions with error checking
 EMSCRIPTEN_KEEPALIVE
-int js_video_decoder_create(void) {
+engine_handle_t js_video_decoder_create(void) {
     video_decoder_t* decoder = video_decoder_create();
-    return (int)(uintptr_t)decoder; // Return pointer as integer
+    engine_handle_t handle = handle_register(decoder, HANDLE_TYPE_DECODER);
+    if (handle == HANDLE_INVALID) video_decoder_destroy(decoder);
+    return handle;
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_video_decoder_destroy(int decoder_ptr) {
-    if (decoder_ptr == 0) return;
-    video_decoder_t* decoder = (video_decoder_t*)(uintptr_t)decoder_ptr;
+void js_video_decoder_destroy(engine_handle_t decoder_handle) {
+    video_decoder_t* decoder = handle_release(decoder_handle, HANDLE_TYPE_DECODER);
+    if (!decoder) return;
     video_decoder_destroy(decoder);
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_decoder_open(int decoder_ptr, uint8_t* data, int size) {
-    if (decoder_ptr == 0 || !data || size <= 0) return 0;
-    video_decoder_t* decoder = (video_decoder_t*)(uintptr_t)decoder_ptr;
+int js_video_decoder_open(engine_handle_t decoder_handle, uint8_t* data, int size) {
+    video_decoder_t* decoder = handle_get(decoder_handle, HANDLE_TYPE_DECODER);
+    if (!decoder || !data || size <= 0) return 0;
     return video_decoder_open(decoder, data, size) ? 1 : 0;
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_decoder_get_frame(int decoder_ptr, int frame_number) {
-    if (decoder_ptr == 0) return 0;
-    video_decoder_t* decoder = (video_decoder_t*)(uintptr_t)decoder_ptr;
+engine_handle_t js_video_decoder_get_frame(engine_handle_t decoder_handle, int frame_number) {
+    video_decoder_t* decoder = handle_get(decoder_handle, HANDLE_TYPE_DECODER);
+    if (!decoder) return HANDLE_INVALID;
     video_frame_t* frame = video_decoder_get_frame(decoder, frame_number);
-    return (int)(uintptr_t)frame;
+    engine_handle_t handle = handle_register(frame, HANDLE_TYPE_FRAME);
+    if (handle == HANDLE_INVALID) video_frame_destroy(frame);
+    return handle;
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_video_frame_destroy(int frame_ptr) {
-    if (frame_ptr == 0) return;
-    video_frame_t* frame = (video_frame_t*)(uintptr_t)frame_ptr;
+void js_video_frame_destroy(engine_handle_t frame_handle) {
+    video_frame_t* frame = handle_release(frame_handle, HANDLE_TYPE_FRAME);
+    if (!frame) return;
     video_frame_destroy(frame);
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_frame_get_width(int frame_ptr) {
-    if (frame_ptr == 0) return 0;
-    video_frame_t* frame = (video_frame_t*)(uintptr_t)frame_ptr;
+int js_video_frame_get_width(engine_handle_t frame_handle) {
+    video_frame_t* frame = handle_get(frame_handle, HANDLE_TYPE_FRAME);
+    if (!frame) return 0;
     return frame->width;
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_frame_get_height(int frame_ptr) {
-    if (frame_ptr == 0) return 0;
-    video_frame_t* frame = (video_frame_t*)(uintptr_t)frame_ptr;
+int js_video_frame_get_height(engine_handle_t frame_handle) {
+    video_frame_t* frame = handle_get(frame_handle, HANDLE_TYPE_FRAME);
+    if (!frame) return 0;
     return frame->height;
 }
 
 EMSCRIPTEN_KEEPALIVE
-uint8_t* js_video_frame_get_data(int frame_ptr) {
-    if (frame_ptr == 0) return NULL;
-    video_frame_t* frame = (video_frame_t*)(uintptr_t)frame_ptr;
+uint8_t* js_video_frame_get_data(engine_handle_t frame_handle) {
+    video_frame_t* frame = handle_get(frame_handle, HANDLE_TYPE_FRAME);
+    if (!frame) return NULL;
     return frame->data;
 }
 
 EMSCRIPTEN_KEEPALIVE
-double js_video_frame_get_timestamp(int frame_ptr) {
-    if (frame_ptr == 0) return 0.0;
-    video_frame_t* frame = (video_frame_t*)(uintptr_t)frame_ptr;
+double js_video_frame_get_timestamp(engine_handle_t frame_handle) {
+    video_frame_t* frame = handle_get(frame_handle, HANDLE_TYPE_FRAME);
+    if (!frame) return 0.0;
     return frame->timestamp;
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_memory_pool_create(int block_size, int block_count) {
+engine_handle_t js_memory_pool_create(int block_size, int block_count) {
     memory_pool_t* pool = memory_pool_create(block_size, block_count);
-    return (int)(uintptr_t)pool;
+    engine_handle_t handle = handle_register(pool, HANDLE_TYPE_MEMORY_POOL);
+    if (handle == HANDLE_INVALID) memory_pool_destroy(pool);
+    return handle;
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_memory_pool_destroy(int pool_ptr) {
-    if (pool_ptr == 0) return;
-    memory_pool_t* pool = (memory_pool_t*)(uintptr_t)pool_ptr;
+void js_memory_pool_destroy(engine_handle_t pool_handle) {
+    memory_pool_t* pool = handle_release(pool_handle, HANDLE_TYPE_MEMORY_POOL);
+    if (!pool) return;
     memory_pool_destroy(pool);
 }
 
 EMSCRIPTEN_KEEPALIVE
-uint8_t* js_memory_pool_alloc(int pool_ptr) {
-    if (pool_ptr == 0) return NULL;
-    memory_pool_t* pool = (memory_pool_t*)(uintptr_t)pool_ptr;
+uint8_t* js_memory_pool_alloc(engine_handle_t pool_handle) {
+    memory_pool_t* pool = handle_get(pool_handle, HANDLE_TYPE_MEMORY_POOL);
+    if (!pool) return NULL;
     return memory_pool_alloc(pool);
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_memory_pool_free(int pool_ptr, uint8_t* ptr) {
-    if (pool_ptr == 0 || !ptr) return;
-    memory_pool_t* pool = (memory_pool_t*)(uintptr_t)pool_ptr;
+void js_memory_pool_free(engine_handle_t pool_handle, uint8_t* ptr) {
+    memory_pool_t* pool = handle_get(pool_handle, HANDLE_TYPE_MEMORY_POOL);
+    if (!pool || !ptr) return;
     memory_pool_free(pool, ptr);
 }
 
@@ -126,9 +134,9 @@ void js_apply_real_time_filter(uint8_t* frame_data, int width, int height, int f
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_apply_color_correction(int frame_ptr, float brightness, float contrast, float saturation, float hue, float gamma, float exposure) {
-    if (frame_ptr == 0) return;
-    video_frame_t* frame = (video_frame_t*)(uintptr_t)frame_ptr;
+void js_apply_color_correction(engine_handle_t frame_handle, float brightness, float contrast, float saturation, float hue, float gamma, float exposure) {
+    video_frame_t* frame = handle_get(frame_handle, HANDLE_TYPE_FRAME);
+    if (!frame) return;
     
     color_correction_t params = {
         .brightness = brightness,
@@ -184,7 +192,7 @@ void js_apply_color_correction_direct(uint8_t* frame_data, int width, int height
 
 // Export functionality
 EMSCRIPTEN_KEEPALIVE
-int js_video_exporter_create(int width, int height, int fps, int format) {
+engine_handle_t js_video_exporter_create(int width, int height, int fps, int format) {
     // format: 0 = MP4, 1 = WebM
     // For now, create a simple frame buffer to collect frames
     video_decoder_t* exporter = video_decoder_create();
@@ -193,40 +201,35 @@ int js_video_exporter_create(int width, int height, int fps, int format) {
         exporter->height = height;
         exporter->fps = fps;
         exporter->total_frames = 0; // Will be updated as we add frames
-        printf("📹 Created video exporter: %dx%d @ %dfps, format: %s\n", 
-               width, height, fps, format == 0 ? "MP4" : "WebM");
+        LOG_INFO("Created video exporter: %dx%d @ %dfps, format: %s",
+                 width, height, fps, format == 0 ? "MP4" : "WebM");
     }
-    return (int)(uintptr_t)exporter;
+    engine_handle_t handle = handle_register(exporter, HANDLE_TYPE_EXPORTER);
+    if (handle == HANDLE_INVALID) video_decoder_destroy(exporter);
+    return handle;
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_exporter_add_frame(int exporter_ptr, int frame_data_ptr, int width, int height) {
-    printf("🔧 js_video_exporter_add_frame called: exporter_ptr=%d, frame_data_ptr=%d, width=%d, height=%d\n", 
-           exporter_ptr, frame_data_ptr, width, height);
-    
-    if (exporter_ptr == 0) {
-        printf("❌ exporter_ptr is 0\n");
+int js_video_exporter_add_frame(engine_handle_t exporter_handle, uint8_t* frame_data, int width, int height) {
+    video_decoder_t* exporter = handle_get(exporter_handle, HANDLE_TYPE_EXPORTER);
+    if (!exporter) {
+        LOG_WARN("js_video_exporter_add_frame: invalid exporter handle %u", exporter_handle);
         return 0;
     }
     
-    if (frame_data_ptr == 0) {
-        printf("❌ frame_data_ptr is 0\n");
+    if (!frame_data) {
+        LOG_WARN("js_video_exporter_add_frame: frame_data is NULL");
         return 0;
     }
     
-    video_decoder_t* exporter = (video_decoder_t*)(uintptr_t)exporter_ptr;
-    uint8_t* frame_data = (uint8_t*)(uintptr_t)frame_data_ptr;
-    
-    printf("🔍 exporter pointer cast: %p, frame_data pointer cast: %p\n", (void*)exporter, (void*)frame_data);
-    
     // Simple frame validation
     int data_size = width * height * 4; // RGBA format
     if (data_size <= 0) {
-        printf("❌ Invalid data_size: %d\n", data_size);
+        LOG_WARN("js_video_exporter_add_frame: invalid frame size %dx%d", width, height);
         return 0;
     }
     
-    printf("✅ Frame validation passed, data_size: %d\n", data_size);
+    TRACE_BEGIN(trace_sink);
     
     // Store frame data for later export (dynamic allocation per frame)
     // Allocate or reallocate buffer to accommodate new frame
@@ -235,43 +238,44 @@ int js_video_exporter_add_frame(int exporter_ptr, int frame_data_ptr, int width,
     if (exporter->data == NULL) {
         // First frame - allocate initial buffer
         exporter->data = (uint8_t*)malloc(new_buffer_size);
-        printf("📦 Allocated initial frame buffer: %zu bytes\n", new_buffer_size);
+        LOG_DEBUG("Allocated initial frame buffer: %zu bytes", new_buffer_size);
     } else {
         // Subsequent frames - reallocate buffer
         uint8_t* new_data = (uint8_t*)realloc(exporter->data, new_buffer_size);
         if (new_data) {
             exporter->data = new_data;
-            printf("📦 Reallocated frame buffer: %zu bytes for %d frames\n", new_buffer_size, exporter->total_frames + 1);
+            LOG_DEBUG("Reallocated frame buffer: %zu bytes for %d frames", new_buffer_size, exporter->total_frames + 1);
         } else {
-            printf("❌ Failed to reallocate frame buffer\n");
+            LOG_ERROR("Failed to reallocate frame buffer (%zu bytes)", new_buffer_size);
             return 0;
         }
     }
     
     if (!exporter->data) {
-        printf("❌ Failed to allocate frame buffer (%zu bytes)\n", new_buffer_size);
+        LOG_ERROR("Failed to allocate frame buffer (%zu bytes)", new_buffer_size);
         return 0;
     }
     
     // Copy frame data to buffer
     uint8_t* dest = exporter->data + (exporter->total_frames * data_size);
     memcpy(dest, frame_data, data_size);
-    printf("📁 Copied %d bytes of frame data (%d frames)\n", data_size, exporter->total_frames + 1);
     
     exporter->total_frames++;
-    printf("🎬 Added frame %d to exporter (%dx%d), size: %d bytes\n", 
-           exporter->total_frames, width, height, data_size);
+    TRACE_END(trace_sink, "sink", "add_frame", exporter->total_frames - 1);
+    LOG_FRAME("Added frame %d to exporter (%dx%d), size: %d bytes",
+              exporter->total_frames, width, height, data_size);
     
     return 1;
 }
 
 EMSCRIPTEN_KEEPALIVE
-uint8_t* js_video_exporter_finalize(int exporter_ptr, int* output_size) {
-    if (exporter_ptr == 0 || output_size == NULL) return NULL;
+uint8_t* js_video_exporter_finalize(engine_handle_t exporter_handle, int* output_size) {
+    video_decoder_t* exporter = handle_get(exporter_handle, HANDLE_TYPE_EXPORTER);
+    if (!exporter || output_size == NULL) return NULL;
     
-    video_decoder_t* exporter = (video_decoder_t*)(uintptr_t)exporter_ptr;
+    TRACE_BEGIN(trace_finalize);
     
-    printf("🚀 Finalizing export with %d frames\n", exporter->total_frames);
+    LOG_INFO("Finalizing export with %d frames", exporter->total_frames);
     
     // Create a real video container format (simplified MP4-like structure)
     // This is a minimal implementation - in production you'd use libavformat/libx264
@@ -283,7 +287,7 @@ uint8_t* js_video_exporter_finalize(int exporter_ptr, int* output_size) {
     
     uint8_t* output_buffer = (uint8_t*)malloc(total_size);
     if (!output_buffer) {
-        printf("❌ Failed to allocate export buffer (%d bytes)\n", total_size);
+        LOG_ERROR("Failed to allocate export buffer (%d bytes)", total_size);
         *output_size = 0;
         return NULL;
     }
@@ -321,34 +325,34 @@ uint8_t* js_video_exporter_finalize(int exporter_ptr, int* output_size) {
             *((uint32_t*)ptr) = 0xDEADBEEF + i; ptr += 4;  // Simple checksum placeholder
             memset(ptr, 0, 12); ptr += 12;  // Reserved bytes
         }
-        printf("📁 Created frame summaries for %d frames (%d bytes)\n", exporter->total_frames, frame_summary_size);
+        LOG_DEBUG("Created frame summaries for %d frames (%d bytes)", exporter->total_frames, frame_summary_size);
     } else {
         // No frame data available, zero-fill
         memset(ptr, 0, frame_summary_size);
-        printf("⚠️ No frame data available, zero-filled\n");
+        LOG_WARN("No frame data available, zero-filled");
     }
     
     *output_size = total_size;
-    printf("✅ Export completed! Output size: %d bytes (%d frames, %dx%d)\n", 
-           total_size, exporter->total_frames, exporter->width, exporter->height);
+    LOG_INFO("Export completed: %d bytes (%d frames, %dx%d)",
+             total_size, exporter->total_frames, exporter->width, exporter->height);
     
+    TRACE_END(trace_finalize, "sink", "finalize", TRACE_NO_FRAME);
     return output_buffer;
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_video_exporter_destroy(int exporter_ptr) {
-    if (exporter_ptr == 0) return;
-    video_decoder_t* exporter = (video_decoder_t*)(uintptr_t)exporter_ptr;
+void js_video_exporter_destroy(engine_handle_t exporter_handle) {
+    video_decoder_t* exporter = handle_release(exporter_handle, HANDLE_TYPE_EXPORTER);
+    if (!exporter) return;
     
     // Free frame buffer if allocated
     if (exporter->data) {
         free(exporter->data);
         exporter->data = NULL;
-        printf("🗑️ Freed frame buffer\n");
     }
     
     video_decoder_destroy(exporter);
-    printf("🗑️ Destroyed video exporter\n");
+    LOG_DEBUG("Destroyed video exporter");
 }
 
 // WASM Blur Filter
@@ -372,7 +376,7 @@ void js_apply_blur_filter(uint8_t* frame_data, int width, int height, float radi
     };
     
     filter_blur(&temp_frame, &blur_params);
-    printf("🌫️ Applied WASM blur filter (radius: %.1f) to %dx%d frame\n", radius, width, height);
+    LOG_FRAME("Applied blur filter (radius: %.1f) to %dx%d frame", radius, width, height);
 }
 
 // WASM Sharpen Filter  
@@ -390,7 +394,7 @@ void js_apply_sharpen_filter(uint8_t* frame_data, int width, int height, float i
     };
     
     filter_sharpen(&temp_frame, intensity);
-    printf("⚡ Applied WASM sharpen filter (intensity: %.2f) to %dx%d frame\n", intensity, width, height);
+    LOG_FRAME("Applied sharpen filter (intensity: %.2f) to %dx%d frame", intensity, width, height);
 }
 
 // WASM Noise Reduction (Simple implementation)
@@ -414,7 +418,7 @@ void js_apply_noise_reduction(uint8_t* frame_data, int width, int height, float
     };
     
     filter_blur(&temp_frame, &noise_params);
-    printf("🔧 Applied WASM noise reduction (strength: %.2f) to %dx%d frame\n", strength, width, height);
+    LOG_FRAME("Applied noise reduction (strength: %.2f) to %dx%d frame", strength, width, height);
 }
 
 // WASM Transform Filter
@@ -445,8 +449,8 @@ void js_apply_transform(uint8_t* frame_data, int width, int height,
     };
     
     filter_transform(&temp_frame, &transform_params);
-    printf("🔄 Applied WASM transform filter (scale: %.1f%%, rotation: %.1f°, flip_h: %d, flip_v: %d, crop: %d,%d %dx%d) to %dx%d frame\n", 
-           scale, rotation, flip_horizontal, flip_vertical, crop_x, crop_y, crop_width, crop_height, width, height);
+    LOG_FRAME("Applied transform (scale: %.1f%%, rotation: %.1f, flip: %d/%d) to %dx%d frame",
+              scale, rotation, flip_horizontal, flip_vertical, width, height);
 }
 
 // WASM Sepia Filter
@@ -464,7 +468,7 @@ void js_apply_sepia_filter(uint8_t* frame_data, int width, int height, float int
     };
     
     filter_sepia(&temp_frame, intensity);
-    printf("🟤 Applied WASM sepia filter (intensity: %.2f) to %dx%d frame\n", intensity, width, height);
+    LOG_FRAME("Applied sepia filter (intensity: %.2f) to %dx%d frame", intensity, width, height);
 }
 
 // WASM Black and White Filter
@@ -482,7 +486,7 @@ void js_apply_black_and_white_filter(uint8_t* frame_data, int width, int height,
     };
     
     filter_black_and_white(&temp_frame, intensity);
-    printf("🔳 Applied WASM black and white filter (intensity: %.2f) to %dx%d frame\n", intensity, width, height);
+    LOG_FRAME("Applied black and white filter (intensity: %.2f) to %dx%d frame", intensity, width, height);
 }
 
 // WASM Vintage Filter
@@ -500,7 +504,7 @@ void js_apply_vintage_filter(uint8_t* frame_data, int width, int height, float i
     };
     
     filter_vintage(&temp_frame, intensity);
-    printf("🎞️ Applied WASM vintage filter (intensity: %.2f) to %dx%d frame\n", intensity, width, height);
+    LOG_FRAME("Applied vintage filter (intensity: %.2f) to %dx%d frame", intensity, width, height);
 }
 
 // WASM Vignette Filter
@@ -518,7 +522,7 @@ void js_apply_vignette_filter(uint8_t* frame_data, int width, int height, float
     };
     
     filter_vignette(&temp_frame, intensity);
-    printf("⚫ Applied WASM vignette filter (intensity: %.2f) to %dx%d frame\n", intensity, width, height);
+    LOG_FRAME("Applied vignette filter (intensity: %.2f) to %dx%d frame", intensity, width, height);
 }
 
 // WASM Edge Detection Filter
@@ -536,7 +540,7 @@ void js_apply_edge_detection_filter(uint8_t* frame_data, int width, int height,
     };
     
     filter_edge_detection_new(&temp_frame, intensity);
-    printf("🔍 Applied WASM edge detection filter (intensity: %.2f) to %dx%d frame\n", intensity, width, height);
+    LOG_FRAME("Applied edge detection filter (intensity: %.2f) to %dx%d frame", intensity, width, height);
 }
 
 // WASM Transition Functions
@@ -551,7 +555,7 @@ void js_apply_fade_transition(uint8_t* frame1_data, uint8_t* frame2_data, uint8_
     video_frame_t output = { .data = output_data, .width = width, .height = height, .format = 1, .timestamp = 0.0 };
     
     transition_fade(&frame1, &frame2, &output, progress);
-    printf("🎭 Applied WASM fade transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applied fade transition (progress: %.2f) to %dx%d frames", progress, width, height);
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -565,7 +569,7 @@ void js_apply_dissolve_transition(uint8_t* frame1_data, uint8_t* frame2_data, ui
     video_frame_t output = { .data = output_data, .width = width, .height = height, .format = 1, .timestamp = 0.0 };
     
     transition_dissolve(&frame1, &frame2, &output, progress);
-    printf("🌫️ Applied WASM dissolve transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applied dissolve transition (progress: %.2f) to %dx%d frames", progress, width, height);
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -579,7 +583,7 @@ void js_apply_wipe_left_transition(uint8_t* frame1_data, uint8_t* frame2_data, u
     video_frame_t output = { .data = output_data, .width = width, .height = height, .format = 1, .timestamp = 0.0 };
     
     transition_wipe_left(&frame1, &frame2, &output, progress);
-    printf("👈 Applied WASM wipe left transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applied wipe left transition (progress: %.2f) to %dx%d frames", progress, width, height);
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -593,7 +597,7 @@ void js_apply_wipe_right_transition(uint8_t* frame1_data, uint8_t* frame2_data,
     video_frame_t output = { .data = output_data, .width = width, .height = height, .format = 1, .timestamp = 0.0 };
     
     transition_wipe_right(&frame1, &frame2, &output, progress);
-    printf("👉 Applied WASM wipe right transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applied wipe right transition (progress: %.2f) to %dx%d frames", progress, width, height);
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -607,7 +611,7 @@ void js_apply_wipe_up_transition(uint8_t* frame1_data, uint8_t* frame2_data, uin
     video_frame_t output = { .data = output_data, .width = width, .height = height, .format = 1, .timestamp = 0.0 };
     
     transition_wipe_up(&frame1, &frame2, &output, progress);
-    printf("👆 Applied WASM wipe up transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applied wipe up transition (progress: %.2f) to %dx%d frames", progress, width, height);
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -621,5 +625,5 @@ void js_apply_wipe_down_transition(uint8_t* frame1_data, uint8_t* frame2_data, u
     video_frame_t output = { .data = output_data, .width = width, .height = height, .format = 1, .timestamp = 0.0 };
     
     transition_wipe_down(&frame1, &frame2, &output, progress);
-    printf("👇 Applied WASM wipe down transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applied wipe down transition (progress: %.2f) to %dx%d frames", progress, width, height);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "video_engine.h"
+#include "engine_trace.h"
 #include <math.h>
 
 // YUV to RGB conversion coefficients (ITU-R BT.709)
@@ -26,8 +27,11 @@ EMSCRIPTEN_KEEPALIVE
 void convert_rgb_to_yuv420(uint8_t* rgb_data, uint8_t* yuv_data, int width, int height) {
     if (!rgb_data || !yuv_data || width <= 0 || height <= 0) return;
     
+    TRACE_BEGIN(trace_convert);
+    
     int y_size = width * height;
-    int uv_size = (width / 2) * (height / 2);
+    int uv_width = (width + 1) / 2; // Odd sizes keep a chroma sample for the last column/row
+    int uv_size = uv_width * ((height + 1) / 2);
     
     uint8_t* y_plane = yuv_data;
     uint8_t* u_plane = yuv_data + y_size;
@@ -49,7 +53,7 @@ void convert_rgb_to_yuv420(uint8_t* rgb_data, uint8_t* yuv_data, int width, int
             
             // Calculate U and V components (subsampled 4:2:0)
             if ((y % 2 == 0) && (x % 2 == 0)) {
-                int uv_idx = (y / 2) * (width / 2) + (x / 2);
+                int uv_idx = (y / 2) * uv_width + (x / 2);
                 
                 float u_val = RGB_TO_YUV_MATRIX[3] * r + RGB_TO_YUV_MATRIX[4] * g + RGB_TO_YUV_MATRIX[5] * b + 128.0f;
                 float v_val = RGB_TO_YUV_MATRIX[6] * r + RGB_TO_YUV_MATRIX[7] * g + RGB_TO_YUV_MATRIX[8] * b + 128.0f;
@@ -59,14 +63,19 @@ void convert_rgb_to_yuv420(uint8_t* rgb_data, uint8_t* yuv_data, int width, int
             }
         }
     }
+    
+    TRACE_END(trace_convert, "convert", "rgb_to_yuv420", TRACE_NO_FRAME);
 }
 
 EMSCRIPTEN_KEEPALIVE
 void convert_yuv420_to_rgb(uint8_t* yuv_data, uint8_t* rgb_data, int width, int height) {
     if (!yuv_data || !rgb_data || width <= 0 || height <= 0) return;
     
+    TRACE_BEGIN(trace_convert);
+    
     int y_size = width * height;
-    int uv_size = (width / 2) * (height / 2);
+    int uv_width = (width + 1) / 2; // Odd sizes keep a chroma sample for the last column/row
+    int uv_size = uv_width * ((height + 1) / 2);
     
     uint8_t* y_plane = yuv_data;
     uint8_t* u_plane = yuv_data + y_size;
@@ -76,7 +85,7 @@ void convert_yuv420_to_rgb(uint8_t* yuv_data, uint8_t* rgb_data, int width, int
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             int y_idx = y * width + x;
-            int uv_idx = (y / 2) * (width / 2) + (x / 2);
+            int uv_idx = (y / 2) * uv_width + (x / 2);
             int rgb_idx = (y * width + x) * 3;
             
             float y_val = (float)y_plane[y_idx];
@@ -93,12 +102,16 @@ void convert_yuv420_to_rgb(uint8_t* yuv_data, uint8_t* rgb_data, int width, int
             rgb_data[rgb_idx + 2] = clamp_uint8(b_val);
         }
     }
+    
+    TRACE_END(trace_convert, "convert", "yuv420_to_rgb", TRACE_NO_FRAME);
 }
 
 EMSCRIPTEN_KEEPALIVE
 void convert_rgba_to_rgb(uint8_t* rgba_data, uint8_t* rgb_data, int width, int height) {
     if (!rgba_data || !rgb_data || width <= 0 || height <= 0) return;
     
+    TRACE_BEGIN(trace_convert);
+    
     int pixel_count = width * height;
     
     for (int i = 0; i < pixel_count; i++) {
@@ -107,12 +120,16 @@ void convert_rgba_to_rgb(uint8_t* rgba_data, uint8_t* rgb_data, int width, int h
         rgb_data[i * 3 + 2] = rgba_data[i * 4 + 2]; // B
         // Skip alpha channel
     }
+    
+    TRACE_END(trace_convert, "convert", "rgba_to_rgb", TRACE_NO_FRAME);
 }
 
 EMSCRIPTEN_KEEPALIVE
 void convert_rgb_to_rgba(uint8_t* rgb_data, uint8_t* rgba_data, int width, int height, uint8_t alpha) {
     if (!rgb_data || !rgba_data || width <= 0 || height <= 0) return;
     
+    TRACE_BEGIN(trace_convert);
+    
     int pixel_count = width * height;
     
     for (int i = 0; i < pixel_count; i++) {
@@ -121,4 +138,6 @@ void convert_rgb_to_rgba(uint8_t* rgb_data, uint8_t* rgba_data, int width, int h
         rgba_data[i * 4 + 2] = rgb_data[i * 3 + 2]; // B
         rgba_data[i * 4 + 3] = alpha;                // A
     }
+    
+    TRACE_END(trace_convert, "convert", "rgb_to_rgba", TRACE_NO_FRAME);
 }
\ No newline at end of file
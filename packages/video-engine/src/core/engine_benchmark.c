@@ -0,0 +1,265 @@
+#include "../include/engine_benchmark.h"
+#include "../include/effects_engine.h"
+#include "../include/filters.h"
+#include "../include/transitions.h"
+#include "../include/engine_time.h"
+#include "../include/string_builder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Native build of the same cases test-wasm.js runs in Node:
+//   cc -O2 -std=gnu11 -DENGINE_BENCHMARK_MAIN -Iinclude src/*/*.c -lm -lpthread -o engine_benchmark
+//   ./engine_benchmark 1920 1080 30 > native.jsonl
+//   node test-wasm.js --native native.jsonl
+
+typedef enum {
+    BENCH_COLOR_CORRECTION,
+    BENCH_BLUR,
+    BENCH_SHARPEN,
+    BENCH_NOISE_REDUCTION,
+    BENCH_TRANSFORM,
+    BENCH_SEPIA,
+    BENCH_BLACK_AND_WHITE,
+    BENCH_VINTAGE,
+    BENCH_VIGNETTE,
+    BENCH_EDGE_DETECTION,
+    BENCH_FADE,
+    BENCH_DISSOLVE,
+    BENCH_WIPE_LEFT,
+    BENCH_EFFECTS_CHAIN,
+    BENCH_CASE_COUNT
+} bench_case_t;
+
+// Keep in sync with the case table in test-wasm.js
+static const char* bench_case_names[BENCH_CASE_COUNT] = {
+    "color_correction", "blur", "sharpen", "noise_reduction", "transform",
+    "sepia", "black_and_white", "vintage", "vignette", "edge_detection",
+    "fade", "dissolve", "wipe_left", "effects_chain"
+};
+
+typedef struct bench_state_t {
+    video_frame_t frame;
+    video_frame_t other;
+    video_frame_t output;
+    effects_engine_t* engine;
+} bench_state_t;
+
+static void fill_frame(uint8_t* data, size_t size, uint32_t seed) {
+    uint32_t state = seed;
+    for (size_t i = 0; i < size; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        data[i] = (uint8_t)state;
+    }
+}
+
+// Effects chain matching the JS runner: color correction, blur, sharpen
+static effects_engine_t* create_chain_engine(void) {
+    effects_engine_t* engine = effects_engine_create();
+    if (!engine) return NULL;
+
+    if (!effects_engine_init(engine)) {
+        effects_engine_destroy(engine);
+        return NULL;
+    }
+
+    effect_t* effects[3] = {
+        effect_create_color_correction(0.1f, 0.2f, 0.1f, 0.0f),
+        effect_create_blur(2.0f, false),
+        effect_create_filter(FILTER_SHARPEN, 0.5f)
+    };
+    for (int i = 0; i < 3; i++) {
+        if (effects[i]) {
+            effect_chain_add(engine->chain, effects[i]);
+            free(effects[i]); // Chain makes a copy
+        }
+    }
+    return engine;
+}
+
+static void run_case(bench_case_t index, bench_state_t* state) {
+    video_frame_t* frame = &state->frame;
+
+    switch (index) {
+        case BENCH_COLOR_CORRECTION: {
+            color_correction_t params = {0.1f, 0.2f, 0.1f, 10.0f, 1.0f, 0.0f};
+            filter_color_correction(frame, &params);
+            break;
+        }
+        case BENCH_BLUR: {
+            blur_params_t params = {.radius = 3.0f, .iterations = 1, .gaussian = false};
+            filter_blur(frame, &params);
+            break;
+        }
+        case BENCH_SHARPEN: filter_sharpen(frame, 0.5f); break;
+        case BENCH_NOISE_REDUCTION: {
+            blur_params_t params = {.radius = 1.0f, .iterations = 1, .gaussian = true}; // As js_apply_noise_reduction(0.5)
+            filter_blur(frame, &params);
+            break;
+        }
+        case BENCH_TRANSFORM: {
+            transform_params_t params = {
+                .scale = 110.0f, .rotation = 15.0f,
+                .crop_width = 100, .crop_height = 100
+            };
+            filter_transform(frame, &params);
+            break;
+        }
+        case BENCH_SEPIA: filter_sepia(frame, 0.8f); break;
+        case BENCH_BLACK_AND_WHITE: filter_black_and_white(frame, 0.8f); break;
+        case BENCH_VINTAGE: filter_vintage(frame, 0.8f); break;
+        case BENCH_VIGNETTE: filter_vignette(frame, 0.8f); break;
+        case BENCH_EDGE_DETECTION: filter_edge_detection_new(frame, 0.8f); break;
+        case BENCH_FADE: transition_fade(frame, &state->other, &state->output, 0.5f); break;
+        case BENCH_DISSOLVE: transition_dissolve(frame, &state->other, &state->output, 0.5f); break;
+        case BENCH_WIPE_LEFT: transition_wipe_left(frame, &state->other, &state->output, 0.5f); break;
+        case BENCH_EFFECTS_CHAIN: effects_process_frame(state->engine, frame, 0.0); break;
+        default: break;
+    }
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int engine_benchmark_case_count(void) {
+    return BENCH_CASE_COUNT;
+}
+
+const char* engine_benchmark_case_name(int index) {
+    if (index < 0 || index >= BENCH_CASE_COUNT) return NULL;
+    return bench_case_names[index];
+}
+
+bool engine_benchmark_run(int index, int width, int height, int iterations,
+                          engine_benchmark_result_t* result) {
+    if (index < 0 || index >= BENCH_CASE_COUNT || width <= 0 || height <= 0 ||
+        iterations <= 0 || !result) return false;
+
+    size_t frame_size = (size_t)width * height * 4;
+    uint8_t* buffer = malloc(frame_size * 4);
+    double* samples = malloc(sizeof(double) * iterations);
+    bench_state_t state;
+    memset(&state, 0, sizeof(state));
+
+    if (index == BENCH_EFFECTS_CHAIN) state.engine = create_chain_engine();
+
+    if (!buffer || !samples || (index == BENCH_EFFECTS_CHAIN && !state.engine)) {
+        free(buffer);
+        free(samples);
+        if (state.engine) {
+            effects_engine_cleanup(state.engine);
+            effects_engine_destroy(state.engine);
+        }
+        return false;
+    }
+
+    // Pristine source, working frame, second transition input, output
+    uint8_t* source = buffer;
+    video_frame_t template = {NULL, width, height, width * 4, 1, 0.0, 0};
+    state.frame = template;
+    state.other = template;
+    state.output = template;
+    state.frame.data = buffer + frame_size;
+    state.other.data = buffer + 2 * frame_size;
+    state.output.data = buffer + 3 * frame_size;
+    fill_frame(source, frame_size, 0x9E3779B9u);
+    fill_frame(state.other.data, frame_size, 0x85EBCA6Bu);
+
+    // One untimed warm-up run sizes scratch buffers and pools
+    memcpy(state.frame.data, source, frame_size);
+    run_case((bench_case_t)index, &state);
+
+    double total = 0.0;
+    for (int i = 0; i < iterations; i++) {
+        memcpy(state.frame.data, source, frame_size);
+        uint64_t start = engine_time_ns();
+        run_case((bench_case_t)index, &state);
+        samples[i] = (engine_time_ns() - start) / 1e6;
+        total += samples[i];
+    }
+    qsort(samples, iterations, sizeof(double), compare_double);
+
+    result->name = bench_case_names[index];
+    result->width = width;
+    result->height = height;
+    result->iterations = iterations;
+    result->min_ms = samples[0];
+    result->median_ms = samples[iterations / 2];
+    result->mean_ms = total / iterations;
+    result->fps = result->median_ms > 0.0 ? 1000.0 / result->median_ms : 0.0;
+    result->mpix_per_s = result->median_ms > 0.0 ? (double)width * height / (result->median_ms * 1000.0) : 0.0;
+
+    if (state.engine) {
+        effects_engine_cleanup(state.engine);
+        effects_engine_destroy(state.engine);
+    }
+    free(samples);
+    free(buffer);
+    return true;
+}
+
+char* engine_benchmark_report(const char* runtime, int width, int height, int iterations) {
+    string_builder_t report;
+    if (!string_builder_init(&report, 2048)) return NULL;
+
+    for (int i = 0; i < BENCH_CASE_COUNT; i++) {
+        engine_benchmark_result_t result;
+        if (!engine_benchmark_run(i, width, height, iterations, &result)) continue;
+
+        string_builder_append(&report,
+            "{\"runtime\":\"%s\",\"case\":\"%s\",\"width\":%d,\"height\":%d,\"iterations\":%d,"
+            "\"min_ms\":%.4f,\"median_ms\":%.4f,\"mean_ms\":%.4f,\"fps\":%.2f,\"mpix_per_s\":%.2f}\n",
+            runtime ? runtime : "native", result.name, result.width, result.height, result.iterations,
+            result.min_ms, result.median_ms, result.mean_ms, result.fps, result.mpix_per_s);
+    }
+
+    return string_builder_finish(&report, NULL);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+EMSCRIPTEN_KEEPALIVE
+int js_engine_benchmark_case_count(void) {
+    return engine_benchmark_case_count();
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* js_engine_benchmark_case_name(int index) {
+    return engine_benchmark_case_name(index);
+}
+
+// Time one case inside WASM (no marshalling); see engine_benchmark.h for layout
+EMSCRIPTEN_KEEPALIVE
+const double* js_engine_benchmark_run(int index, int width, int height, int iterations) {
+    static double js_result[4];
+    engine_benchmark_result_t result;
+    if (!engine_benchmark_run(index, width, height, iterations, &result)) return NULL;
+
+    js_result[0] = result.min_ms;
+    js_result[1] = result.median_ms;
+    js_result[2] = result.mean_ms;
+    js_result[3] = result.iterations;
+    return js_result;
+}
+
+#ifdef ENGINE_BENCHMARK_MAIN
+int main(int argc, char** argv) {
+    int width = argc > 1 ? atoi(argv[1]) : 1920;
+    int height = argc > 2 ? atoi(argv[2]) : 1080;
+    int iterations = argc > 3 ? atoi(argv[3]) : 30;
+
+    char* report = engine_benchmark_report("native", width, height, iterations);
+    if (!report) return 1;
+
+    fputs(report, stdout);
+    free(report);
+    return 0;
+}
+#endif
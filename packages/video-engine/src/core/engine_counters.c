@@ -0,0 +1,156 @@
+#include "../include/engine_counters.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNTER_NAME_SIZE 40
+
+_Static_assert(sizeof(engine_counters_t) == ENGINE_COUNTERS_TOTAL * sizeof(uint64_t),
+               "engine_counters_t must be a flat array of counters");
+
+_Thread_local engine_counters_t engine_counters_pending;
+
+// Shared registry. Publishers serialize on `writer` and bump `sequence` to
+// odd while folding a batch in; readers retry until they copy between two
+// equal even sequence values.
+static _Atomic uint64_t registry[ENGINE_COUNTERS_TOTAL];
+static _Atomic uint32_t sequence = 0;
+static atomic_flag writer = ATOMIC_FLAG_INIT;
+
+static const char* counter_names[ENGINE_COUNTER_COUNT] = {
+    "frames", "chain_copy_bytes", "scratch_copy_bytes", "heap_allocs",
+    "heap_alloc_bytes", "pool_allocs", "pool_exhausted", "frame_cache_hits",
+    "frame_cache_misses", "lut_rebuilds", "result_cache_hits", "result_cache_misses",
+    "disk_cache_hits", "disk_cache_writes", "disk_cache_dropped", "plan_builds"
+};
+
+static char kernel_names[2 * EFFECT_COST_COUNT][COUNTER_NAME_SIZE];
+static _Atomic int kernel_names_state = 0; // 0 = unset, 1 = building, 2 = ready
+
+static void write_begin(void) {
+    while (atomic_flag_test_and_set_explicit(&writer, memory_order_acquire)) {
+        // Publishing is a few dozen adds; spin
+    }
+    atomic_fetch_add_explicit(&sequence, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void write_end(void) {
+    atomic_fetch_add_explicit(&sequence, 1, memory_order_release);
+    atomic_flag_clear_explicit(&writer, memory_order_release);
+}
+
+void engine_counters_publish(void) {
+    const uint64_t* pending = (const uint64_t*)&engine_counters_pending;
+
+    bool any = false;
+    for (int i = 0; i < ENGINE_COUNTERS_TOTAL; i++) {
+        if (pending[i]) {
+            any = true;
+            break;
+        }
+    }
+    if (!any) return;
+
+    write_begin();
+    for (int i = 0; i < ENGINE_COUNTERS_TOTAL; i++) {
+        if (!pending[i]) continue;
+        uint64_t value = atomic_load_explicit(&registry[i], memory_order_relaxed);
+        atomic_store_explicit(&registry[i], value + pending[i], memory_order_relaxed);
+    }
+    write_end();
+
+    memset(&engine_counters_pending, 0, sizeof(engine_counters_pending));
+}
+
+void engine_counters_snapshot(engine_counters_t* out) {
+    if (!out) return;
+
+    engine_counters_publish();
+
+    uint64_t* values = (uint64_t*)out;
+    for (;;) {
+        uint32_t before = atomic_load_explicit(&sequence, memory_order_acquire);
+        if (before & 1) continue;
+
+        for (int i = 0; i < ENGINE_COUNTERS_TOTAL; i++) {
+            values[i] = atomic_load_explicit(&registry[i], memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&sequence, memory_order_relaxed) == before) break;
+    }
+}
+
+// Zero the registry. Batches still pending on other threads land afterwards.
+void engine_counters_reset(void) {
+    memset(&engine_counters_pending, 0, sizeof(engine_counters_pending));
+
+    write_begin();
+    for (int i = 0; i < ENGINE_COUNTERS_TOTAL; i++) {
+        atomic_store_explicit(&registry[i], 0, memory_order_relaxed);
+    }
+    write_end();
+}
+
+static void build_kernel_names(void) {
+    int expected = 0;
+    if (atomic_compare_exchange_strong(&kernel_names_state, &expected, 1)) {
+        for (int kind = 0; kind < EFFECT_COST_COUNT; kind++) {
+            const char* name = effect_cost_kind_name((effect_cost_kind_t)kind);
+            snprintf(kernel_names[kind], COUNTER_NAME_SIZE, "bytes_read:%s", name);
+            snprintf(kernel_names[EFFECT_COST_COUNT + kind], COUNTER_NAME_SIZE, "bytes_written:%s", name);
+        }
+        atomic_store_explicit(&kernel_names_state, 2, memory_order_release);
+        return;
+    }
+
+    while (atomic_load_explicit(&kernel_names_state, memory_order_acquire) != 2) {
+        // Another thread is filling the table
+    }
+}
+
+const char* engine_counter_name(int index) {
+    if (index < 0 || index >= ENGINE_COUNTERS_TOTAL) return NULL;
+    if (index < ENGINE_COUNTER_COUNT) return counter_names[index];
+
+    build_kernel_names();
+    return kernel_names[index - ENGINE_COUNTER_COUNT];
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Snapshot as ENGINE_COUNTERS_TOTAL doubles (exact below 2^53), in
+// engine_counter_name order. The buffer is reused by the next call.
+EMSCRIPTEN_KEEPALIVE
+const double* js_engine_counters_snapshot(void) {
+    static double js_counters[ENGINE_COUNTERS_TOTAL];
+    engine_counters_t snapshot;
+    engine_counters_snapshot(&snapshot);
+
+    const uint64_t* values = (const uint64_t*)&snapshot;
+    for (int i = 0; i < ENGINE_COUNTERS_TOTAL; i++) {
+        js_counters[i] = (double)values[i];
+    }
+    return js_counters;
+}
+
+// Number of doubles in a snapshot
+EMSCRIPTEN_KEEPALIVE
+int js_engine_counters_count(void) {
+    return ENGINE_COUNTERS_TOTAL;
+}
+
+// Counter name as a static C string (0 for an invalid index)
+EMSCRIPTEN_KEEPALIVE
+const char* js_engine_counter_name(int index) {
+    return engine_counter_name(index);
+}
+
+// Zero all counters
+EMSCRIPTEN_KEEPALIVE
+void js_engine_counters_reset(void) {
+    engine_counters_reset();
+}
@@ -0,0 +1,228 @@
+#include "../include/engine_log.h"
+#include "../include/engine_time.h"
+#include "../include/string_builder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_RING_MASK (ENGINE_LOG_RING_SIZE - 1)
+
+typedef struct log_record_t {
+    uint64_t timestamp_ns;
+    const char* format;
+    int level;
+    int arg_count;
+    log_arg_t args[ENGINE_LOG_MAX_ARGS]; // String args hold an offset into text
+    char text[ENGINE_LOG_TEXT_SIZE];
+} log_record_t;
+
+// Per-slot sequence: 2 * ticket + 1 while being written, 2 * ticket + 2 once
+// complete, so the reader can tell finished, in-progress and lapped slots apart
+typedef struct log_slot_t {
+    _Atomic uint64_t sequence;
+    log_record_t record;
+} log_slot_t;
+
+_Atomic int engine_log_level = ENGINE_LOG_DEFAULT_LEVEL;
+
+// Records at or below this level are also printed immediately
+static _Atomic int echo_level = LOG_LEVEL_ERROR;
+
+static log_slot_t log_ring[ENGINE_LOG_RING_SIZE];
+static _Atomic uint64_t log_head = 0; // Next ticket, shared by producers
+static uint64_t log_tail = 0;         // Next ticket to drain, reader only
+static uint64_t log_dropped = 0;      // Reader only
+
+static const char* level_names[] = { "ERROR", "WARN", "INFO", "DEBUG", "FRAME" };
+
+void engine_log_set_level(int level) {
+    atomic_store_explicit(&engine_log_level, level, memory_order_relaxed);
+}
+
+void engine_log_set_echo_level(int level) {
+    atomic_store_explicit(&echo_level, level, memory_order_relaxed);
+}
+
+// Render a record's message. The format is re-parsed here, with each
+// conversion widened to match the captured argument.
+static void format_record(string_builder_t* out, const log_record_t* record) {
+    const char* p = record->format;
+    int arg = 0;
+
+    while (*p) {
+        const char* next = strchr(p, '%');
+        if (!next) {
+            string_builder_append(out, "%s", p);
+            break;
+        }
+
+        string_builder_append(out, "%.*s", (int)(next - p), p);
+        p = next + 1;
+
+        if (*p == '%') {
+            string_builder_append(out, "%%");
+            p++;
+            continue;
+        }
+
+        // Flags, width and precision are kept; length modifiers are replaced
+        char spec[32] = "%";
+        size_t n = 1;
+        while (*p && strchr("-+ #0123456789.", *p) && n < sizeof(spec) - 4) spec[n++] = *p++;
+        while (*p && strchr("hlLqjzt", *p)) p++;
+        char conversion = *p ? *p++ : 's';
+
+        if (arg >= record->arg_count) {
+            string_builder_append(out, "<?>");
+            continue;
+        }
+        const log_arg_t* a = &record->args[arg++];
+
+        if (strchr("fFeEgGaA", conversion)) {
+            spec[n++] = conversion;
+            spec[n] = '\0';
+            double value = a->type == LOG_ARG_DOUBLE ? a->value.d :
+                           a->type == LOG_ARG_UINT ? (double)a->value.u : (double)a->value.i;
+            string_builder_append(out, spec, value);
+        } else if (conversion == 's') {
+            spec[n++] = 's';
+            spec[n] = '\0';
+            string_builder_append(out, spec, a->type == LOG_ARG_STRING ? record->text + a->value.u : "<?>");
+        } else if (strchr("uxXoc", conversion)) {
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = conversion == 'c' ? 'u' : conversion;
+            spec[n] = '\0';
+            unsigned long long value = a->type == LOG_ARG_DOUBLE ? (unsigned long long)a->value.d : a->value.u;
+            string_builder_append(out, spec, value);
+        } else {
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = 'd';
+            spec[n] = '\0';
+            long long value = a->type == LOG_ARG_DOUBLE ? (long long)a->value.d : a->value.i;
+            string_builder_append(out, spec, value);
+        }
+    }
+}
+
+static void format_line(string_builder_t* out, const log_record_t* record) {
+    int level = record->level;
+    const char* name = (level >= 0 && level <= LOG_LEVEL_FRAME) ? level_names[level] : "LOG";
+
+    string_builder_append(out, "[%.3f ms] %-5s ", record->timestamp_ns / 1e6, name);
+    format_record(out, record);
+    string_builder_append(out, "\n");
+}
+
+// Append a record to the ring (any thread, lock-free)
+void engine_log_write(int level, const char* format, const log_arg_t* args, int arg_count) {
+    if (!format) return;
+    if (arg_count > ENGINE_LOG_MAX_ARGS) arg_count = ENGINE_LOG_MAX_ARGS;
+
+    uint64_t ticket = atomic_fetch_add_explicit(&log_head, 1, memory_order_relaxed);
+    log_slot_t* slot = &log_ring[ticket & LOG_RING_MASK];
+
+    atomic_store_explicit(&slot->sequence, ticket * 2 + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    log_record_t* record = &slot->record;
+    record->timestamp_ns = engine_time_ns();
+    record->format = format;
+    record->level = level;
+    record->arg_count = arg_count;
+    if (arg_count > 0) memcpy(record->args, args, sizeof(log_arg_t) * arg_count);
+
+    // Strings may not outlive the call: copy them into the record
+    size_t text_used = 0;
+    for (int i = 0; i < arg_count; i++) {
+        if (record->args[i].type != LOG_ARG_STRING) continue;
+
+        const char* value = record->args[i].value.s ? record->args[i].value.s : "(null)";
+        size_t room = sizeof(record->text) - text_used;
+        if (room == 0) {
+            record->args[i].value.u = sizeof(record->text) - 1; // Full: empty string
+            continue;
+        }
+
+        size_t length = strnlen(value, room - 1);
+        memcpy(record->text + text_used, value, length);
+        record->text[text_used + length] = '\0';
+        record->args[i].value.u = text_used;
+        text_used += length + 1;
+    }
+
+    atomic_store_explicit(&slot->sequence, ticket * 2 + 2, memory_order_release);
+
+    // Rare (errors by default): format synchronously so they are never missed
+    if (level <= atomic_load_explicit(&echo_level, memory_order_relaxed)) {
+        string_builder_t line;
+        if (string_builder_init(&line, 256)) {
+            format_line(&line, record);
+            char* text = string_builder_finish(&line, NULL);
+            if (text) {
+                fputs(text, stderr);
+                free(text);
+            }
+        }
+    }
+}
+
+char* engine_log_drain(size_t* length) {
+    string_builder_t out;
+    if (!string_builder_init(&out, 4096)) return NULL;
+
+    uint64_t head = atomic_load_explicit(&log_head, memory_order_acquire);
+    if (head - log_tail > ENGINE_LOG_RING_SIZE) {
+        log_dropped += head - log_tail - ENGINE_LOG_RING_SIZE;
+        log_tail = head - ENGINE_LOG_RING_SIZE;
+    }
+
+    while (log_tail != head) {
+        log_slot_t* slot = &log_ring[log_tail & LOG_RING_MASK];
+        uint64_t expected = log_tail * 2 + 2;
+
+        uint64_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (before < expected) break; // Still being written: pick it up next time
+
+        log_record_t record = slot->record;
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+        if (before != expected || after != expected) {
+            log_dropped++; // Lapped by producers while we read it
+        } else {
+            format_line(&out, &record);
+        }
+        log_tail++;
+    }
+
+    if (log_dropped > 0) {
+        string_builder_append(&out, "[log] %llu records dropped\n", (unsigned long long)log_dropped);
+        log_dropped = 0;
+    }
+
+    return string_builder_finish(&out, length);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Set runtime log level (LOG_LEVEL_FRAME enables per-frame logs)
+EMSCRIPTEN_KEEPALIVE
+void js_engine_log_set_level(int level) {
+    engine_log_set_level(level);
+}
+
+// Set level at or below which records are also printed immediately
+EMSCRIPTEN_KEEPALIVE
+void js_engine_log_set_echo_level(int level) {
+    engine_log_set_echo_level(level);
+}
+
+// Pending log lines as a C string (0 on failure); free it with js_free
+EMSCRIPTEN_KEEPALIVE
+char* js_engine_log_drain(void) {
+    return engine_log_drain(NULL);
+}
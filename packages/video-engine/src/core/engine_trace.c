@@ -0,0 +1,218 @@
+#include "../include/engine_trace.h"
+#include "../include/string_builder.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_BUFFER_MASK (TRACE_BUFFER_EVENTS - 1)
+#define TRACE_THREAD_NAME_SIZE 32
+
+typedef struct trace_buffer_t {
+    _Atomic uint32_t head;   // Events ever written; only the owner thread writes
+    _Atomic bool owned;      // Cleared when the owner exits; a new thread may take the ring
+    _Atomic uint32_t owner_head; // Events before this belong to a previous owner
+    int tid;
+    char thread_name[TRACE_THREAD_NAME_SIZE];
+    trace_event_t events[TRACE_BUFFER_EVENTS];
+} trace_buffer_t;
+
+// Per-thread rings. A ring is handed back when its thread exits and reused
+// by the next thread that traces, so the registry caps live threads at
+// TRACE_MAX_THREADS rather than thread lifetimes. Rings are never freed.
+static trace_buffer_t* _Atomic buffers[TRACE_MAX_THREADS];
+static _Atomic int buffer_count = 0;
+static _Atomic int next_tid = 1;
+static _Atomic uint32_t releases = 0;  // Rings handed back so far
+static _Atomic bool trace_enabled = false;
+static _Atomic uint64_t cleared_at_ns = 0;
+
+static pthread_once_t exit_hook_once = PTHREAD_ONCE_INIT;
+static pthread_key_t exit_hook;
+
+// Calling thread's ring; while the registry is full, the release count seen
+// at the last failed attempt (retried once a ring has been handed back)
+static _Thread_local trace_buffer_t* local_buffer = NULL;
+static _Thread_local bool registry_full = false;
+static _Thread_local uint32_t full_at_releases = 0;
+
+// Thread exit: the ring keeps its events for dumps until a new owner takes it
+static void release_buffer(void* value) {
+    trace_buffer_t* buffer = value;
+    atomic_store_explicit(&buffer->owned, false, memory_order_release);
+    atomic_fetch_add(&releases, 1);
+}
+
+static void create_exit_hook(void) {
+    pthread_key_create(&exit_hook, release_buffer);
+}
+
+static void claim_buffer(trace_buffer_t* buffer) {
+    atomic_store(&buffer->owner_head, atomic_load(&buffer->head));
+    buffer->tid = atomic_fetch_add(&next_tid, 1);
+    snprintf(buffer->thread_name, sizeof(buffer->thread_name), "thread %d", buffer->tid);
+
+    pthread_once(&exit_hook_once, create_exit_hook);
+    pthread_setspecific(exit_hook, buffer);
+    local_buffer = buffer;
+}
+
+static trace_buffer_t* thread_buffer(void) {
+    if (local_buffer) return local_buffer;
+    if (registry_full && atomic_load(&releases) == full_at_releases) return NULL;
+
+    // Reuse the ring of a thread that has exited
+    uint32_t seen_releases = atomic_load(&releases);
+    int count = atomic_load(&buffer_count);
+    if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+    for (int i = 0; i < count; i++) {
+        trace_buffer_t* buffer = atomic_load(&buffers[i]);
+        bool expected = false;
+        if (buffer && atomic_compare_exchange_strong(&buffer->owned, &expected, true)) {
+            claim_buffer(buffer);
+            registry_full = false;
+            return buffer;
+        }
+    }
+
+    trace_buffer_t* buffer = calloc(1, sizeof(trace_buffer_t));
+    if (!buffer) return NULL;
+
+    int index = atomic_fetch_add(&buffer_count, 1);
+    if (index >= TRACE_MAX_THREADS) {
+        atomic_fetch_sub(&buffer_count, 1);
+        free(buffer);
+        registry_full = true;
+        full_at_releases = seen_releases;
+        return NULL;
+    }
+
+    atomic_init(&buffer->head, 0);
+    atomic_init(&buffer->owner_head, 0);
+    atomic_init(&buffer->owned, true);
+    claim_buffer(buffer);
+    atomic_store(&buffers[index], buffer);
+    registry_full = false;
+    return buffer;
+}
+
+void engine_trace_enable(bool enabled) {
+    atomic_store_explicit(&trace_enabled, enabled, memory_order_relaxed);
+}
+
+bool engine_trace_enabled(void) {
+    return atomic_load_explicit(&trace_enabled, memory_order_relaxed);
+}
+
+// Drop everything recorded so far (rings are left to their owners; older
+// events are simply filtered out of later dumps)
+void engine_trace_clear(void) {
+    atomic_store(&cleared_at_ns, engine_time_ns());
+}
+
+// Label the calling thread in the timeline
+void engine_trace_set_thread_name(const char* name) {
+    trace_buffer_t* buffer = thread_buffer();
+    if (!buffer || !name) return;
+
+    strncpy(buffer->thread_name, name, sizeof(buffer->thread_name) - 1);
+    buffer->thread_name[sizeof(buffer->thread_name) - 1] = '\0';
+}
+
+// Start of a scope; 0 when tracing is off
+uint64_t engine_trace_begin(void) {
+    return engine_trace_enabled() ? engine_time_ns() : 0;
+}
+
+// Close a scope opened with engine_trace_begin
+void engine_trace_end(const char* category, const char* name, uint64_t start_ns, int frame_number) {
+    if (start_ns == 0 || !engine_trace_enabled()) return;
+
+    trace_buffer_t* buffer = thread_buffer();
+    if (!buffer) return;
+
+    uint32_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    trace_event_t* event = &buffer->events[head & TRACE_BUFFER_MASK];
+    event->category = category;
+    event->name = name;
+    event->start_ns = start_ns;
+    event->duration_ns = engine_time_ns() - start_ns;
+    event->frame_number = frame_number;
+
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+char* engine_trace_dump_json(size_t* length) {
+    string_builder_t json;
+    if (!string_builder_init(&json, 64 * 1024)) return NULL;
+
+    uint64_t cleared = atomic_load(&cleared_at_ns);
+    int count = atomic_load(&buffer_count);
+    if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+    bool first = true;
+
+    string_builder_append(&json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (int b = 0; b < count; b++) {
+        trace_buffer_t* buffer = atomic_load(&buffers[b]);
+        if (!buffer) continue;
+
+        string_builder_append(&json, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                    first ? "" : ",", buffer->tid);
+        string_builder_append_json_string(&json, buffer->thread_name);
+        string_builder_append(&json, "}}");
+        first = false;
+
+        uint32_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        uint32_t begin = head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0;
+        uint32_t owner_head = atomic_load(&buffer->owner_head);
+        if (head - begin > head - owner_head) begin = owner_head;
+
+        for (uint32_t i = begin; i != head; i++) {
+            trace_event_t event = buffer->events[i & TRACE_BUFFER_MASK];
+
+            // The owner may have lapped us while we copied: skip torn events
+            uint32_t now_head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+            if (now_head - i > TRACE_BUFFER_EVENTS) continue;
+            if (event.start_ns < cleared || !event.name) continue;
+
+            string_builder_append(&json, ",{\"name\":");
+            string_builder_append_json_string(&json, event.name);
+            string_builder_append(&json, ",\"cat\":");
+            string_builder_append_json_string(&json, event.category ? event.category : "engine");
+            string_builder_append(&json, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d",
+                        event.start_ns / 1000.0, event.duration_ns / 1000.0, buffer->tid);
+            if (event.frame_number != TRACE_NO_FRAME) {
+                string_builder_append(&json, ",\"args\":{\"frame\":%d}", event.frame_number);
+            }
+            string_builder_append(&json, "}");
+        }
+    }
+
+    string_builder_append(&json, "]}");
+
+    return string_builder_finish(&json, length);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Turn recording on or off
+EMSCRIPTEN_KEEPALIVE
+void js_engine_trace_enable(int enabled) {
+    engine_trace_enable(enabled != 0);
+}
+
+// Discard recorded events
+EMSCRIPTEN_KEEPALIVE
+void js_engine_trace_clear(void) {
+    engine_trace_clear();
+}
+
+// Trace JSON as a C string (0 on failure); free it with js_free
+EMSCRIPTEN_KEEPALIVE
+char* js_engine_trace_dump(void) {
+    return engine_trace_dump_json(NULL);
+}
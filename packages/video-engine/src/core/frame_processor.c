@@ -1,4 +1,5 @@
 #include "video_engine.h"
+#include "engine_counters.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -63,6 +64,7 @@ void video_frame_resize(video_frame_t* src, video_frame_t* dst, int new_width, i
     if (!dst->data) {
         dst->data = (uint8_t*)malloc(new_width * new_height * 4); // RGBA
         if (!dst->data) return;
+        engine_counter_alloc(new_width * new_height * 4);
     }
     
     dst->width = new_width;
@@ -89,6 +91,111 @@ void video_frame_resize(video_frame_t* src, video_frame_t* dst, int new_width, i
     }
 }
 
+// Downscale by an integer factor, averaging each factor x factor block.
+// Unlike point/bilinear sampling this does not alias. dst->data must hold
+// ceil(width / factor) * ceil(height / factor) pixels.
+void video_frame_downscale_area(video_frame_t* src, video_frame_t* dst, int factor) {
+    if (!src || !dst || !src->data || !dst->data || factor < 1) return;
+    
+    int new_width = (src->width + factor - 1) / factor;
+    int new_height = (src->height + factor - 1) / factor;
+    
+    dst->width = new_width;
+    dst->height = new_height;
+    dst->stride = new_width * 4;
+    dst->format = src->format;
+    dst->timestamp = src->timestamp;
+    dst->frame_number = src->frame_number;
+    
+    uint8_t* src_data = src->data;
+    uint8_t* dst_data = dst->data;
+    
+    for (int y = 0; y < new_height; y++) {
+        int y0 = y * factor;
+        int y1 = y0 + factor > src->height ? src->height : y0 + factor;
+        
+        for (int x = 0; x < new_width; x++) {
+            int x0 = x * factor;
+            int x1 = x0 + factor > src->width ? src->width : x0 + factor;
+            
+            uint32_t sum[4] = {0, 0, 0, 0};
+            for (int sy = y0; sy < y1; sy++) {
+                uint8_t* row = src_data + ((size_t)sy * src->width + x0) * 4;
+                for (int sx = x0; sx < x1; sx++, row += 4) {
+                    sum[0] += row[0];
+                    sum[1] += row[1];
+                    sum[2] += row[2];
+                    sum[3] += row[3];
+                }
+            }
+            
+            uint32_t count = (uint32_t)((y1 - y0) * (x1 - x0));
+            uint8_t* out = dst_data + ((size_t)y * new_width + x) * 4;
+            for (int c = 0; c < 4; c++) {
+                out[c] = (uint8_t)((sum[c] + count / 2) / count);
+            }
+        }
+    }
+}
+
+// Bilinear upscale of a proxy frame into dst (dst->data must hold
+// new_width * new_height pixels). Fixed-point weights and precomputed column
+// taps make this several times cheaper than video_frame_resize.
+void video_frame_upscale(video_frame_t* src, video_frame_t* dst, int new_width, int new_height) {
+    if (!src || !dst || !src->data || !dst->data || new_width <= 0 || new_height <= 0) return;
+    
+    int* x0_tab = (int*)malloc(new_width * 2 * sizeof(int));
+    if (!x0_tab) return;
+    engine_counter_alloc(new_width * 2 * sizeof(int));
+    int* fx_tab = x0_tab + new_width;
+    
+    int src_width = src->width;
+    int src_height = src->height;
+    
+    // Pixel-center aligned source positions in 8.8 fixed point
+    for (int x = 0; x < new_width; x++) {
+        int pos = (int)(((x + 0.5f) * src_width / new_width - 0.5f) * 256.0f);
+        if (pos < 0) pos = 0;
+        if (pos > (src_width - 1) * 256) pos = (src_width - 1) * 256;
+        x0_tab[x] = pos >> 8;
+        fx_tab[x] = pos & 0xFF;
+    }
+    
+    dst->width = new_width;
+    dst->height = new_height;
+    dst->stride = new_width * 4;
+    dst->format = src->format;
+    dst->timestamp = src->timestamp;
+    dst->frame_number = src->frame_number;
+    
+    for (int y = 0; y < new_height; y++) {
+        int pos = (int)(((y + 0.5f) * src_height / new_height - 0.5f) * 256.0f);
+        if (pos < 0) pos = 0;
+        if (pos > (src_height - 1) * 256) pos = (src_height - 1) * 256;
+        int y0 = pos >> 8;
+        int y1 = y0 + 1 < src_height ? y0 + 1 : y0;
+        int fy = pos & 0xFF;
+        
+        uint8_t* row0 = src->data + (size_t)y0 * src_width * 4;
+        uint8_t* row1 = src->data + (size_t)y1 * src_width * 4;
+        uint8_t* out = dst->data + (size_t)y * new_width * 4;
+        
+        for (int x = 0; x < new_width; x++, out += 4) {
+            int x0 = x0_tab[x];
+            int x1 = x0 + 1 < src_width ? x0 + 1 : x0;
+            int fx = fx_tab[x];
+            
+            for (int c = 0; c < 4; c++) {
+                int top = row0[x0 * 4 + c] * (256 - fx) + row0[x1 * 4 + c] * fx;
+                int bottom = row1[x0 * 4 + c] * (256 - fx) + row1[x1 * 4 + c] * fx;
+                out[c] = (uint8_t)((top * (256 - fy) + bottom * fy + 32768) >> 16);
+            }
+        }
+    }
+    
+    free(x0_tab);
+}
+
 void video_frame_crop(video_frame_t* src, video_frame_t* dst, int x, int y, int width, int height) {
     if (!src || !dst || !src->data || x < 0 || y < 0 || 
         x + width > src->width || y + height > src->height) return;
@@ -97,6 +204,7 @@ void video_frame_crop(video_frame_t* src, video_frame_t* dst, int x, int y, int
     if (!dst->data) {
         dst->data = (uint8_t*)malloc(width * height * 4); // RGBA
         if (!dst->data) return;
+        engine_counter_alloc(width * height * 4);
     }
     
     dst->width = width;
@@ -127,6 +235,7 @@ void video_frame_convert_rgb_to_rgba(video_frame_t* src, video_frame_t* dst) {
     if (!dst->data) {
         dst->data = (uint8_t*)malloc(pixel_count * 4); // RGBA
         if (!dst->data) return;
+        engine_counter_alloc(pixel_count * 4);
     }
     
     dst->width = src->width;
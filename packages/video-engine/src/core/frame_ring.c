@@ -0,0 +1,206 @@
+#include "../include/frame_ring.h"
+#include "../include/handle_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Create a ring with capacity slots of width x height RGBA frames
+frame_ring_t* frame_ring_create(int capacity, int width, int height) {
+    if (capacity <= 0 || capacity > FRAME_RING_MAX_SLOTS || width <= 0 || height <= 0) {
+        return NULL;
+    }
+
+    // Round capacity up to a power of two so indices can be masked
+    uint32_t slots = 1;
+    while (slots < (uint32_t)capacity) slots <<= 1;
+
+    frame_ring_t* ring = malloc(sizeof(frame_ring_t));
+    if (!ring) return NULL;
+
+    memset(ring, 0, sizeof(frame_ring_t));
+
+    ring->capacity = slots;
+    ring->mask = slots - 1;
+    ring->slot_size = (size_t)width * height * 4;
+    ring->buffer = malloc(ring->slot_size * slots);
+    if (!ring->buffer) {
+        free(ring);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < slots; i++) {
+        ring->slots[i].data = ring->buffer + i * ring->slot_size;
+        ring->slots[i].width = width;
+        ring->slots[i].height = height;
+    }
+
+    atomic_init(&ring->write_index, 0);
+    atomic_init(&ring->process_index, 0);
+    atomic_init(&ring->read_index, 0);
+
+    return ring;
+}
+
+// Destroy ring; no stage may be using it any more
+void frame_ring_destroy(frame_ring_t* ring) {
+    if (!ring) return;
+
+    free(ring->buffer);
+    free(ring);
+}
+
+// Producer: next free slot, or NULL when every slot is still in flight
+frame_ring_slot_t* frame_ring_begin_write(frame_ring_t* ring) {
+    if (!ring) return NULL;
+
+    uint32_t write = atomic_load_explicit(&ring->write_index, memory_order_relaxed);
+    uint32_t read = atomic_load_explicit(&ring->read_index, memory_order_acquire);
+
+    if (write - read >= ring->capacity) return NULL; // Full
+
+    return &ring->slots[write & ring->mask];
+}
+
+// Producer: publish the slot returned by frame_ring_begin_write
+bool frame_ring_publish(frame_ring_t* ring, int width, int height, double timestamp,
+                        uint64_t source_id) {
+    if (!ring || width <= 0 || height <= 0 ||
+        (size_t)width * height * 4 > ring->slot_size) {
+        return false;
+    }
+
+    uint32_t write = atomic_load_explicit(&ring->write_index, memory_order_relaxed);
+    uint32_t read = atomic_load_explicit(&ring->read_index, memory_order_acquire);
+    if (write - read >= ring->capacity) return false;
+
+    frame_ring_slot_t* slot = &ring->slots[write & ring->mask];
+    slot->width = width;
+    slot->height = height;
+    slot->timestamp = timestamp;
+    slot->frame_number = (int)write;
+    slot->source_id = source_id;
+    slot->status = FRAME_RING_STATUS_FAILED;
+
+    // Release: slot contents become visible to the engine with the index
+    atomic_store_explicit(&ring->write_index, write + 1, memory_order_release);
+    return true;
+}
+
+// Engine: oldest published but unprocessed slot, or NULL when idle
+frame_ring_slot_t* frame_ring_begin_process(frame_ring_t* ring) {
+    if (!ring) return NULL;
+
+    uint32_t process = atomic_load_explicit(&ring->process_index, memory_order_relaxed);
+    uint32_t write = atomic_load_explicit(&ring->write_index, memory_order_acquire);
+
+    if (process == write) return NULL; // Nothing published
+
+    return &ring->slots[process & ring->mask];
+}
+
+// Engine: hand the slot returned by frame_ring_begin_process to the reader
+void frame_ring_end_process(frame_ring_t* ring, int status) {
+    if (!ring) return;
+
+    uint32_t process = atomic_load_explicit(&ring->process_index, memory_order_relaxed);
+    ring->slots[process & ring->mask].status = status;
+
+    atomic_store_explicit(&ring->process_index, process + 1, memory_order_release);
+}
+
+// Engine: published slots not yet processed (including the current one)
+int frame_ring_get_pending(frame_ring_t* ring) {
+    if (!ring) return 0;
+
+    uint32_t process = atomic_load_explicit(&ring->process_index, memory_order_relaxed);
+    uint32_t write = atomic_load_explicit(&ring->write_index, memory_order_acquire);
+    return (int)(write - process);
+}
+
+// Reader: oldest processed slot, or NULL when nothing is ready
+frame_ring_slot_t* frame_ring_begin_read(frame_ring_t* ring) {
+    if (!ring) return NULL;
+
+    uint32_t read = atomic_load_explicit(&ring->read_index, memory_order_relaxed);
+    uint32_t process = atomic_load_explicit(&ring->process_index, memory_order_acquire);
+
+    if (read == process) return NULL; // Nothing processed yet
+
+    return &ring->slots[read & ring->mask];
+}
+
+// Reader: return the slot to the producer
+void frame_ring_release(frame_ring_t* ring) {
+    if (!ring) return;
+
+    uint32_t read = atomic_load_explicit(&ring->read_index, memory_order_relaxed);
+    uint32_t process = atomic_load_explicit(&ring->process_index, memory_order_acquire);
+    if (read == process) return;
+
+    atomic_store_explicit(&ring->read_index, read + 1, memory_order_release);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Create frame ring from JavaScript
+EMSCRIPTEN_KEEPALIVE
+engine_handle_t js_frame_ring_create(int capacity, int width, int height) {
+    frame_ring_t* ring = frame_ring_create(capacity, width, height);
+    engine_handle_t handle = handle_register(ring, HANDLE_TYPE_FRAME_RING);
+    if (handle == HANDLE_INVALID) frame_ring_destroy(ring);
+    return handle;
+}
+
+// Destroy frame ring from JavaScript
+EMSCRIPTEN_KEEPALIVE
+void js_frame_ring_destroy(engine_handle_t ring_handle) {
+    frame_ring_t* ring = handle_release(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!ring) return;
+    frame_ring_destroy(ring);
+}
+
+// Pointer to the next free slot's pixels (0 when full); JS writes into it directly
+EMSCRIPTEN_KEEPALIVE
+uint8_t* js_frame_ring_acquire_write(engine_handle_t ring_handle) {
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!ring) return NULL;
+    frame_ring_slot_t* slot = frame_ring_begin_write(ring);
+    return slot ? slot->data : NULL;
+}
+
+// Publish the slot JS just filled; source_id names its pixels (0 = unknown)
+EMSCRIPTEN_KEEPALIVE
+int js_frame_ring_publish(engine_handle_t ring_handle, int width, int height, double timestamp,
+                          double source_id) {
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!ring) return 0;
+    return frame_ring_publish(ring, width, height, timestamp,
+                              source_id > 0 ? (uint64_t)source_id : 0) ? 1 : 0;
+}
+
+// Pointer to the oldest processed slot's pixels (0 when none); JS reads it as a view
+EMSCRIPTEN_KEEPALIVE
+uint8_t* js_frame_ring_acquire_read(engine_handle_t ring_handle) {
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!ring) return NULL;
+    frame_ring_slot_t* slot = frame_ring_begin_read(ring);
+    return slot ? slot->data : NULL;
+}
+
+// Processing status of the slot returned by js_frame_ring_acquire_read
+EMSCRIPTEN_KEEPALIVE
+int js_frame_ring_read_status(engine_handle_t ring_handle) {
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!ring) return 0;
+    frame_ring_slot_t* slot = frame_ring_begin_read(ring);
+    return slot ? slot->status : FRAME_RING_STATUS_FAILED;
+}
+
+// Release the slot returned by js_frame_ring_acquire_read
+EMSCRIPTEN_KEEPALIVE
+void js_frame_ring_release(engine_handle_t ring_handle) {
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!ring) return;
+    frame_ring_release(ring);
+}
@@ -0,0 +1,149 @@
+#include "../include/handle_table.h"
+#include "../include/engine_log.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// Slots live in fixed pages that are allocated on first use and never freed
+// or moved, so lookups need no lock. Register and release take a spinlock;
+// they happen once per object, not per frame.
+#define HANDLE_PAGE_BITS 8
+#define HANDLE_PAGE_SIZE (1u << HANDLE_PAGE_BITS)
+#define HANDLE_PAGE_COUNT ((HANDLE_TABLE_CAPACITY + 1) / HANDLE_PAGE_SIZE)
+#define HANDLE_INDEX_MASK ((1u << HANDLE_INDEX_BITS) - 1)
+#define HANDLE_GENERATION_MASK ((1u << HANDLE_GENERATION_BITS) - 1)
+
+typedef struct handle_slot_t {
+    _Atomic uint32_t tag;          // generation << 8 | type; 0 while free
+    _Atomic(void*) object;
+    uint32_t generation;           // Generation the next registration gets
+    uint32_t next_free;            // Free list link (0 = end)
+} handle_slot_t;
+
+static _Atomic(handle_slot_t*) handle_pages[HANDLE_PAGE_COUNT];
+static atomic_flag handle_lock = ATOMIC_FLAG_INIT;
+static uint32_t handle_next_unused = 1;  // Slot 0 is reserved
+static uint32_t handle_free_head = 0;    // FIFO, so each slot's generations
+static uint32_t handle_free_tail = 0;    // are used up as slowly as possible
+static int handle_live = 0;
+
+static inline void table_lock(void) {
+    while (atomic_flag_test_and_set_explicit(&handle_lock, memory_order_acquire)) {
+    }
+}
+
+static inline void table_unlock(void) {
+    atomic_flag_clear_explicit(&handle_lock, memory_order_release);
+}
+
+static inline uint32_t slot_tag(uint32_t generation, handle_type_t type) {
+    return (generation << 8) | (uint32_t)type;
+}
+
+static inline handle_slot_t* slot_at(uint32_t index) {
+    handle_slot_t* page = atomic_load_explicit(&handle_pages[index >> HANDLE_PAGE_BITS], memory_order_acquire);
+    return page ? &page[index & (HANDLE_PAGE_SIZE - 1)] : NULL;
+}
+
+// Caller holds the lock
+static handle_slot_t* take_slot(uint32_t* index) {
+    if (handle_free_head != 0) {
+        *index = handle_free_head;
+        handle_slot_t* slot = slot_at(*index);
+        handle_free_head = slot->next_free;
+        if (handle_free_head == 0) handle_free_tail = 0;
+        return slot;
+    }
+
+    if (handle_next_unused > HANDLE_TABLE_CAPACITY) return NULL;
+
+    uint32_t page_index = handle_next_unused >> HANDLE_PAGE_BITS;
+    handle_slot_t* page = atomic_load_explicit(&handle_pages[page_index], memory_order_relaxed);
+    if (!page) {
+        page = calloc(HANDLE_PAGE_SIZE, sizeof(handle_slot_t));
+        if (!page) return NULL;
+        for (uint32_t i = 0; i < HANDLE_PAGE_SIZE; i++) page[i].generation = 1;
+        atomic_store_explicit(&handle_pages[page_index], page, memory_order_release);
+    }
+
+    *index = handle_next_unused++;
+    return &page[*index & (HANDLE_PAGE_SIZE - 1)];
+}
+
+engine_handle_t handle_register(void* object, handle_type_t type) {
+    if (!object || type <= HANDLE_TYPE_NONE || type >= HANDLE_TYPE_COUNT) return HANDLE_INVALID;
+
+    table_lock();
+    uint32_t index;
+    handle_slot_t* slot = take_slot(&index);
+    if (!slot) {
+        int live = handle_live;
+        table_unlock();
+        LOG_ERROR("Handle table full (%d live handles)", live);
+        return HANDLE_INVALID;
+    }
+
+    uint32_t generation = slot->generation;
+    slot->next_free = 0;
+    atomic_store_explicit(&slot->object, object, memory_order_relaxed);
+    atomic_store_explicit(&slot->tag, slot_tag(generation, type), memory_order_release);
+    handle_live++;
+    table_unlock();
+
+    return (generation << HANDLE_INDEX_BITS) | index;
+}
+
+void* handle_get(engine_handle_t handle, handle_type_t type) {
+    uint32_t index = handle & HANDLE_INDEX_MASK;
+    uint32_t generation = (handle >> HANDLE_INDEX_BITS) & HANDLE_GENERATION_MASK;
+    if (index == 0 || generation == 0 || (handle >> (HANDLE_INDEX_BITS + HANDLE_GENERATION_BITS)) != 0) return NULL;
+    if (type <= HANDLE_TYPE_NONE || type >= HANDLE_TYPE_COUNT) return NULL;
+
+    handle_slot_t* slot = slot_at(index);
+    if (!slot) return NULL;
+
+    if (atomic_load_explicit(&slot->tag, memory_order_acquire) != slot_tag(generation, type)) return NULL;
+    return atomic_load_explicit(&slot->object, memory_order_relaxed);
+}
+
+void* handle_release(engine_handle_t handle, handle_type_t type) {
+    if (!handle_get(handle, type)) return NULL;
+
+    uint32_t index = handle & HANDLE_INDEX_MASK;
+    uint32_t generation = handle >> HANDLE_INDEX_BITS;
+
+    table_lock();
+    handle_slot_t* slot = slot_at(index);
+    // Recheck under the lock; a racing release may have won
+    if (atomic_load_explicit(&slot->tag, memory_order_relaxed) != slot_tag(generation, type)) {
+        table_unlock();
+        return NULL;
+    }
+
+    void* object = atomic_load_explicit(&slot->object, memory_order_relaxed);
+    atomic_store_explicit(&slot->tag, 0, memory_order_release);
+    atomic_store_explicit(&slot->object, NULL, memory_order_relaxed);
+
+    // A slot whose generation is used up is retired rather than wrapped, so
+    // a stale handle can never resolve again
+    slot->generation = generation + 1;
+    slot->next_free = 0;
+    if (slot->generation <= HANDLE_GENERATION_MASK) {
+        if (handle_free_tail != 0) {
+            slot_at(handle_free_tail)->next_free = index;
+        } else {
+            handle_free_head = index;
+        }
+        handle_free_tail = index;
+    }
+    handle_live--;
+    table_unlock();
+
+    return object;
+}
+
+int handle_table_live_count(void) {
+    table_lock();
+    int live = handle_live;
+    table_unlock();
+    return live;
+}
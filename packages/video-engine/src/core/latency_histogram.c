@@ -0,0 +1,98 @@
+#include "../include/latency_histogram.h"
+#include <string.h>
+
+// Bucket holding a value
+static inline int bucket_index(uint64_t value) {
+    if (value < LATENCY_SUB_BUCKETS) return (int)value;
+
+    int msb = 63 - __builtin_clzll(value);
+    if (msb >= LATENCY_MAX_BITS) return LATENCY_BUCKET_COUNT - 1;
+
+    int shift = msb - LATENCY_SUB_BUCKET_BITS;
+    return (shift + 1) * LATENCY_SUB_BUCKETS + (int)((value >> shift) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+// Midpoint of the values a bucket covers
+static inline uint64_t bucket_value(int index) {
+    if (index < LATENCY_SUB_BUCKETS) return (uint64_t)index;
+
+    int shift = index / LATENCY_SUB_BUCKETS - 1;
+    uint64_t low = (uint64_t)(LATENCY_SUB_BUCKETS + index % LATENCY_SUB_BUCKETS) << shift;
+    return low + (((uint64_t)1 << shift) >> 1);
+}
+
+void latency_histogram_init(latency_histogram_t* histogram, uint32_t window_size) {
+    if (!histogram) return;
+
+    memset(histogram, 0, sizeof(latency_histogram_t));
+    histogram->window_size = window_size > 0 ? window_size : LATENCY_DEFAULT_WINDOW;
+}
+
+void latency_histogram_reset(latency_histogram_t* histogram) {
+    if (!histogram) return;
+
+    latency_histogram_init(histogram, histogram->window_size);
+}
+
+void latency_histogram_record(latency_histogram_t* histogram, uint64_t value_ns) {
+    if (!histogram) return;
+
+    latency_window_t* window = &histogram->windows[histogram->current];
+    if (window->total >= histogram->window_size) {
+        // Roll over: drop the oldest window
+        histogram->current ^= 1;
+        window = &histogram->windows[histogram->current];
+        memset(window, 0, sizeof(latency_window_t));
+    }
+
+    window->counts[bucket_index(value_ns)]++;
+    window->total++;
+    window->sum_ns += value_ns;
+    if (value_ns > window->max_ns) window->max_ns = value_ns;
+}
+
+uint32_t latency_histogram_count(const latency_histogram_t* histogram) {
+    if (!histogram) return 0;
+
+    return histogram->windows[0].total + histogram->windows[1].total;
+}
+
+// Value below which `percentile` (0-100) of the samples fall
+uint64_t latency_histogram_percentile(const latency_histogram_t* histogram, double percentile) {
+    uint32_t total = latency_histogram_count(histogram);
+    if (total == 0) return 0;
+
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * total + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        seen += histogram->windows[0].counts[i] + histogram->windows[1].counts[i];
+        if (seen >= rank) {
+            // Never report more than was actually observed
+            uint64_t value = bucket_value(i);
+            uint64_t max = latency_histogram_max(histogram);
+            return value < max ? value : max;
+        }
+    }
+
+    return latency_histogram_max(histogram);
+}
+
+uint64_t latency_histogram_max(const latency_histogram_t* histogram) {
+    if (!histogram) return 0;
+
+    uint64_t a = histogram->windows[0].max_ns;
+    uint64_t b = histogram->windows[1].max_ns;
+    return a > b ? a : b;
+}
+
+double latency_histogram_mean(const latency_histogram_t* histogram) {
+    uint32_t total = latency_histogram_count(histogram);
+    if (total == 0) return 0.0;
+
+    return (double)(histogram->windows[0].sum_ns + histogram->windows[1].sum_ns) / total;
+}
@@ -1,4 +1,5 @@
 #include "video_engine.h"
+#include "engine_counters.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
@@ -47,13 +48,18 @@ void memory_pool_destroy(memory_pool_t* pool) {
 }
 
 uint8_t* memory_pool_alloc(memory_pool_t* pool) {
-    if (!pool || pool->used_count >= pool->total_blocks) return NULL;
+    if (!pool) return NULL;
+    if (pool->used_count >= pool->total_blocks) {
+        engine_counter_add(ENGINE_COUNTER_POOL_EXHAUSTED, 1);
+        return NULL;
+    }
     
     // Find first available block
     for (int i = 0; i < pool->total_blocks; i++) {
         if (!pool->used_blocks[i]) {
             pool->used_blocks[i] = true;
             pool->used_count++;
+            engine_counter_add(ENGINE_COUNTER_POOL_ALLOCS, 1);
             return pool->pool + (i * pool->block_size);
         }
     }
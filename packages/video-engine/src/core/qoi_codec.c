@@ -0,0 +1,139 @@
+#include "../include/qoi_codec.h"
+#include <string.h>
+
+#define QOI_OP_INDEX 0x00 // 00xxxxxx
+#define QOI_OP_DIFF  0x40 // 01xxxxxx
+#define QOI_OP_LUMA  0x80 // 10xxxxxx
+#define QOI_OP_RUN   0xc0 // 11xxxxxx
+#define QOI_OP_RGB   0xfe
+#define QOI_OP_RGBA  0xff
+#define QOI_MASK_2   0xc0
+#define QOI_MAX_RUN  62
+
+typedef union {
+    struct { uint8_t r, g, b, a; } rgba;
+    uint32_t v;
+} qoi_pixel_t;
+
+static inline int qoi_hash(qoi_pixel_t p) {
+    return (p.rgba.r * 3 + p.rgba.g * 5 + p.rgba.b * 7 + p.rgba.a * 11) % 64;
+}
+
+size_t qoi_encode(const uint8_t* rgba, size_t pixel_count, uint8_t* out, size_t capacity) {
+    if (!rgba || !out) return 0;
+
+    qoi_pixel_t index[64];
+    memset(index, 0, sizeof(index));
+    qoi_pixel_t prev = {.rgba = {0, 0, 0, 255}};
+    size_t pos = 0;
+    int run = 0;
+
+    for (size_t i = 0; i < pixel_count; i++) {
+        qoi_pixel_t px;
+        memcpy(&px, rgba + i * 4, 4);
+
+        if (px.v == prev.v) {
+            run++;
+            if (run == QOI_MAX_RUN || i == pixel_count - 1) {
+                if (pos + 1 > capacity) return 0;
+                out[pos++] = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        // Worst case below: a flushed run plus QOI_OP_RGBA
+        if (pos + 6 > capacity) return 0;
+
+        if (run > 0) {
+            out[pos++] = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        int hash = qoi_hash(px);
+        if (index[hash].v == px.v) {
+            out[pos++] = QOI_OP_INDEX | hash;
+        } else {
+            index[hash] = px;
+
+            if (px.rgba.a == prev.rgba.a) {
+                int8_t vr = (int8_t)(px.rgba.r - prev.rgba.r);
+                int8_t vg = (int8_t)(px.rgba.g - prev.rgba.g);
+                int8_t vb = (int8_t)(px.rgba.b - prev.rgba.b);
+                int8_t vg_r = (int8_t)(vr - vg);
+                int8_t vg_b = (int8_t)(vb - vg);
+
+                if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                    out[pos++] = QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2);
+                } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+                    out[pos++] = QOI_OP_LUMA | (vg + 32);
+                    out[pos++] = (vg_r + 8) << 4 | (vg_b + 8);
+                } else {
+                    out[pos++] = QOI_OP_RGB;
+                    out[pos++] = px.rgba.r;
+                    out[pos++] = px.rgba.g;
+                    out[pos++] = px.rgba.b;
+                }
+            } else {
+                out[pos++] = QOI_OP_RGBA;
+                memcpy(out + pos, &px, 4);
+                pos += 4;
+            }
+        }
+        prev = px;
+    }
+
+    return pos;
+}
+
+bool qoi_decode(const uint8_t* data, size_t size, uint8_t* rgba, size_t pixel_count) {
+    if (!data || !rgba) return false;
+
+    qoi_pixel_t index[64];
+    memset(index, 0, sizeof(index));
+    qoi_pixel_t px = {.rgba = {0, 0, 0, 255}};
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (i < pixel_count) {
+        if (pos >= size) return false;
+        int b1 = data[pos++];
+
+        if (b1 == QOI_OP_RGB) {
+            if (pos + 3 > size) return false;
+            px.rgba.r = data[pos++];
+            px.rgba.g = data[pos++];
+            px.rgba.b = data[pos++];
+        } else if (b1 == QOI_OP_RGBA) {
+            if (pos + 4 > size) return false;
+            memcpy(&px, data + pos, 4);
+            pos += 4;
+        } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+            px = index[b1];
+        } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+            px.rgba.r += ((b1 >> 4) & 0x03) - 2;
+            px.rgba.g += ((b1 >> 2) & 0x03) - 2;
+            px.rgba.b += (b1 & 0x03) - 2;
+        } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+            if (pos >= size) return false;
+            int b2 = data[pos++];
+            int vg = (b1 & 0x3f) - 32;
+            px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
+            px.rgba.g += vg;
+            px.rgba.b += vg - 8 + (b2 & 0x0f);
+        } else {
+            // QOI_OP_RUN: the previous pixel again, 1-62 times
+            size_t run = (size_t)(b1 & 0x3f) + 1;
+            if (run > pixel_count - i) return false;
+            for (size_t r = 0; r < run; r++) memcpy(rgba + (i + r) * 4, &px, 4);
+            i += run;
+            continue;
+        }
+
+        index[qoi_hash(px)] = px;
+        memcpy(rgba + i * 4, &px, 4);
+        i++;
+    }
+
+    return pos == size;
+}
@@ -0,0 +1,450 @@
+#include "../include/quality_metrics.h"
+#include "../include/render_scheduler.h"
+#include "../include/engine_counters.h"
+#include "../include/handle_table.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WIN QUALITY_SSIM_WINDOW
+
+// Four-lane float vectors. GCC and clang lower these to SSE on x86 and to
+// wasm SIMD128 when built with -msimd128 (plain scalar code otherwise).
+typedef float v4f __attribute__((vector_size(16)));
+
+static inline v4f v4f_load(const float* p) {
+    v4f v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline v4f v4f_splat(float f) {
+    return (v4f){f, f, f, f};
+}
+
+static inline float v4f_sum(v4f v) {
+    return v[0] + v[1] + v[2] + v[3];
+}
+
+#define SSIM_C1 6.5025f  // (0.01 * 255)^2
+#define SSIM_C2 58.5225f // (0.03 * 255)^2
+
+// Normalized Gaussian, sigma 1.5 (Wang et al. 2004)
+static const float ssim_window[WIN] = {
+    0.00102838f, 0.00759876f, 0.03600077f, 0.10936069f, 0.21300554f, 0.26601172f,
+    0.21300554f, 0.10936069f, 0.03600077f, 0.00759876f, 0.00102838f
+};
+
+static const double ms_ssim_weights[QUALITY_MS_SSIM_SCALES] = {
+    0.0448, 0.2856, 0.3001, 0.2363, 0.1333
+};
+
+static bool same_size(const video_frame_t* a, const video_frame_t* b) {
+    return a && b && a->data && b->data && a->width > 0 && a->height > 0 &&
+           a->width == b->width && a->height == b->height;
+}
+
+// Mean squared error over RGB (alpha ignored); -1 on mismatched frames
+double quality_mse(const video_frame_t* a, const video_frame_t* b) {
+    if (!same_size(a, b)) return -1.0;
+
+    int width = a->width;
+    int height = a->height;
+    uint64_t sse = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pa = a->data + (size_t)y * width * 4;
+        const uint8_t* pb = b->data + (size_t)y * width * 4;
+
+        // A row sums at most width * 3 * 255^2: fits for widths up to 22k
+        uint32_t row = 0;
+        for (int x = 0; x < width * 4; x += 4) {
+            int dr = pa[x] - pb[x];
+            int dg = pa[x + 1] - pb[x + 1];
+            int db = pa[x + 2] - pb[x + 2];
+            row += dr * dr + dg * dg + db * db;
+        }
+        sse += row;
+    }
+
+    return (double)sse / ((double)width * height * 3.0);
+}
+
+double quality_psnr_from_mse(double mse) {
+    if (mse <= 0.0) return QUALITY_PSNR_MAX;
+    double psnr = 10.0 * log10(255.0 * 255.0 / mse);
+    return psnr < QUALITY_PSNR_MAX ? psnr : QUALITY_PSNR_MAX;
+}
+
+// ============================================================================
+// SSIM
+// ============================================================================
+
+static void luma_plane(const video_frame_t* frame, float* out) {
+    const uint8_t* p = frame->data;
+    size_t count = (size_t)frame->width * frame->height;
+
+    for (size_t i = 0; i < count; i++, p += 4) {
+        out[i] = 0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2];
+    }
+}
+
+// 2x2 box average, dropping an odd last row/column
+static void downsample_plane(const float* src, int width, int height, float* dst) {
+    int dst_width = width / 2;
+    int dst_height = height / 2;
+
+    for (int y = 0; y < dst_height; y++) {
+        const float* row0 = src + (size_t)(2 * y) * width;
+        const float* row1 = row0 + width;
+        float* out = dst + (size_t)y * dst_width;
+        for (int x = 0; x < dst_width; x++) {
+            out[x] = 0.25f * (row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1]);
+        }
+    }
+}
+
+#define HALF_WIN (WIN / 2)
+
+// Valid-region horizontal Gaussian of one row (out_width = width - WIN + 1).
+// The window is symmetric, so mirrored taps are summed before weighting.
+static void filter_row(const float* in, float* out, int out_width) {
+    int x = 0;
+    for (; x + 4 <= out_width; x += 4) {
+        const float* p = in + x;
+        v4f acc = v4f_splat(ssim_window[HALF_WIN]) * v4f_load(p + HALF_WIN);
+        for (int k = 0; k < HALF_WIN; k++) {
+            acc += v4f_splat(ssim_window[k]) * (v4f_load(p + k) + v4f_load(p + WIN - 1 - k));
+        }
+        memcpy(out + x, &acc, sizeof(acc));
+    }
+    for (; x < out_width; x++) {
+        float acc = 0.0f;
+        for (int k = 0; k < WIN; k++) {
+            acc += ssim_window[k] * in[x + k];
+        }
+        out[x] = acc;
+    }
+}
+
+static inline void ssim_pixel(float mx, float my, float sxx, float syy, float sxy,
+                              float* ssim, float* cs) {
+    float mxy = mx * my;
+    float c = (2.0f * (sxy - mxy) + SSIM_C2) / (sxx - mx * mx + syy - my * my + SSIM_C2);
+    float l = (2.0f * mxy + SSIM_C1) / (mx * mx + my * my + SSIM_C1);
+    *ssim = l * c;
+    *cs = c;
+}
+
+// Floats of row scratch ssim_plane needs for a plane `width` wide
+static size_t ssim_rows_size(int width) {
+    return (size_t)3 * width + (size_t)5 * WIN * (width - WIN + 1);
+}
+
+// Mean SSIM and mean contrast-structure term of two planes over the valid
+// window positions. The five Gaussian-filtered moments are computed with
+// separable passes: each input row is filtered horizontally once into a ring
+// of WIN rows, and every output row is a vertical pass over the ring.
+// Returns false if the work was cancelled.
+static bool ssim_plane(const float* a, const float* b, int width, int height, float* rows,
+                       double* ssim_mean, double* cs_mean) {
+    int out_width = width - WIN + 1;
+    int out_height = height - WIN + 1;
+    size_t moment_stride = (size_t)out_width;
+    size_t slot_stride = 5 * moment_stride;
+
+    float* aa = rows;
+    float* bb = aa + width;
+    float* ab = bb + width;
+    float* ring = ab + width;
+
+    double ssim_sum = 0.0;
+    double cs_sum = 0.0;
+
+    for (int r = 0; r < height; r++) {
+        if (r % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) return false;
+
+        const float* ar = a + (size_t)r * width;
+        const float* br = b + (size_t)r * width;
+        for (int x = 0; x < width; x++) {
+            aa[x] = ar[x] * ar[x];
+            bb[x] = br[x] * br[x];
+            ab[x] = ar[x] * br[x];
+        }
+
+        float* slot = ring + (size_t)(r % WIN) * slot_stride;
+        filter_row(ar, slot, out_width);
+        filter_row(br, slot + moment_stride, out_width);
+        filter_row(aa, slot + 2 * moment_stride, out_width);
+        filter_row(bb, slot + 3 * moment_stride, out_width);
+        filter_row(ab, slot + 4 * moment_stride, out_width);
+
+        if (r < WIN - 1) continue;
+
+        // Ring slots of the WIN rows under this output row, oldest first
+        const float* window_rows[WIN];
+        for (int k = 0; k < WIN; k++) {
+            window_rows[k] = ring + (size_t)((r - WIN + 1 + k) % WIN) * slot_stride;
+        }
+
+        v4f ssim_acc = v4f_splat(0.0f);
+        v4f cs_acc = v4f_splat(0.0f);
+        int x = 0;
+        for (; x + 4 <= out_width; x += 4) {
+            const float* m = window_rows[HALF_WIN] + x;
+            v4f g = v4f_splat(ssim_window[HALF_WIN]);
+            v4f mx = g * v4f_load(m);
+            v4f my = g * v4f_load(m + moment_stride);
+            v4f sxx = g * v4f_load(m + 2 * moment_stride);
+            v4f syy = g * v4f_load(m + 3 * moment_stride);
+            v4f sxy = g * v4f_load(m + 4 * moment_stride);
+            for (int k = 0; k < HALF_WIN; k++) {
+                const float* s = window_rows[k] + x;
+                const float* t = window_rows[WIN - 1 - k] + x;
+                g = v4f_splat(ssim_window[k]);
+                mx += g * (v4f_load(s) + v4f_load(t));
+                my += g * (v4f_load(s + moment_stride) + v4f_load(t + moment_stride));
+                sxx += g * (v4f_load(s + 2 * moment_stride) + v4f_load(t + 2 * moment_stride));
+                syy += g * (v4f_load(s + 3 * moment_stride) + v4f_load(t + 3 * moment_stride));
+                sxy += g * (v4f_load(s + 4 * moment_stride) + v4f_load(t + 4 * moment_stride));
+            }
+
+            v4f mxy = mx * my;
+            v4f c = (v4f_splat(2.0f) * (sxy - mxy) + v4f_splat(SSIM_C2)) /
+                    (sxx - mx * mx + syy - my * my + v4f_splat(SSIM_C2));
+            v4f l = (v4f_splat(2.0f) * mxy + v4f_splat(SSIM_C1)) /
+                    (mx * mx + my * my + v4f_splat(SSIM_C1));
+            ssim_acc += l * c;
+            cs_acc += c;
+        }
+
+        float ssim_row = v4f_sum(ssim_acc);
+        float cs_row = v4f_sum(cs_acc);
+        for (; x < out_width; x++) {
+            float m[5] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+            for (int k = 0; k < WIN; k++) {
+                for (int q = 0; q < 5; q++) {
+                    m[q] += ssim_window[k] * window_rows[k][q * moment_stride + x];
+                }
+            }
+            float s, c;
+            ssim_pixel(m[0], m[1], m[2], m[3], m[4], &s, &c);
+            ssim_row += s;
+            cs_row += c;
+        }
+
+        ssim_sum += ssim_row;
+        cs_sum += cs_row;
+    }
+
+    double count = (double)out_width * out_height;
+    *ssim_mean = ssim_sum / count;
+    *cs_mean = cs_sum / count;
+    return true;
+}
+
+// ============================================================================
+// Context
+// ============================================================================
+
+quality_metrics_t* quality_metrics_create(void) {
+    quality_metrics_t* metrics = malloc(sizeof(quality_metrics_t));
+    if (!metrics) return NULL;
+
+    memset(metrics, 0, sizeof(quality_metrics_t));
+    return metrics;
+}
+
+void quality_metrics_destroy(quality_metrics_t* metrics) {
+    if (!metrics) return;
+
+    free(metrics->scratch);
+    free(metrics);
+}
+
+// Clear the stream summary (scratch is kept)
+void quality_metrics_reset(quality_metrics_t* metrics) {
+    if (!metrics) return;
+
+    memset(&metrics->last, 0, sizeof(metrics->last));
+    memset(&metrics->summary, 0, sizeof(metrics->summary));
+}
+
+static bool reserve_scratch(quality_metrics_t* metrics, size_t floats) {
+    if (floats <= metrics->scratch_capacity) return true;
+
+    float* scratch = realloc(metrics->scratch, floats * sizeof(float));
+    if (!scratch) return false;
+    engine_counter_alloc(floats * sizeof(float));
+
+    metrics->scratch = scratch;
+    metrics->scratch_capacity = floats;
+    return true;
+}
+
+// Luma SSIM at full resolution and, when `ms_ssim` is given, MS-SSIM over
+// up to QUALITY_MS_SSIM_SCALES dyadic scales
+static bool structural_similarity(quality_metrics_t* metrics, const video_frame_t* a,
+                                  const video_frame_t* b, double* ssim, double* ms_ssim) {
+    int width = a->width;
+    int height = a->height;
+    if (width < WIN || height < WIN) return false;
+
+    // Scales whose planes still cover a whole window
+    int scales = 1;
+    size_t plane_floats = (size_t)width * height;
+    if (ms_ssim) {
+        int w = width / 2, h = height / 2;
+        while (scales < QUALITY_MS_SSIM_SCALES && w >= WIN && h >= WIN) {
+            plane_floats += (size_t)w * h;
+            scales++;
+            w /= 2;
+            h /= 2;
+        }
+    }
+
+    if (!reserve_scratch(metrics, 2 * plane_floats + ssim_rows_size(width))) return false;
+
+    float* plane_a = metrics->scratch;
+    float* plane_b = plane_a + plane_floats;
+    float* rows = plane_b + plane_floats;
+    luma_plane(a, plane_a);
+    luma_plane(b, plane_b);
+
+    double log_ms = 0.0;
+    double weight_sum = 0.0;
+    for (int s = 0; s < scales; s++) {
+        weight_sum += ms_ssim_weights[s];
+    }
+
+    for (int s = 0; s < scales; s++) {
+        double scale_ssim, scale_cs;
+        if (!ssim_plane(plane_a, plane_b, width, height, rows, &scale_ssim, &scale_cs)) {
+            return false;
+        }
+
+        if (s == 0) *ssim = scale_ssim;
+
+        // Contrast-structure at every scale, luminance only at the coarsest
+        double term = (s == scales - 1) ? scale_ssim : scale_cs;
+        if (term <= 0.0) {
+            log_ms = -INFINITY;
+        } else {
+            log_ms += ms_ssim_weights[s] / weight_sum * log(term);
+        }
+
+        if (s + 1 < scales) {
+            float* next_a = plane_a + (size_t)width * height;
+            float* next_b = plane_b + (size_t)width * height;
+            downsample_plane(plane_a, width, height, next_a);
+            downsample_plane(plane_b, width, height, next_b);
+            plane_a = next_a;
+            plane_b = next_b;
+            width /= 2;
+            height /= 2;
+        }
+    }
+
+    if (ms_ssim) *ms_ssim = exp(log_ms);
+    return true;
+}
+
+static void fold_summary(quality_summary_t* summary, const quality_result_t* result, int which) {
+    double n = ++summary->frames;
+    bool first = n == 1.0;
+
+    if (which & QUALITY_METRIC_PSNR) {
+        summary->psnr_mean += (result->psnr - summary->psnr_mean) / n;
+        if (first || result->psnr < summary->psnr_min) summary->psnr_min = result->psnr;
+    }
+    if (which & QUALITY_METRIC_SSIM) {
+        summary->ssim_mean += (result->ssim - summary->ssim_mean) / n;
+        if (first || result->ssim < summary->ssim_min) summary->ssim_min = result->ssim;
+    }
+    if (which & QUALITY_METRIC_MS_SSIM) {
+        summary->ms_ssim_mean += (result->ms_ssim - summary->ms_ssim_mean) / n;
+        if (first || result->ms_ssim < summary->ms_ssim_min) summary->ms_ssim_min = result->ms_ssim;
+    }
+}
+
+// Compare two frames. A stream should use the same metric mask throughout
+// so the summary means cover every frame.
+bool quality_metrics_compare(quality_metrics_t* metrics, const video_frame_t* a,
+                             const video_frame_t* b, int which, quality_result_t* result) {
+    if (!metrics || !same_size(a, b) || !(which & QUALITY_METRIC_ALL)) return false;
+
+    quality_result_t r;
+    memset(&r, 0, sizeof(r));
+
+    if (which & QUALITY_METRIC_PSNR) {
+        r.mse = quality_mse(a, b);
+        r.psnr = quality_psnr_from_mse(r.mse);
+    }
+
+    if (which & (QUALITY_METRIC_SSIM | QUALITY_METRIC_MS_SSIM)) {
+        bool ok = structural_similarity(metrics, a, b, &r.ssim,
+                                        (which & QUALITY_METRIC_MS_SSIM) ? &r.ms_ssim : NULL);
+        if (!ok) return false;
+    }
+
+    metrics->last = r;
+    fold_summary(&metrics->summary, &r, which);
+    if (result) *result = r;
+    return true;
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Create comparison context from JavaScript
+EMSCRIPTEN_KEEPALIVE
+engine_handle_t js_quality_metrics_create(void) {
+    quality_metrics_t* metrics = quality_metrics_create();
+    engine_handle_t handle = handle_register(metrics, HANDLE_TYPE_QUALITY_METRICS);
+    if (handle == HANDLE_INVALID) quality_metrics_destroy(metrics);
+    return handle;
+}
+
+// Destroy comparison context from JavaScript
+EMSCRIPTEN_KEEPALIVE
+void js_quality_metrics_destroy(engine_handle_t metrics_handle) {
+    quality_metrics_t* metrics = handle_release(metrics_handle, HANDLE_TYPE_QUALITY_METRICS);
+    if (!metrics) return;
+    quality_metrics_destroy(metrics);
+}
+
+// Start a new stream summary
+EMSCRIPTEN_KEEPALIVE
+void js_quality_metrics_reset(engine_handle_t metrics_handle) {
+    quality_metrics_t* metrics = handle_get(metrics_handle, HANDLE_TYPE_QUALITY_METRICS);
+    if (!metrics) return;
+    quality_metrics_reset(metrics);
+}
+
+// Compare two RGBA buffers; result via js_quality_metrics_get_last
+EMSCRIPTEN_KEEPALIVE
+int js_quality_metrics_compare(engine_handle_t metrics_handle, uint8_t* a, uint8_t* b, int width, int height, int which) {
+    quality_metrics_t* metrics = handle_get(metrics_handle, HANDLE_TYPE_QUALITY_METRICS);
+    if (!metrics || !a || !b) return 0;
+
+    video_frame_t frame_a = {a, width, height, width * 4, 1, 0.0, 0};
+    video_frame_t frame_b = {b, width, height, width * 4, 1, 0.0, 0};
+    return quality_metrics_compare(metrics, &frame_a, &frame_b, which, NULL) ? 1 : 0;
+}
+
+// Pointer to the last quality_result_t (4 doubles)
+EMSCRIPTEN_KEEPALIVE
+const quality_result_t* js_quality_metrics_get_last(engine_handle_t metrics_handle) {
+    quality_metrics_t* metrics = handle_get(metrics_handle, HANDLE_TYPE_QUALITY_METRICS);
+    if (!metrics) return NULL;
+    return &metrics->last;
+}
+
+// Pointer to the stream quality_summary_t (7 doubles)
+EMSCRIPTEN_KEEPALIVE
+const quality_summary_t* js_quality_metrics_get_summary(engine_handle_t metrics_handle) {
+    quality_metrics_t* metrics = handle_get(metrics_handle, HANDLE_TYPE_QUALITY_METRICS);
+    if (!metrics) return NULL;
+    return &metrics->summary;
+}
@@ -0,0 +1,339 @@
+#include "../include/render_scheduler.h"
+#include "../include/engine_trace.h"
+#include "../include/engine_counters.h"
+#include "../include/handle_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Execution context of the calling thread (NULL outside any render work)
+static _Thread_local render_context_t* current_context = NULL;
+
+#if RENDER_SCHEDULER_THREADS
+static inline void scheduler_lock(render_scheduler_t* s) { pthread_mutex_lock(&s->lock); }
+static inline void scheduler_unlock(render_scheduler_t* s) { pthread_mutex_unlock(&s->lock); }
+#else
+static inline void scheduler_lock(render_scheduler_t* s) { (void)s; }
+static inline void scheduler_unlock(render_scheduler_t* s) { (void)s; }
+#endif
+
+// Pop the most urgent job with priority strictly below `below` (lock held)
+static render_job_t* take_job_locked(render_scheduler_t* s, int below) {
+    for (int p = 0; p < below && p < RENDER_PRIORITY_COUNT; p++) {
+        render_job_t* job = s->queue_head[p];
+        if (!job) continue;
+
+        s->queue_head[p] = job->next;
+        if (!s->queue_head[p]) {
+            s->queue_tail[p] = NULL;
+            atomic_fetch_and_explicit(&s->pending_mask, ~(1u << p), memory_order_relaxed);
+        }
+
+        s->queued_jobs--;
+        s->running_jobs++;
+        job->next = NULL;
+        return job;
+    }
+
+    return NULL;
+}
+
+static render_job_t* take_job(render_scheduler_t* s, int below) {
+    scheduler_lock(s);
+    render_job_t* job = take_job_locked(s, below);
+    scheduler_unlock(s);
+    return job;
+}
+
+#if ENGINE_TRACE
+static const char* priority_names[RENDER_PRIORITY_COUNT] = {
+    "job:interactive", "job:prefetch", "job:export", "job:analysis"
+};
+#endif
+
+// Run a job on the calling thread and return its slot to the free list
+static void run_job(render_scheduler_t* s, render_job_t* job) {
+    TRACE_BEGIN(trace_job);
+    render_context_t context;
+    render_context_enter(&context, s, job->priority, NULL);
+    job->fn(job->context, job->payload);
+    render_context_leave(&context);
+    TRACE_END(trace_job, "scheduler", priority_names[job->priority], TRACE_NO_FRAME);
+    engine_counters_publish();
+
+    scheduler_lock(s);
+    job->next = s->free_jobs;
+    s->free_jobs = job;
+    s->running_jobs--;
+#if RENDER_SCHEDULER_THREADS
+    pthread_cond_broadcast(&s->work_done);
+#endif
+    scheduler_unlock(s);
+}
+
+#if RENDER_SCHEDULER_THREADS
+static void* worker_main(void* arg) {
+    render_scheduler_t* s = (render_scheduler_t*)arg;
+    engine_trace_set_thread_name("render worker");
+
+    for (;;) {
+        pthread_mutex_lock(&s->lock);
+        while (!s->shutting_down && s->queued_jobs == 0) {
+            pthread_cond_wait(&s->work_available, &s->lock);
+        }
+        if (s->shutting_down) {
+            pthread_mutex_unlock(&s->lock);
+            break;
+        }
+        render_job_t* job = take_job_locked(s, RENDER_PRIORITY_COUNT);
+        pthread_mutex_unlock(&s->lock);
+
+        if (job) run_job(s, job);
+    }
+
+    return NULL;
+}
+#endif
+
+// Create scheduler with thread_count workers (0 = caller pumps the queue)
+render_scheduler_t* render_scheduler_create(int thread_count) {
+    if (thread_count < 0) return NULL;
+    if (thread_count > RENDER_SCHEDULER_MAX_THREADS) thread_count = RENDER_SCHEDULER_MAX_THREADS;
+#if !RENDER_SCHEDULER_THREADS
+    thread_count = 0;
+#endif
+
+    render_scheduler_t* s = malloc(sizeof(render_scheduler_t));
+    if (!s) return NULL;
+
+    memset(s, 0, sizeof(render_scheduler_t));
+    atomic_init(&s->pending_mask, 0);
+
+    for (int i = RENDER_SCHEDULER_MAX_JOBS - 1; i >= 0; i--) {
+        s->jobs[i].next = s->free_jobs;
+        s->free_jobs = &s->jobs[i];
+    }
+
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->work_available, NULL);
+    pthread_cond_init(&s->work_done, NULL);
+
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&s->threads[i], NULL, worker_main, s) != 0) break;
+        s->thread_count++;
+    }
+#endif
+
+    return s;
+}
+
+// Destroy scheduler. Running jobs finish; queued jobs that never started are dropped.
+void render_scheduler_destroy(render_scheduler_t* scheduler) {
+    if (!scheduler) return;
+
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_lock(&scheduler->lock);
+    scheduler->shutting_down = true;
+    pthread_cond_broadcast(&scheduler->work_available);
+    pthread_mutex_unlock(&scheduler->lock);
+
+    for (int i = 0; i < scheduler->thread_count; i++) {
+        pthread_join(scheduler->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&scheduler->work_done);
+    pthread_cond_destroy(&scheduler->work_available);
+    pthread_mutex_destroy(&scheduler->lock);
+#endif
+
+    free(scheduler);
+}
+
+// Queue a job; fails when the fixed job storage is exhausted
+bool render_scheduler_submit(render_scheduler_t* scheduler, render_priority_t priority,
+                             render_job_fn fn, void* context, void* payload) {
+    if (!scheduler || !fn || priority < 0 || priority >= RENDER_PRIORITY_COUNT) return false;
+
+    scheduler_lock(scheduler);
+
+    render_job_t* job = scheduler->free_jobs;
+    if (!job || scheduler->shutting_down) {
+        scheduler_unlock(scheduler);
+        return false;
+    }
+    scheduler->free_jobs = job->next;
+
+    job->fn = fn;
+    job->context = context;
+    job->payload = payload;
+    job->priority = priority;
+    job->next = NULL;
+
+    if (scheduler->queue_tail[priority]) {
+        scheduler->queue_tail[priority]->next = job;
+    } else {
+        scheduler->queue_head[priority] = job;
+    }
+    scheduler->queue_tail[priority] = job;
+    scheduler->queued_jobs++;
+    atomic_fetch_or_explicit(&scheduler->pending_mask, 1u << priority, memory_order_release);
+
+#if RENDER_SCHEDULER_THREADS
+    pthread_cond_signal(&scheduler->work_available);
+#endif
+    scheduler_unlock(scheduler);
+
+    return true;
+}
+
+// Run up to max_jobs queued jobs on the calling thread, most urgent first
+// (max_jobs <= 0 runs until the queue is empty). Returns jobs run.
+int render_scheduler_run_pending(render_scheduler_t* scheduler, int max_jobs) {
+    if (!scheduler) return 0;
+
+    int ran = 0;
+    while (max_jobs <= 0 || ran < max_jobs) {
+        render_job_t* job = take_job(scheduler, RENDER_PRIORITY_COUNT);
+        if (!job) break;
+
+        run_job(scheduler, job);
+        ran++;
+    }
+
+    return ran;
+}
+
+// Block until no job is queued or running. Must not be called from a job.
+void render_scheduler_wait_idle(render_scheduler_t* scheduler) {
+    if (!scheduler) return;
+
+#if RENDER_SCHEDULER_THREADS
+    if (scheduler->thread_count > 0) {
+        pthread_mutex_lock(&scheduler->lock);
+        while (scheduler->queued_jobs > 0 || scheduler->running_jobs > 0) {
+            pthread_cond_wait(&scheduler->work_done, &scheduler->lock);
+        }
+        pthread_mutex_unlock(&scheduler->lock);
+        return;
+    }
+#endif
+
+    render_scheduler_run_pending(scheduler, 0);
+}
+
+// Number of queued (not yet started) jobs at a priority
+int render_scheduler_get_queued(render_scheduler_t* scheduler, render_priority_t priority) {
+    if (!scheduler || priority < 0 || priority >= RENDER_PRIORITY_COUNT) return 0;
+
+    scheduler_lock(scheduler);
+    int count = 0;
+    for (render_job_t* job = scheduler->queue_head[priority]; job; job = job->next) {
+        count++;
+    }
+    scheduler_unlock(scheduler);
+
+    return count;
+}
+
+void render_cancel_token_init(render_cancel_token_t* token) {
+    if (!token) return;
+    atomic_init(&token->epoch, 0);
+}
+
+// Cancel all work that entered a context with this token so far
+void render_cancel_token_cancel(render_cancel_token_t* token) {
+    if (!token) return;
+    atomic_fetch_add_explicit(&token->epoch, 1, memory_order_release);
+}
+
+// Make `context` the calling thread's execution context (contexts nest)
+void render_context_enter(render_context_t* context, render_scheduler_t* scheduler,
+                          render_priority_t priority, render_cancel_token_t* cancel) {
+    if (!context) return;
+
+    context->scheduler = scheduler;
+    context->priority = priority;
+    context->cancel = cancel;
+    context->epoch = cancel ? atomic_load_explicit(&cancel->epoch, memory_order_acquire) : 0;
+    context->previous = current_context;
+    current_context = context;
+}
+
+// Restore the context that was active before render_context_enter
+void render_context_leave(render_context_t* context) {
+    if (!context || current_context != context) return;
+
+    current_context = context->previous;
+}
+
+render_context_t* render_context_current(void) {
+    return current_context;
+}
+
+static inline bool context_cancelled(const render_context_t* context) {
+    return context->cancel &&
+           atomic_load_explicit(&context->cancel->epoch, memory_order_acquire) != context->epoch;
+}
+
+// True once the calling thread's current work has been cancelled
+bool render_cancelled(void) {
+    render_context_t* context = current_context;
+    return context && context_cancelled(context);
+}
+
+// Run queued jobs that are more urgent than the current one; false if the
+// current work has been cancelled
+bool render_checkpoint(void) {
+    render_context_t* context = current_context;
+    if (!context) return true;
+    if (context_cancelled(context)) return false;
+    if (!context->scheduler || context->priority == RENDER_PRIORITY_INTERACTIVE) return true;
+
+    render_scheduler_t* s = context->scheduler;
+    uint32_t urgent = (1u << context->priority) - 1u;
+    if (!(atomic_load_explicit(&s->pending_mask, memory_order_acquire) & urgent)) return true;
+
+    render_job_t* job;
+    while ((job = take_job(s, context->priority)) != NULL) {
+        run_job(s, job);
+    }
+
+    return !context_cancelled(context);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Create scheduler from JavaScript
+EMSCRIPTEN_KEEPALIVE
+engine_handle_t js_render_scheduler_create(int thread_count) {
+    render_scheduler_t* scheduler = render_scheduler_create(thread_count);
+    engine_handle_t handle = handle_register(scheduler, HANDLE_TYPE_SCHEDULER);
+    if (handle == HANDLE_INVALID) render_scheduler_destroy(scheduler);
+    return handle;
+}
+
+// Destroy scheduler from JavaScript
+EMSCRIPTEN_KEEPALIVE
+void js_render_scheduler_destroy(engine_handle_t scheduler_handle) {
+    render_scheduler_t* scheduler = handle_release(scheduler_handle, HANDLE_TYPE_SCHEDULER);
+    if (!scheduler) return;
+    render_scheduler_destroy(scheduler);
+}
+
+// Pump queued jobs from the JS main loop (single-threaded builds)
+EMSCRIPTEN_KEEPALIVE
+int js_render_scheduler_run_pending(engine_handle_t scheduler_handle, int max_jobs) {
+    render_scheduler_t* scheduler = handle_get(scheduler_handle, HANDLE_TYPE_SCHEDULER);
+    if (!scheduler) return 0;
+    return render_scheduler_run_pending(scheduler, max_jobs);
+}
+
+// Queue depth for a priority class
+EMSCRIPTEN_KEEPALIVE
+int js_render_scheduler_get_queued(engine_handle_t scheduler_handle, int priority) {
+    render_scheduler_t* scheduler = handle_get(scheduler_handle, HANDLE_TYPE_SCHEDULER);
+    if (!scheduler) return 0;
+    return render_scheduler_get_queued(scheduler, (render_priority_t)priority);
+}
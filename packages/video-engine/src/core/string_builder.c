@@ -0,0 +1,81 @@
+#include "../include/string_builder.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+bool string_builder_init(string_builder_t* builder, size_t initial_capacity) {
+    if (!builder) return false;
+
+    builder->length = 0;
+    builder->capacity = initial_capacity > 0 ? initial_capacity : 256;
+    builder->data = malloc(builder->capacity);
+    builder->failed = builder->data == NULL;
+    if (builder->data) builder->data[0] = '\0';
+
+    return !builder->failed;
+}
+
+void string_builder_append(string_builder_t* builder, const char* format, ...) {
+    if (!builder || builder->failed) return;
+
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        size_t available = builder->capacity - builder->length;
+        int written = vsnprintf(builder->data + builder->length, available, format, args);
+        va_end(args);
+
+        if (written < 0) {
+            builder->failed = true;
+            return;
+        }
+        if ((size_t)written < available) {
+            builder->length += written;
+            return;
+        }
+
+        size_t capacity = builder->capacity * 2 + written;
+        char* data = realloc(builder->data, capacity);
+        if (!data) {
+            builder->failed = true;
+            return;
+        }
+        builder->data = data;
+        builder->capacity = capacity;
+    }
+}
+
+void string_builder_append_json_string(string_builder_t* builder, const char* text) {
+    if (!builder || builder->failed) return;
+
+    string_builder_append(builder, "\"");
+    const char* run = text;
+    for (const char* p = text; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+        string_builder_append(builder, "%.*s", (int)(p - run), run);
+        if (c == '"' || c == '\\') {
+            string_builder_append(builder, "\\%c", c);
+        } else {
+            string_builder_append(builder, "\\u%04x", c);
+        }
+        run = p + 1;
+    }
+    string_builder_append(builder, "%s\"", run);
+}
+
+char* string_builder_finish(string_builder_t* builder, size_t* length) {
+    if (!builder) return NULL;
+
+    if (builder->failed) {
+        free(builder->data);
+        builder->data = NULL;
+        return NULL;
+    }
+
+    if (length) *length = builder->length;
+    char* data = builder->data;
+    builder->data = NULL;
+    return data;
+}
@@ -1,4 +1,6 @@
 #include "video_engine.h"
+#include "engine_trace.h"
+#include "engine_counters.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -65,6 +67,8 @@ video_frame_t* video_decoder_get_frame(video_decoder_t* decoder, int frame_numbe
         return NULL;
     }
     
+    TRACE_BEGIN(trace_decode);
+    
     video_frame_t* frame = (video_frame_t*)malloc(sizeof(video_frame_t));
     if (!frame) return NULL;
     
@@ -83,6 +87,8 @@ video_frame_t* video_decoder_get_frame(video_decoder_t* decoder, int frame_numbe
         free(frame);
         return NULL;
     }
+    engine_counter_alloc(sizeof(video_frame_t));
+    engine_counter_alloc(frame_size);
     
     // Generate test pattern (normally would decode actual video data)
     uint8_t* pixel = frame->data;
@@ -101,6 +107,7 @@ video_frame_t* video_decoder_get_frame(video_decoder_t* decoder, int frame_numbe
         }
     }
     
+    TRACE_END(trace_decode, "decode", "get_frame", frame_number);
     return frame;
 }
 
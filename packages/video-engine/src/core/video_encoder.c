@@ -1,14 +1,13 @@
 #include "../include/video_encoder.h"
 #include "../include/video_engine.h"
 #include "../include/effects_engine.h"
+#include "../include/engine_trace.h"
+#include "../include/handle_table.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 
-// Global export job for JavaScript integration
-static export_job_t* g_export_job = NULL;
-
 // Create video encoder
 video_encoder_t* video_encoder_create(int width, int height, double fps) {
     if (width <= 0 || height <= 0 || fps <= 0) return NULL;
@@ -103,6 +102,8 @@ bool video_encoder_start_export(video_encoder_t* encoder, const char* output_pat
 bool video_encoder_add_frame(video_encoder_t* encoder, uint8_t* frame_data, double timestamp) {
     if (!encoder || !frame_data || !encoder->is_recording) return false;
 
+    TRACE_BEGIN(trace_encode);
+
     // Copy frame data to internal buffer
     memcpy(encoder->frame_buffer, frame_data, encoder->frame_buffer_size);
 
@@ -111,6 +112,8 @@ bool video_encoder_add_frame(video_encoder_t* encoder, uint8_t* frame_data, doub
     encoder->frames_exported++;
     encoder->frame_count++;
 
+    TRACE_END(trace_encode, "encode", "add_frame", encoder->frames_exported - 1);
+
     return true;
 }
 
@@ -150,10 +153,14 @@ bool video_encoder_finish_export(video_encoder_t* encoder) {
     return true;
 }
 
-// Cancel export process
+// Cancel export process, abandoning the frame being processed
 void video_encoder_cancel_export(video_encoder_t* encoder) {
     if (!encoder) return;
 
+    if (encoder->effects_engine) {
+        effects_engine_cancel(encoder->effects_engine);
+    }
+
     encoder->is_recording = false;
     encoder->export_started = false;
     encoder->export_progress = 0.0;
@@ -229,17 +236,22 @@ void export_job_destroy(export_job_t* job) {
         video_encoder_destroy(job->encoder);
     }
 
+    quality_metrics_destroy(job->qa_metrics);
+    free(job->qa_reference);
     free(job);
 }
 
 // Configure export job
 bool export_job_configure(export_job_t* job, int output_width, int output_height, double output_fps, const char* output_path) {
     if (!job || !output_path) return false;
+    // A truncated path would export to a different file
+    size_t path_length = strnlen(output_path, sizeof(job->output_path));
+    if (path_length >= sizeof(job->output_path)) return false;
 
     job->output_width = output_width;
     job->output_height = output_height;
     job->output_fps = output_fps;
-    job->output_path = output_path;
+    memcpy(job->output_path, output_path, path_length + 1);
 
     // Create encoder with output settings
     if (job->encoder) {
@@ -265,7 +277,7 @@ bool export_job_set_effects_engine(export_job_t* job, effects_engine_t* effects_
 
 // Start export job
 bool export_job_start(export_job_t* job) {
-    if (!job || !job->encoder || !job->output_path) return false;
+    if (!job || !job->encoder || job->output_path[0] == '\0') return false;
 
     if (!video_encoder_start_export(job->encoder, job->output_path)) {
         strcpy(job->error_message, "Failed to start video encoder");
@@ -280,6 +292,35 @@ bool export_job_start(export_job_t* job) {
     return true;
 }
 
+static bool prepare_qa_reference(export_job_t* job) {
+    size_t size = (size_t)job->source_width * job->source_height * 4;
+    if (size == job->qa_reference_size) return true;
+
+    uint8_t* data = realloc(job->qa_reference, size);
+    if (!data) return false;
+
+    job->qa_reference = data;
+    job->qa_reference_size = size;
+    return true;
+}
+
+// Render the reference for an exported frame and compare the two. The
+// reference is the plain chain at full quality, bypassing deadline and
+// preview shortcuts, so faster engine paths show up as quality loss.
+static void check_qa_frame(export_job_t* job, uint8_t* exported, double timestamp) {
+    video_frame_t reference = {job->qa_reference, job->source_width, job->source_height,
+                               job->source_width * 4, 1, timestamp, job->processed_frames};
+    video_frame_t output = reference;
+    output.data = exported;
+
+    TRACE_BEGIN(trace_qa);
+    effects_engine_lock_chain(job->effects_engine);
+    bool rendered = effects_process_frame_chain(job->effects_engine->chain, &reference, timestamp);
+    effects_engine_unlock_chain(job->effects_engine);
+    if (rendered) quality_metrics_compare(job->qa_metrics, &output, &reference, QUALITY_METRIC_ALL, NULL);
+    TRACE_END(trace_qa, "export", "qa_compare", job->processed_frames);
+}
+
 // Process frame in export job
 bool export_job_process_frame(export_job_t* job, uint8_t* frame_data, double timestamp) {
     if (!job || !job->encoder || !frame_data || !job->is_running) return false;
@@ -289,10 +330,22 @@ bool export_job_process_frame(export_job_t* job, uint8_t* frame_data, double tim
         return true; // Skip frame, but not an error
     }
 
+    // QA: keep the source for the reference render
+    bool qa = job->qa_metrics && job->effects_engine && prepare_qa_reference(job);
+    if (qa) {
+        memcpy(job->qa_reference, frame_data, job->qa_reference_size);
+    }
+
     // Process frame with effects and export
+    TRACE_BEGIN(trace_export);
     bool success = video_encoder_process_and_export_frame(
         job->encoder, frame_data, job->source_width, job->source_height, timestamp
     );
+    TRACE_END(trace_export, "export", "process_frame", job->processed_frames);
+
+    if (success && qa) {
+        check_qa_frame(job, frame_data, timestamp);
+    }
 
     if (success) {
         job->processed_frames++;
@@ -332,68 +385,92 @@ double export_job_get_progress(export_job_t* job) {
     return video_encoder_get_progress(job->encoder);
 }
 
+// Turn QA mode on or off. Enabling starts a new summary.
+bool export_job_set_qa(export_job_t* job, bool enabled) {
+    if (!job) return false;
+
+    if (!enabled) {
+        quality_metrics_destroy(job->qa_metrics);
+        job->qa_metrics = NULL;
+        return true;
+    }
+
+    if (!job->qa_metrics) {
+        job->qa_metrics = quality_metrics_create();
+        if (!job->qa_metrics) return false;
+    }
+    quality_metrics_reset(job->qa_metrics);
+    return true;
+}
+
+// Quality of the frames exported so far in QA mode (NULL when QA is off)
+const quality_summary_t* export_job_get_qa_summary(export_job_t* job) {
+    if (!job || !job->qa_metrics) return NULL;
+    return &job->qa_metrics->summary;
+}
+
 // ============================================================================
 // JavaScript Bindings
 // ============================================================================
 
 // Create video encoder from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_create(int width, int height, double fps) {
+engine_handle_t js_video_encoder_create(int width, int height, double fps) {
     video_encoder_t* encoder = video_encoder_create(width, height, fps);
-    return (int)(uintptr_t)encoder;
+    engine_handle_t handle = handle_register(encoder, HANDLE_TYPE_ENCODER);
+    if (handle == HANDLE_INVALID) video_encoder_destroy(encoder);
+    return handle;
 }
 
 // Destroy video encoder from JavaScript
 EMSCRIPTEN_KEEPALIVE
-void js_video_encoder_destroy(int encoder_ptr) {
-    if (encoder_ptr == 0) return;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+void js_video_encoder_destroy(engine_handle_t encoder_handle) {
+    video_encoder_t* encoder = handle_release(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return;
     video_encoder_destroy(encoder);
 }
 
 // Start export from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_start_export(int encoder_ptr, const char* output_path) {
-    if (encoder_ptr == 0) return 0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+int js_video_encoder_start_export(engine_handle_t encoder_handle, const char* output_path) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return 0;
     return video_encoder_start_export(encoder, output_path) ? 1 : 0;
 }
 
 // Add frame from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_add_frame(int encoder_ptr, uint8_t* frame_data, double timestamp) {
-    if (encoder_ptr == 0 || !frame_data) return 0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+int js_video_encoder_add_frame(engine_handle_t encoder_handle, uint8_t* frame_data, double timestamp) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder || !frame_data) return 0;
     return video_encoder_add_frame(encoder, frame_data, timestamp) ? 1 : 0;
 }
 
 // Finish export from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_finish_export(int encoder_ptr) {
-    if (encoder_ptr == 0) return 0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+int js_video_encoder_finish_export(engine_handle_t encoder_handle) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return 0;
     return video_encoder_finish_export(encoder) ? 1 : 0;
 }
 
 // Cancel export from JavaScript
 EMSCRIPTEN_KEEPALIVE
-void js_video_encoder_cancel_export(int encoder_ptr) {
-    if (encoder_ptr == 0) return;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+void js_video_encoder_cancel_export(engine_handle_t encoder_handle) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return;
     video_encoder_cancel_export(encoder);
 }
 
 // Set effects engine from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_set_effects_engine(int encoder_ptr, int effects_engine_ptr) {
-    if (encoder_ptr == 0) return 0;
-
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
-    effects_engine_t* effects_engine = NULL;
+int js_video_encoder_set_effects_engine(engine_handle_t encoder_handle, engine_handle_t effects_engine_handle) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return 0;
 
-    if (effects_engine_ptr != 0) {
-        effects_engine = (effects_engine_t*)(uintptr_t)effects_engine_ptr;
-    }
+    // Handle 0 detaches; a stale handle is an error rather than a detach
+    effects_engine_t* effects_engine = handle_get(effects_engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!effects_engine && effects_engine_handle != HANDLE_INVALID) return 0;
 
     encoder->effects_engine = effects_engine;
     return 1;
@@ -401,9 +478,9 @@ int js_video_encoder_set_effects_engine(int encoder_ptr, int effects_engine_ptr)
 
 // Process and export frame from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_process_and_export_frame(int encoder_ptr, uint8_t* frame_data, int width, int height, double timestamp) {
-    if (encoder_ptr == 0 || !frame_data) return 0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+int js_video_encoder_process_and_export_frame(engine_handle_t encoder_handle, uint8_t* frame_data, int width, int height, double timestamp) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder || !frame_data) return 0;
     return video_encoder_process_and_export_frame(encoder, frame_data, width, height, timestamp) ? 1 : 0;
 }
 
@@ -411,117 +488,129 @@ int js_video_encoder_process_and_export_frame(int encoder_ptr, uint8_t* frame_da
 
 // Create export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_export_job_create(int source_width, int source_height, double source_fps, double duration) {
+engine_handle_t js_export_job_create(int source_width, int source_height, double source_fps, double duration) {
     export_job_t* job = export_job_create(source_width, source_height, source_fps, duration);
-    if (job) {
-        g_export_job = job; // Store global reference for convenience
-    }
-    return (int)(uintptr_t)job;
+    engine_handle_t handle = handle_register(job, HANDLE_TYPE_EXPORT_JOB);
+    if (handle == HANDLE_INVALID) export_job_destroy(job);
+    return handle;
 }
 
 // Destroy export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-void js_export_job_destroy(int job_ptr) {
-    if (job_ptr == 0) return;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
-    if (g_export_job == job) {
-        g_export_job = NULL;
-    }
+void js_export_job_destroy(engine_handle_t job_handle) {
+    export_job_t* job = handle_release(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return;
     export_job_destroy(job);
 }
 
 // Configure export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_export_job_configure(int job_ptr, int output_width, int output_height, double output_fps, const char* output_path) {
-    if (job_ptr == 0) return 0;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
+int js_export_job_configure(engine_handle_t job_handle, int output_width, int output_height, double output_fps, const char* output_path) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return 0;
     return export_job_configure(job, output_width, output_height, output_fps, output_path) ? 1 : 0;
 }
 
 // Set effects engine for export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_export_job_set_effects_engine(int job_ptr, int effects_engine_ptr) {
-    if (job_ptr == 0) return 0;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
-    effects_engine_t* effects_engine = (effects_engine_ptr != 0) ?
-        (effects_engine_t*)(uintptr_t)effects_engine_ptr : NULL;
+int js_export_job_set_effects_engine(engine_handle_t job_handle, engine_handle_t effects_engine_handle) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return 0;
+    effects_engine_t* effects_engine = handle_get(effects_engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!effects_engine && effects_engine_handle != HANDLE_INVALID) return 0;
     return export_job_set_effects_engine(job, effects_engine) ? 1 : 0;
 }
 
 // Start export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_export_job_start(int job_ptr) {
-    if (job_ptr == 0) return 0;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
+int js_export_job_start(engine_handle_t job_handle) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return 0;
     return export_job_start(job) ? 1 : 0;
 }
 
 // Process frame in export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_export_job_process_frame(int job_ptr, uint8_t* frame_data, double timestamp) {
-    if (job_ptr == 0 || !frame_data) return 0;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
+int js_export_job_process_frame(engine_handle_t job_handle, uint8_t* frame_data, double timestamp) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job || !frame_data) return 0;
     return export_job_process_frame(job, frame_data, timestamp) ? 1 : 0;
 }
 
 // Finish export job from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_export_job_finish(int job_ptr) {
-    if (job_ptr == 0) return 0;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
+int js_export_job_finish(engine_handle_t job_handle) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return 0;
     return export_job_finish(job) ? 1 : 0;
 }
 
 // Get export job progress from JavaScript
 EMSCRIPTEN_KEEPALIVE
-double js_export_job_get_progress(int job_ptr) {
-    if (job_ptr == 0) return 0.0;
-    export_job_t* job = (export_job_t*)(uintptr_t)job_ptr;
+double js_export_job_get_progress(engine_handle_t job_handle) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return 0.0;
     return export_job_get_progress(job);
 }
 
+// Toggle QA comparison of exported frames from JavaScript
+EMSCRIPTEN_KEEPALIVE
+int js_export_job_set_qa(engine_handle_t job_handle, int enabled) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return 0;
+    return export_job_set_qa(job, enabled != 0) ? 1 : 0;
+}
+
+// Pointer to the QA quality_summary_t (0 when QA is off)
+EMSCRIPTEN_KEEPALIVE
+const quality_summary_t* js_export_job_get_qa_summary(engine_handle_t job_handle) {
+    export_job_t* job = handle_get(job_handle, HANDLE_TYPE_EXPORT_JOB);
+    if (!job) return NULL;
+    return export_job_get_qa_summary(job);
+}
+
 // Configuration JavaScript bindings
 
 EMSCRIPTEN_KEEPALIVE
-void js_video_encoder_set_quality(int encoder_ptr, int quality) {
-    if (encoder_ptr == 0) return;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+void js_video_encoder_set_quality(engine_handle_t encoder_handle, int quality) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return;
     video_encoder_set_quality(encoder, quality);
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_video_encoder_set_bitrate(int encoder_ptr, int bitrate) {
-    if (encoder_ptr == 0) return;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+void js_video_encoder_set_bitrate(engine_handle_t encoder_handle, int bitrate) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return;
     video_encoder_set_bitrate(encoder, bitrate);
 }
 
 EMSCRIPTEN_KEEPALIVE
-void js_video_encoder_set_format(int encoder_ptr, const char* format) {
-    if (encoder_ptr == 0) return;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+void js_video_encoder_set_format(engine_handle_t encoder_handle, const char* format) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return;
     video_encoder_set_format(encoder, format);
 }
 
 // Status JavaScript bindings
 
 EMSCRIPTEN_KEEPALIVE
-double js_video_encoder_get_progress(int encoder_ptr) {
-    if (encoder_ptr == 0) return 0.0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+double js_video_encoder_get_progress(engine_handle_t encoder_handle) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return 0.0;
     return video_encoder_get_progress(encoder);
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_get_frames_exported(int encoder_ptr) {
-    if (encoder_ptr == 0) return 0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+int js_video_encoder_get_frames_exported(engine_handle_t encoder_handle) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return 0;
     return video_encoder_get_frames_exported(encoder);
 }
 
 EMSCRIPTEN_KEEPALIVE
-int js_video_encoder_is_exporting(int encoder_ptr) {
-    if (encoder_ptr == 0) return 0;
-    video_encoder_t* encoder = (video_encoder_t*)(uintptr_t)encoder_ptr;
+int js_video_encoder_is_exporting(engine_handle_t encoder_handle) {
+    video_encoder_t* encoder = handle_get(encoder_handle, HANDLE_TYPE_ENCODER);
+    if (!encoder) return 0;
     return video_encoder_is_exporting(encoder) ? 1 : 0;
 }
\ No newline at end of file
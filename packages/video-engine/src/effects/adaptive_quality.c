@@ -0,0 +1,81 @@
+#include "../include/adaptive_quality.h"
+#include <string.h>
+
+// Weight of a new measurement; ~10 frames to adapt to a changed machine load
+#define COST_MODEL_ALPHA 0.2
+
+// Starting estimates (ns per unit) for an unmeasured kernel, deliberately on
+// the slow side so a new chain starts at a cheap level and then recovers
+static const double cost_priors[EFFECT_COST_COUNT] = {
+    [EFFECT_COST_COLOR_CORRECTION] = 40.0,
+    [EFFECT_COST_BLUR] = 3.0,
+    [EFFECT_COST_SHARPEN] = 25.0,
+    [EFFECT_COST_EDGE_DETECTION] = 30.0,
+    [EFFECT_COST_NOISE_REDUCTION] = 40.0,
+    [EFFECT_COST_FILTER] = 20.0,
+    [EFFECT_COST_TRANSFORM] = 40.0,
+    [EFFECT_COST_TRANSFORM_NEAREST] = 15.0,
+    [EFFECT_COST_RESAMPLE] = 15.0,
+};
+
+static const char* cost_kind_names[EFFECT_COST_COUNT] = {
+    [EFFECT_COST_COLOR_CORRECTION] = "color_correction",
+    [EFFECT_COST_BLUR] = "blur",
+    [EFFECT_COST_SHARPEN] = "sharpen",
+    [EFFECT_COST_EDGE_DETECTION] = "edge_detection",
+    [EFFECT_COST_NOISE_REDUCTION] = "noise_reduction",
+    [EFFECT_COST_FILTER] = "filter",
+    [EFFECT_COST_TRANSFORM] = "transform",
+    [EFFECT_COST_TRANSFORM_NEAREST] = "transform_nearest",
+    [EFFECT_COST_RESAMPLE] = "resample",
+};
+
+void effect_cost_model_init(effect_cost_model_t* model) {
+    if (!model) return;
+
+    memset(model, 0, sizeof(effect_cost_model_t));
+    for (int i = 0; i < EFFECT_COST_COUNT; i++) {
+        model->ns_per_unit[i] = cost_priors[i];
+    }
+}
+
+// Fold one measured kernel run into the model
+void effect_cost_model_record(effect_cost_model_t* model, effect_cost_kind_t kind,
+                              double units, uint64_t elapsed_ns) {
+    if (!model || kind < 0 || kind >= EFFECT_COST_COUNT || units <= 0.0) return;
+
+    double sample = (double)elapsed_ns / units;
+    if (model->samples[kind] == 0) {
+        model->ns_per_unit[kind] = sample; // First measurement replaces the prior
+    } else {
+        model->ns_per_unit[kind] += COST_MODEL_ALPHA * (sample - model->ns_per_unit[kind]);
+    }
+    model->samples[kind]++;
+}
+
+// Predicted nanoseconds for `units` of work on a kernel
+double effect_cost_model_estimate(const effect_cost_model_t* model, effect_cost_kind_t kind, double units) {
+    if (!model || kind < 0 || kind >= EFFECT_COST_COUNT || units <= 0.0) return 0.0;
+
+    return model->ns_per_unit[kind] * units;
+}
+
+// Downscale factor of the proxy frame a level renders at
+int render_quality_proxy_factor(render_quality_t quality) {
+    switch (quality) {
+        case RENDER_QUALITY_HALF: return 2;
+        case RENDER_QUALITY_QUARTER: return 4;
+        default: return 1;
+    }
+}
+
+// Whether a level uses the cheaper kernel variants
+bool render_quality_reduced(render_quality_t quality) {
+    return quality >= RENDER_QUALITY_REDUCED;
+}
+
+// Stable kernel name for profiles and traces
+const char* effect_cost_kind_name(effect_cost_kind_t kind) {
+    if (kind < 0 || kind >= EFFECT_COST_COUNT) return "unknown";
+    return cost_kind_names[kind];
+}
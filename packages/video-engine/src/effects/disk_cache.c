@@ -0,0 +1,551 @@
+#include "../include/disk_cache.h"
+#include "../include/engine_counters.h"
+#include "../include/engine_log.h"
+#include "../include/engine_trace.h"
+#include "../include/qoi_codec.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if DISK_CACHE_AVAILABLE
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DISK_CACHE_MAGIC 0x43445645u // "EVDC"
+#define DISK_CACHE_VERSION 1
+#define DISK_CACHE_FLAG_COMPRESSED 1u
+#define DISK_CACHE_PATH_MAX 4096
+
+// File header, in native byte order: the cache never leaves the machine
+typedef struct disk_cache_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t width;
+    uint32_t height;
+    uint64_t key;
+    uint64_t payload_size;
+} disk_cache_header_t;
+
+typedef struct disk_cache_entry_t {
+    uint64_t key;
+    uint64_t size;                 // File size
+    int64_t last_used;             // Wall-clock ns, matches file mtimes
+} disk_cache_entry_t;
+
+typedef struct disk_cache_write_t {
+    uint64_t key;
+    int width;
+    int height;
+    struct disk_cache_write_t* next;
+    uint8_t data[];                // Raw RGBA
+} disk_cache_write_t;
+
+struct disk_cache_t {
+    char directory[DISK_CACHE_PATH_MAX - 512]; // Room for file names
+    uint64_t budget;
+    uint64_t used;
+
+    pthread_mutex_t lock;          // Guards everything below
+    pthread_cond_t work_available;
+    pthread_cond_t idle;
+    disk_cache_entry_t* entries;   // Files on disk, unordered
+    int entry_count;
+    int entry_capacity;
+    disk_cache_write_t* queue_head;
+    disk_cache_write_t* queue_tail;
+    size_t pending_bytes;
+    bool closing;
+
+    pthread_t writer;
+    uint8_t* scratch;              // Writer-only encoder output
+    size_t scratch_capacity;
+};
+
+// Temporary file names are unique per write: two caches in one process may
+// write the same key to one directory
+static atomic_uint_fast64_t temp_sequence;
+
+static int64_t wall_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Key a frame is stored under: callers' keys name the source and chain, and
+// the render version keeps frames from builds with other kernels apart
+static uint64_t file_key(uint64_t key) {
+    return key ^ ((uint64_t)VIDEO_ENGINE_RENDER_VERSION * 0x9E3779B97F4A7C15ull);
+}
+
+static void entry_path(const disk_cache_t* cache, uint64_t key, char* path) {
+    snprintf(path, DISK_CACHE_PATH_MAX, "%s/%016" PRIx64 ".frame", cache->directory, key);
+}
+
+// Caller holds the lock
+static disk_cache_entry_t* find_entry(disk_cache_t* cache, uint64_t key) {
+    for (int i = 0; i < cache->entry_count; i++) {
+        if (cache->entries[i].key == key) return &cache->entries[i];
+    }
+    return NULL;
+}
+
+// Caller holds the lock
+static void remove_entry(disk_cache_t* cache, disk_cache_entry_t* entry) {
+    cache->used -= entry->size;
+    *entry = cache->entries[--cache->entry_count];
+}
+
+// Caller holds the lock
+static bool put_entry(disk_cache_t* cache, uint64_t key, uint64_t size, int64_t last_used) {
+    disk_cache_entry_t* entry = find_entry(cache, key);
+    if (!entry) {
+        if (cache->entry_count == cache->entry_capacity) {
+            int capacity = cache->entry_capacity ? cache->entry_capacity * 2 : 256;
+            disk_cache_entry_t* entries = realloc(cache->entries, capacity * sizeof(disk_cache_entry_t));
+            if (!entries) return false;
+            cache->entries = entries;
+            cache->entry_capacity = capacity;
+        }
+        entry = &cache->entries[cache->entry_count++];
+        entry->key = key;
+        entry->size = 0;
+    }
+
+    cache->used += size - entry->size;
+    entry->size = size;
+    entry->last_used = last_used;
+    return true;
+}
+
+// Delete least recently used files until the cache fits its budget. Caller
+// holds the lock.
+static void evict_locked(disk_cache_t* cache) {
+    char path[DISK_CACHE_PATH_MAX];
+    while (cache->used > cache->budget && cache->entry_count > 0) {
+        disk_cache_entry_t* oldest = &cache->entries[0];
+        for (int i = 1; i < cache->entry_count; i++) {
+            if (cache->entries[i].last_used < oldest->last_used) oldest = &cache->entries[i];
+        }
+        entry_path(cache, oldest->key, path);
+        unlink(path);
+        remove_entry(cache, oldest);
+    }
+}
+
+static bool write_all(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void* data, size_t size) {
+    uint8_t* bytes = data;
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        size -= (size_t)got;
+    }
+    return true;
+}
+
+// Encode and write one queued frame, then index it. Runs on the writer thread.
+static void write_frame(disk_cache_t* cache, const disk_cache_write_t* job) {
+    size_t pixel_count = (size_t)job->width * job->height;
+    size_t raw_size = pixel_count * 4;
+
+    if (raw_size > cache->scratch_capacity) {
+        uint8_t* scratch = realloc(cache->scratch, raw_size);
+        if (scratch) {
+            engine_counter_alloc(raw_size);
+            cache->scratch = scratch;
+            cache->scratch_capacity = raw_size;
+        }
+    }
+
+    disk_cache_header_t header = {0};
+    header.magic = DISK_CACHE_MAGIC;
+    header.version = DISK_CACHE_VERSION;
+    header.width = (uint32_t)job->width;
+    header.height = (uint32_t)job->height;
+    header.key = job->key;
+
+    const uint8_t* payload = job->data;
+    header.payload_size = raw_size;
+    size_t encoded = raw_size <= cache->scratch_capacity
+                         ? qoi_encode(job->data, pixel_count, cache->scratch, raw_size - 1)
+                         : 0;
+    if (encoded > 0) {
+        payload = cache->scratch;
+        header.payload_size = encoded;
+        header.flags = DISK_CACHE_FLAG_COMPRESSED;
+    }
+
+    char path[DISK_CACHE_PATH_MAX];
+    char temp_path[DISK_CACHE_PATH_MAX];
+    entry_path(cache, job->key, path);
+    snprintf(temp_path, sizeof(temp_path), "%s/%016" PRIx64 ".frame.tmp%ld.%" PRIuFAST64, cache->directory,
+             job->key, (long)getpid(), atomic_fetch_add(&temp_sequence, 1));
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG_WARN("Disk cache: cannot create the file for frame %016" PRIx64 " (errno %d)", job->key, errno);
+        engine_counter_add(ENGINE_COUNTER_DISK_CACHE_DROPPED, 1);
+        return;
+    }
+
+    TRACE_BEGIN(trace_write);
+    bool ok = write_all(fd, &header, sizeof(header)) && write_all(fd, payload, header.payload_size);
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(temp_path, path) == 0;
+    TRACE_END(trace_write, "disk_cache", "write", TRACE_NO_FRAME);
+    if (!ok) {
+        unlink(temp_path);
+        engine_counter_add(ENGINE_COUNTER_DISK_CACHE_DROPPED, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    if (put_entry(cache, job->key, sizeof(header) + header.payload_size, wall_time_ns())) {
+        evict_locked(cache);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    engine_counter_add(ENGINE_COUNTER_DISK_CACHE_WRITES, 1);
+}
+
+static void* writer_main(void* arg) {
+    disk_cache_t* cache = arg;
+    engine_trace_set_thread_name("disk cache writer");
+
+    pthread_mutex_lock(&cache->lock);
+    for (;;) {
+        while (!cache->queue_head && !cache->closing) {
+            pthread_cond_wait(&cache->work_available, &cache->lock);
+        }
+        // Queued frames are written out before closing
+        disk_cache_write_t* job = cache->queue_head;
+        if (!job) break;
+
+        // The job stays queued while it is written, so lookups keep finding
+        // it until the file is in place. Only this thread removes jobs and
+        // stores only append, so it is still the head afterwards.
+        pthread_mutex_unlock(&cache->lock);
+        write_frame(cache, job);
+        engine_counters_publish();
+
+        pthread_mutex_lock(&cache->lock);
+        cache->queue_head = job->next;
+        if (!cache->queue_head) cache->queue_tail = NULL;
+        cache->pending_bytes -= (size_t)job->width * job->height * 4;
+        free(job);
+        pthread_cond_broadcast(&cache->idle);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return NULL;
+}
+
+// Index the frames in the directory and remove temporaries left by writers
+// that died mid-write
+static void scan_directory(disk_cache_t* cache) {
+    DIR* dir = opendir(cache->directory);
+    if (!dir) return;
+
+    char path[DISK_CACHE_PATH_MAX];
+    int64_t stale_ns = wall_time_ns() - (int64_t)DISK_CACHE_STALE_TMP_SECONDS * 1000000000;
+    struct dirent* dirent;
+    while ((dirent = readdir(dir)) != NULL) {
+        uint64_t key;
+        int length = 0;
+        if (sscanf(dirent->d_name, "%16" SCNx64 ".frame%n", &key, &length) != 1 || length != 22) continue;
+
+        snprintf(path, sizeof(path), "%s/%s", cache->directory, dirent->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) continue;
+
+        int64_t mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        if (dirent->d_name[length] == '\0') {
+            put_entry(cache, key, (uint64_t)st.st_size, mtime_ns);
+        } else if (strncmp(dirent->d_name + length, ".tmp", 4) == 0 && mtime_ns < stale_ns) {
+            unlink(path);
+        }
+    }
+    closedir(dir);
+}
+
+disk_cache_t* disk_cache_open(const char* directory, uint64_t budget) {
+    if (!directory || strlen(directory) >= sizeof(((disk_cache_t*)0)->directory)) return NULL;
+
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        LOG_ERROR("Disk cache: cannot create the cache directory (errno %d)", errno);
+        return NULL;
+    }
+
+    disk_cache_t* cache = malloc(sizeof(disk_cache_t));
+    if (!cache) return NULL;
+
+    memset(cache, 0, sizeof(disk_cache_t));
+    strcpy(cache->directory, directory);
+    cache->budget = budget;
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->work_available, NULL);
+    pthread_cond_init(&cache->idle, NULL);
+
+    scan_directory(cache);
+    evict_locked(cache);
+
+    if (pthread_create(&cache->writer, NULL, writer_main, cache) != 0) {
+        pthread_cond_destroy(&cache->idle);
+        pthread_cond_destroy(&cache->work_available);
+        pthread_mutex_destroy(&cache->lock);
+        free(cache->entries);
+        free(cache);
+        return NULL;
+    }
+
+    LOG_INFO("Disk cache: %d frames (%" PRIu64 " MB)", cache->entry_count, cache->used >> 20);
+    return cache;
+}
+
+void disk_cache_close(disk_cache_t* cache) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->lock);
+    cache->closing = true;
+    pthread_cond_broadcast(&cache->work_available);
+    pthread_mutex_unlock(&cache->lock);
+    pthread_join(cache->writer, NULL);
+
+    pthread_cond_destroy(&cache->idle);
+    pthread_cond_destroy(&cache->work_available);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->entries);
+    free(cache->scratch);
+    free(cache);
+}
+
+void disk_cache_set_budget(disk_cache_t* cache, uint64_t budget) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->lock);
+    cache->budget = budget;
+    evict_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+uint64_t disk_cache_get_used(disk_cache_t* cache) {
+    if (!cache) return 0;
+
+    pthread_mutex_lock(&cache->lock);
+    uint64_t used = cache->used;
+    pthread_mutex_unlock(&cache->lock);
+    return used;
+}
+
+// Caller holds the lock
+static disk_cache_write_t* find_queued(disk_cache_t* cache, uint64_t key) {
+    for (disk_cache_write_t* job = cache->queue_head; job; job = job->next) {
+        if (job->key == key) return job;
+    }
+    return NULL;
+}
+
+static void forget_entry(disk_cache_t* cache, uint64_t key) {
+    pthread_mutex_lock(&cache->lock);
+    disk_cache_entry_t* entry = find_entry(cache, key);
+    if (entry) remove_entry(cache, entry);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// Read and validate the file for key into frame
+static bool read_frame(disk_cache_t* cache, uint64_t key, video_frame_t* frame, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        // Possibly evicted by another process sharing the directory
+        forget_entry(cache, key);
+        return false;
+    }
+
+    // Validated in full before any pixel is read: on a miss the caller
+    // renders the frame's current contents
+    size_t pixel_count = (size_t)frame->width * frame->height;
+    disk_cache_header_t header;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && read_all(fd, &header, sizeof(header)) &&
+              header.magic == DISK_CACHE_MAGIC && header.version == DISK_CACHE_VERSION &&
+              header.key == key && header.payload_size <= pixel_count * 4 &&
+              (uint64_t)st.st_size == sizeof(header) + header.payload_size;
+    // A different size under the same key is another rendition, not damage
+    bool other_size = ok && (header.width != (uint32_t)frame->width || header.height != (uint32_t)frame->height);
+
+    if (ok && !other_size) {
+        if (header.flags & DISK_CACHE_FLAG_COMPRESSED) {
+            uint8_t* data = malloc(header.payload_size);
+            ok = data != NULL;
+            if (data) {
+                engine_counter_alloc(header.payload_size);
+                ok = read_all(fd, data, header.payload_size) &&
+                     qoi_decode(data, header.payload_size, frame->data, pixel_count);
+                free(data);
+            }
+        } else {
+            ok = header.payload_size == pixel_count * 4 && read_all(fd, frame->data, header.payload_size);
+        }
+    }
+    close(fd);
+
+    if (!ok) {
+        // Truncated or corrupt (e.g. lost in a crash after the rename)
+        unlink(path);
+        forget_entry(cache, key);
+    }
+    return ok && !other_size;
+}
+
+bool disk_cache_lookup(disk_cache_t* cache, uint64_t key, video_frame_t* frame) {
+    if (!cache || !frame || !frame->data || key == 0) return false;
+
+    key = file_key(key);
+    size_t frame_size = (size_t)frame->width * frame->height * 4;
+
+    // A frame still waiting for the writer is served from memory
+    pthread_mutex_lock(&cache->lock);
+    disk_cache_write_t* job = find_queued(cache, key);
+    if (job && job->width == frame->width && job->height == frame->height) {
+        memcpy(frame->data, job->data, frame_size);
+        pthread_mutex_unlock(&cache->lock);
+        engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, frame_size);
+        engine_counter_add(ENGINE_COUNTER_DISK_CACHE_HITS, 1);
+        return true;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    // Not indexed is no proof of absence: another process may have written it
+    char path[DISK_CACHE_PATH_MAX];
+    entry_path(cache, key, path);
+    TRACE_BEGIN(trace_read);
+    bool hit = read_frame(cache, key, frame, path);
+    TRACE_END(trace_read, "disk_cache", hit ? "read" : "miss", frame->frame_number);
+    if (!hit) return false;
+
+    // Refresh the mtime so recency survives restarts
+    int64_t now = wall_time_ns();
+    utimensat(AT_FDCWD, path, NULL, 0);
+
+    struct stat st;
+    uint64_t size = stat(path, &st) == 0 ? (uint64_t)st.st_size : 0;
+    pthread_mutex_lock(&cache->lock);
+    if (size > 0 && put_entry(cache, key, size, now)) evict_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+
+    engine_counter_add(ENGINE_COUNTER_DISK_CACHE_HITS, 1);
+    return true;
+}
+
+bool disk_cache_store(disk_cache_t* cache, uint64_t key, const video_frame_t* frame) {
+    if (!cache || !frame || !frame->data || key == 0) return false;
+
+    key = file_key(key);
+    size_t frame_size = (size_t)frame->width * frame->height * 4;
+
+    pthread_mutex_lock(&cache->lock);
+    bool known = find_entry(cache, key) || find_queued(cache, key);
+    bool full = cache->pending_bytes + frame_size > DISK_CACHE_MAX_PENDING;
+    pthread_mutex_unlock(&cache->lock);
+
+    // A key names its pixels, so a frame already written needs no rewrite
+    if (known) return true;
+    if (full) {
+        engine_counter_add(ENGINE_COUNTER_DISK_CACHE_DROPPED, 1);
+        return false;
+    }
+
+    disk_cache_write_t* job = malloc(sizeof(disk_cache_write_t) + frame_size);
+    if (!job) return false;
+    engine_counter_alloc(sizeof(disk_cache_write_t) + frame_size);
+
+    job->key = key;
+    job->width = frame->width;
+    job->height = frame->height;
+    job->next = NULL;
+    memcpy(job->data, frame->data, frame_size);
+
+    pthread_mutex_lock(&cache->lock);
+    if (cache->queue_tail) {
+        cache->queue_tail->next = job;
+    } else {
+        cache->queue_head = job;
+    }
+    cache->queue_tail = job;
+    cache->pending_bytes += frame_size;
+    pthread_cond_signal(&cache->work_available);
+    pthread_mutex_unlock(&cache->lock);
+    return true;
+}
+
+void disk_cache_flush(disk_cache_t* cache) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->lock);
+    while (cache->queue_head) {
+        pthread_cond_wait(&cache->idle, &cache->lock);
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+#else // !DISK_CACHE_AVAILABLE
+
+disk_cache_t* disk_cache_open(const char* directory, uint64_t budget) {
+    (void)directory;
+    (void)budget;
+    return NULL;
+}
+
+void disk_cache_close(disk_cache_t* cache) {
+    (void)cache;
+}
+
+void disk_cache_set_budget(disk_cache_t* cache, uint64_t budget) {
+    (void)cache;
+    (void)budget;
+}
+
+uint64_t disk_cache_get_used(disk_cache_t* cache) {
+    (void)cache;
+    return 0;
+}
+
+bool disk_cache_lookup(disk_cache_t* cache, uint64_t key, video_frame_t* frame) {
+    (void)cache;
+    (void)key;
+    (void)frame;
+    return false;
+}
+
+bool disk_cache_store(disk_cache_t* cache, uint64_t key, const video_frame_t* frame) {
+    (void)cache;
+    (void)key;
+    (void)frame;
+    return false;
+}
+
+void disk_cache_flush(disk_cache_t* cache) {
+    (void)cache;
+}
+
+#endif // DISK_CACHE_AVAILABLE
@@ -0,0 +1,539 @@
+#include "../include/effect_chain_serial.h"
+#include "../include/engine_log.h"
+#include "../include/handle_table.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EFFECT_FLAG_ENABLED 0x1
+#define LEGACY_MAX_KEYFRAMES 8 // Version 1 stored an unused f32 curve
+
+#define FNV_OFFSET 0xCBF29CE484222325ull
+#define FNV_PRIME 0x100000001B3ull
+
+// Serializes into a buffer or, in canonical mode, feeds a hash. Sharing one
+// encoder keeps the hash and the format describing the same fields.
+typedef struct chain_writer_t {
+    uint8_t* out;
+    size_t capacity;
+    size_t size;
+    bool canonical;
+    uint64_t hash;
+} chain_writer_t;
+
+typedef struct chain_reader_t {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+} chain_reader_t;
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+static void write_bytes(chain_writer_t* w, const uint8_t* bytes, size_t count) {
+    if (w->canonical) {
+        for (size_t i = 0; i < count; i++) {
+            w->hash = (w->hash ^ bytes[i]) * FNV_PRIME;
+        }
+        return;
+    }
+
+    if (w->out && w->size + count <= w->capacity) {
+        memcpy(w->out + w->size, bytes, count);
+    }
+    w->size += count;
+}
+
+static void write_u8(chain_writer_t* w, uint8_t value) {
+    write_bytes(w, &value, 1);
+}
+
+static void write_u16(chain_writer_t* w, uint16_t value) {
+    uint8_t bytes[2] = {(uint8_t)value, (uint8_t)(value >> 8)};
+    write_bytes(w, bytes, 2);
+}
+
+static void write_u32(chain_writer_t* w, uint32_t value) {
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    write_bytes(w, bytes, 4);
+}
+
+static void write_i32(chain_writer_t* w, int32_t value) {
+    write_u32(w, (uint32_t)value);
+}
+
+static void write_u64(chain_writer_t* w, uint64_t value) {
+    write_u32(w, (uint32_t)value);
+    write_u32(w, (uint32_t)(value >> 32));
+}
+
+// Canonical floats: -0 becomes 0, every NaN the same NaN, and the mantissa
+// is rounded to 15 bits so slider noise far below one 8-bit output level
+// does not split a look into two cache entries
+static void write_f32(chain_writer_t* w, float value) {
+    uint32_t bits;
+    if (w->canonical) {
+        if (value == 0.0f) value = 0.0f;
+        memcpy(&bits, &value, sizeof(bits));
+        if (isnan(value)) {
+            bits = 0x7FC00000u;
+        } else if (!isinf(value)) {
+            bits = (bits + 0x80u) & ~0xFFu;
+        }
+    } else {
+        memcpy(&bits, &value, sizeof(bits));
+    }
+    write_u32(w, bits);
+}
+
+static void write_f64(chain_writer_t* w, double value) {
+    uint64_t bits;
+    if (w->canonical && value == 0.0) value = 0.0;
+    memcpy(&bits, &value, sizeof(bits));
+    if (w->canonical && isnan(value)) bits = 0x7FF8000000000000ull;
+    write_u64(w, bits);
+}
+
+// Parameters the effect's type uses, in a fixed order
+static void write_params(chain_writer_t* w, const effect_t* effect) {
+    switch (effect->type) {
+        case EFFECT_TYPE_FILTER: {
+            const filter_params_t* p = &effect->params.filter;
+            write_i32(w, (int32_t)p->type);
+            write_f32(w, p->intensity);
+            write_f32(w, p->param1);
+            write_f32(w, p->param2);
+            write_f32(w, p->param3);
+            write_u8(w, p->enabled ? 1 : 0);
+            break;
+        }
+        case EFFECT_TYPE_TRANSITION: {
+            const transition_params_t* p = &effect->params.transition;
+            write_i32(w, (int32_t)p->type);
+            write_f32(w, p->duration);
+            write_f32(w, p->progress);
+            write_f32(w, p->ease_in);
+            write_f32(w, p->ease_out);
+            break;
+        }
+        case EFFECT_TYPE_TRANSFORM: {
+            const transform_params_t* p = &effect->params.transform;
+            write_f32(w, p->scale);
+            write_f32(w, p->rotation);
+            write_i32(w, p->flip_horizontal);
+            write_i32(w, p->flip_vertical);
+            write_i32(w, p->crop_x);
+            write_i32(w, p->crop_y);
+            write_i32(w, p->crop_width);
+            write_i32(w, p->crop_height);
+            write_i32(w, p->interpolation);
+            break;
+        }
+        case EFFECT_TYPE_COLOR_CORRECTION: {
+            const color_correction_t* p = &effect->params.color_correction;
+            write_f32(w, p->brightness);
+            write_f32(w, p->contrast);
+            write_f32(w, p->saturation);
+            write_f32(w, p->hue);
+            write_f32(w, p->gamma);
+            write_f32(w, p->exposure);
+            break;
+        }
+        case EFFECT_TYPE_BLUR: {
+            const blur_params_t* p = &effect->params.blur;
+            write_f32(w, p->radius);
+            write_i32(w, p->iterations);
+            write_u8(w, p->gaussian ? 1 : 0);
+            break;
+        }
+    }
+}
+
+static void write_tracks(chain_writer_t* w, const effect_t* effect) {
+    int count = effect->track_count;
+    if (count < 0) count = 0;
+    if (count > EFFECT_MAX_TRACKS) count = EFFECT_MAX_TRACKS;
+
+    write_i32(w, count);
+    for (int t = 0; t < count; t++) {
+        const keyframe_track_t* track = &effect->tracks[t];
+        int keys = track->count < KEYFRAME_TRACK_MAX_KEYS ? track->count : KEYFRAME_TRACK_MAX_KEYS;
+        write_u8(w, track->param);
+        write_u8(w, (uint8_t)keys);
+        write_u16(w, 0);
+        for (int k = 0; k < keys; k++) {
+            const keyframe_t* key = &track->keys[k];
+            write_u8(w, track->interpolation[k]);
+            write_f32(w, key->time);
+            write_f32(w, key->value);
+            for (int e = 0; e < 4; e++) {
+                write_f32(w, key->ease[e]);
+            }
+        }
+    }
+}
+
+static int order_compare(const void* a, const void* b) {
+    int64_t key_a = *(const int64_t*)a;
+    int64_t key_b = *(const int64_t*)b;
+    return key_a < key_b ? -1 : key_a > key_b;
+}
+
+// Chain indices in processing order (effect_chain_sort is stable, so this
+// matches the order the chain runs in even before it is sorted). NULL on
+// allocation failure; the caller frees the array.
+static int* processing_order(const effect_chain_t* chain) {
+    int count = chain->count;
+    int64_t* keys = malloc(sizeof(int64_t) * (count > 0 ? count : 1));
+    int* order = malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!keys || !order) {
+        free(keys);
+        free(order);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        keys[i] = ((int64_t)chain->effects[i].priority << 32) | i;
+    }
+    if (!chain->sorted) qsort(keys, count, sizeof(int64_t), order_compare);
+    for (int i = 0; i < count; i++) {
+        order[i] = (int)(keys[i] & 0xFFFFFFFF);
+    }
+    free(keys);
+    return order;
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+size_t effect_chain_serialize(const effect_chain_t* chain, uint8_t* out, size_t capacity) {
+    if (!chain) return 0;
+
+    chain_writer_t w = {out, capacity, 0, false, 0};
+    write_u32(&w, CHAIN_SERIAL_MAGIC);
+    write_u16(&w, CHAIN_SERIAL_VERSION);
+    write_u16(&w, (uint16_t)chain->count);
+
+    for (int i = 0; i < chain->count; i++) {
+        const effect_t* effect = &chain->effects[i];
+        write_u8(&w, (uint8_t)effect->type);
+        write_u8(&w, effect->enabled ? EFFECT_FLAG_ENABLED : 0);
+        write_u8(&w, (uint8_t)effect->priority);
+        write_u8(&w, 0);
+        write_f64(&w, effect->start_time);
+        write_f64(&w, effect->end_time);
+        write_params(&w, effect);
+        write_tracks(&w, effect);
+    }
+
+    return w.size;
+}
+
+static const uint8_t* read_bytes(chain_reader_t* r, size_t count) {
+    if (r->failed || r->offset + count > r->size) {
+        r->failed = true;
+        return NULL;
+    }
+    const uint8_t* bytes = r->data + r->offset;
+    r->offset += count;
+    return bytes;
+}
+
+static uint8_t read_u8(chain_reader_t* r) {
+    const uint8_t* b = read_bytes(r, 1);
+    return b ? b[0] : 0;
+}
+
+static uint16_t read_u16(chain_reader_t* r) {
+    const uint8_t* b = read_bytes(r, 2);
+    return b ? (uint16_t)(b[0] | (b[1] << 8)) : 0;
+}
+
+static uint32_t read_u32(chain_reader_t* r) {
+    const uint8_t* b = read_bytes(r, 4);
+    return b ? (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24) : 0;
+}
+
+static int32_t read_i32(chain_reader_t* r) {
+    return (int32_t)read_u32(r);
+}
+
+static float read_f32(chain_reader_t* r) {
+    uint32_t bits = read_u32(r);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static double read_f64(chain_reader_t* r) {
+    uint64_t bits = read_u32(r);
+    bits |= (uint64_t)read_u32(r) << 32;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Keyframe tracks, validated so evaluation can trust them
+static bool read_tracks(chain_reader_t* r, effect_t* effect) {
+    int count = read_i32(r);
+    if (count < 0 || count > EFFECT_MAX_TRACKS) return false;
+
+    for (int t = 0; t < count; t++) {
+        keyframe_track_t* track = &effect->tracks[t];
+        track->param = read_u8(r);
+        track->count = read_u8(r);
+        read_u16(r);
+        if (track->param >= EFFECT_PARAM_COUNT || track->count == 0 || track->count > KEYFRAME_TRACK_MAX_KEYS) {
+            return false;
+        }
+
+        for (int k = 0; k < track->count; k++) {
+            keyframe_t* key = &track->keys[k];
+            track->interpolation[k] = read_u8(r);
+            key->time = read_f32(r);
+            key->value = read_f32(r);
+            for (int e = 0; e < 4; e++) {
+                key->ease[e] = read_f32(r);
+            }
+            if (track->interpolation[k] >= KEYFRAME_INTERP_COUNT || !isfinite(key->time) ||
+                (k > 0 && key->time <= track->keys[k - 1].time)) {
+                return false;
+            }
+        }
+    }
+
+    effect->track_count = count;
+    return true;
+}
+
+static bool read_effect(chain_reader_t* r, int version, effect_t* effect) {
+    memset(effect, 0, sizeof(effect_t));
+    effect->type = (effect_type_t)read_u8(r);
+    effect->enabled = (read_u8(r) & EFFECT_FLAG_ENABLED) != 0;
+    effect->priority = (effect_priority_t)read_u8(r);
+    read_u8(r);
+    effect->start_time = read_f64(r);
+    effect->end_time = read_f64(r);
+
+    switch (effect->type) {
+        case EFFECT_TYPE_FILTER: {
+            filter_params_t* p = &effect->params.filter;
+            p->type = (filter_type_t)read_i32(r);
+            p->intensity = read_f32(r);
+            p->param1 = read_f32(r);
+            p->param2 = read_f32(r);
+            p->param3 = read_f32(r);
+            p->enabled = read_u8(r) != 0;
+            break;
+        }
+        case EFFECT_TYPE_TRANSITION: {
+            transition_params_t* p = &effect->params.transition;
+            p->type = (transition_type_t)read_i32(r);
+            p->duration = read_f32(r);
+            p->progress = read_f32(r);
+            p->ease_in = read_f32(r);
+            p->ease_out = read_f32(r);
+            break;
+        }
+        case EFFECT_TYPE_TRANSFORM: {
+            transform_params_t* p = &effect->params.transform;
+            p->scale = read_f32(r);
+            p->rotation = read_f32(r);
+            p->flip_horizontal = read_i32(r);
+            p->flip_vertical = read_i32(r);
+            p->crop_x = read_i32(r);
+            p->crop_y = read_i32(r);
+            p->crop_width = read_i32(r);
+            p->crop_height = read_i32(r);
+            p->interpolation = read_i32(r);
+            break;
+        }
+        case EFFECT_TYPE_COLOR_CORRECTION: {
+            color_correction_t* p = &effect->params.color_correction;
+            p->brightness = read_f32(r);
+            p->contrast = read_f32(r);
+            p->saturation = read_f32(r);
+            p->hue = read_f32(r);
+            p->gamma = read_f32(r);
+            p->exposure = read_f32(r);
+            break;
+        }
+        case EFFECT_TYPE_BLUR: {
+            blur_params_t* p = &effect->params.blur;
+            p->radius = read_f32(r);
+            p->iterations = read_i32(r);
+            p->gaussian = read_u8(r) != 0;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    if (version == 1) {
+        int keyframes = read_i32(r);
+        if (keyframes < 0 || keyframes > LEGACY_MAX_KEYFRAMES) return false;
+        read_bytes(r, (size_t)keyframes * sizeof(float));
+        return !r->failed;
+    }
+
+    return read_tracks(r, effect) && !r->failed;
+}
+
+bool effect_chain_deserialize(effect_chain_t* chain, const uint8_t* data, size_t size) {
+    if (!chain || !data) return false;
+
+    chain_reader_t r = {data, size, 0, false};
+    uint32_t magic = read_u32(&r);
+    int version = read_u16(&r);
+    if (magic != CHAIN_SERIAL_MAGIC || version < 1 || version > CHAIN_SERIAL_VERSION) {
+        LOG_ERROR("Serialized chain has a bad magic or version");
+        return false;
+    }
+
+    int count = read_u16(&r);
+    if (r.failed || count > EFFECT_CHAIN_MAX_EFFECTS || !effect_chain_reserve(chain, count)) return false;
+
+    // Effects carry their keyframe tracks: too large for a stack copy of a chain
+    effect_t* effects = malloc(sizeof(effect_t) * (count > 0 ? count : 1));
+    if (!effects) return false;
+
+    for (int i = 0; i < count; i++) {
+        if (!read_effect(&r, version, &effects[i])) {
+            LOG_ERROR("Serialized chain effect %d is malformed", i);
+            free(effects);
+            return false;
+        }
+    }
+
+    memcpy(chain->effects, effects, sizeof(effect_t) * count);
+    free(effects);
+    chain->count = count;
+    chain->sorted = false;
+    chain->revision++;
+    return true;
+}
+
+// ============================================================================
+// Canonical hashing
+// ============================================================================
+
+// splitmix64 finalizer, so nearby FNV states spread over all 64 bits
+static uint64_t hash_finish(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+static void hash_effect(chain_writer_t* w, const effect_t* effect, bool with_times) {
+    write_u8(w, (uint8_t)effect->type);
+    if (with_times) {
+        write_f64(w, effect->start_time);
+        write_f64(w, effect->end_time);
+    }
+    write_params(w, effect);
+    write_tracks(w, effect);
+}
+
+// Enabled effects in processing order, with time ranges
+static uint64_t hash_chain(const effect_chain_t* chain) {
+    if (!chain) return 0;
+
+    int* order = processing_order(chain);
+    if (!order) return 0;
+
+    chain_writer_t w = {NULL, 0, 0, true, FNV_OFFSET};
+    uint32_t hashed = 0;
+
+    write_u16(&w, CHAIN_SERIAL_VERSION);
+    for (int i = 0; i < chain->count; i++) {
+        const effect_t* effect = &chain->effects[order[i]];
+        if (!effect->enabled) continue;
+
+        hash_effect(&w, effect, true);
+        hashed++;
+    }
+    write_u32(&w, hashed);
+    free(order);
+
+    return hash_finish(w.hash);
+}
+
+uint64_t effect_chain_hash(const effect_chain_t* chain) {
+    return hash_chain(chain);
+}
+
+// The active plan's effects as evaluated at timestamp, without time ranges
+uint64_t effect_chain_hash_at(effect_chain_t* chain, double timestamp) {
+    const effect_chain_plan_t* plan = effect_chain_plan(chain, timestamp);
+    if (!plan) return 0;
+
+    chain_writer_t w = {NULL, 0, 0, true, FNV_OFFSET};
+    effect_t scratch;
+
+    write_u16(&w, CHAIN_SERIAL_VERSION);
+    for (int p = 0; p < plan->count; p++) {
+        const effect_t* effect = effect_evaluate(&chain->effects[plan->indices[p]], timestamp, NULL, &scratch);
+        hash_effect(&w, effect, false);
+    }
+    write_u32(&w, (uint32_t)plan->count);
+
+    return hash_finish(w.hash);
+}
+
+uint64_t effect_hash(const effect_t* effect, uint64_t seed) {
+    if (!effect) return seed;
+
+    chain_writer_t w = {NULL, 0, 0, true, FNV_OFFSET ^ seed};
+    hash_effect(&w, effect, false);
+    return hash_finish(w.hash);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Serialize the engine's chain; returns the size needed (call with capacity
+// 0 to size the buffer)
+EMSCRIPTEN_KEEPALIVE
+int js_effects_chain_serialize(engine_handle_t engine_handle, uint8_t* out, int capacity) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || capacity < 0) return 0;
+
+    effects_engine_lock_chain(engine);
+    size_t needed = effect_chain_serialize(engine->chain, out, (size_t)capacity);
+    effects_engine_unlock_chain(engine);
+    return (int)needed;
+}
+
+// Replace the engine's chain with a serialized one; 1 on success
+EMSCRIPTEN_KEEPALIVE
+int js_effects_chain_deserialize(engine_handle_t engine_handle, const uint8_t* data, int size) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || !data || size <= 0) return 0;
+
+    effects_engine_lock_chain(engine);
+    bool loaded = effect_chain_deserialize(engine->chain, data, (size_t)size);
+    effects_engine_unlock_chain(engine);
+    return loaded ? 1 : 0;
+}
+
+// Canonical chain hash as 16 hex digits (valid until the next call)
+EMSCRIPTEN_KEEPALIVE
+const char* js_effects_chain_hash(engine_handle_t engine_handle) {
+    static char hex[17];
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return "";
+
+    effects_engine_lock_chain(engine);
+    uint64_t hash = effect_chain_hash(engine->chain);
+    effects_engine_unlock_chain(engine);
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return hex;
+}
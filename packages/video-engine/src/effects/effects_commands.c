@@ -0,0 +1,237 @@
+#include "../include/effects_engine.h"
+#include "../include/engine_log.h"
+#include "../include/handle_table.h"
+#include <math.h>
+#include <string.h>
+
+#define COMMAND_STATUS_FAILED -1
+#define COMMAND_STATUS_NOT_PROCESSED -2
+
+static inline float command_float(const uint32_t* word) {
+    float value;
+    memcpy(&value, word, sizeof(value));
+    return value;
+}
+
+static inline void command_set_float(uint32_t* word, float value) {
+    memcpy(word, &value, sizeof(value));
+}
+
+// Decode one record into a fully initialised effect, matching what the
+// effect_create_* builders produce. False for unknown types.
+static bool decode_record(const uint32_t* record, effect_t* effect) {
+    const uint32_t* params = record + 2;
+
+    memset(effect, 0, sizeof(effect_t));
+    effect->type = (effect_type_t)record[0];
+    effect->enabled = true;
+    effect->start_time = 0.0;
+    effect->end_time = INFINITY;
+
+    switch (effect->type) {
+        case EFFECT_TYPE_COLOR_CORRECTION: {
+            color_correction_t* cc = &effect->params.color_correction;
+            effect->priority = EFFECT_PRIORITY_COLOR_CORRECTION;
+            cc->brightness = command_float(&params[0]);
+            cc->contrast = command_float(&params[1]);
+            cc->saturation = command_float(&params[2]);
+            cc->hue = command_float(&params[3]);
+            cc->gamma = command_float(&params[4]);
+            cc->exposure = command_float(&params[5]);
+            return true;
+        }
+
+        case EFFECT_TYPE_BLUR: {
+            blur_params_t* blur = &effect->params.blur;
+            effect->priority = EFFECT_PRIORITY_FILTER;
+            blur->radius = command_float(&params[0]);
+            blur->gaussian = command_float(&params[1]) != 0.0f;
+            blur->iterations = (int)command_float(&params[2]);
+            if (blur->iterations < 1) blur->iterations = 1;
+            return true;
+        }
+
+        case EFFECT_TYPE_TRANSFORM: {
+            transform_params_t* transform = &effect->params.transform;
+            effect->priority = EFFECT_PRIORITY_TRANSFORM;
+            transform->interpolation = (int)record[1];
+            transform->scale = command_float(&params[0]);
+            transform->rotation = command_float(&params[1]);
+            transform->flip_horizontal = command_float(&params[2]) != 0.0f;
+            transform->flip_vertical = command_float(&params[3]) != 0.0f;
+            transform->crop_x = (int)command_float(&params[4]);
+            transform->crop_y = (int)command_float(&params[5]);
+            transform->crop_width = (int)command_float(&params[6]);
+            transform->crop_height = (int)command_float(&params[7]);
+            return true;
+        }
+
+        case EFFECT_TYPE_FILTER: {
+            filter_params_t* filter = &effect->params.filter;
+            effect->priority = EFFECT_PRIORITY_FILTER;
+            filter->type = (filter_type_t)record[1];
+            filter->intensity = command_float(&params[0]);
+            filter->param1 = command_float(&params[1]);
+            filter->param2 = command_float(&params[2]);
+            filter->param3 = command_float(&params[3]);
+            filter->enabled = true;
+            return true;
+        }
+
+        default:
+            return false; // Transitions need two frames and are not chain effects
+    }
+}
+
+// Apply the buffer's keyframe records to the decoded effects (in submission
+// order). False when a record names a missing effect or a parameter its type
+// lacks, or an effect runs out of tracks or keyframes.
+static bool decode_keyframes(const uint32_t* commands, uint32_t keyframe_count, effect_t* effects, uint32_t count) {
+    for (uint32_t k = 0; k < keyframe_count; k++) {
+        const uint32_t* record = commands + EFFECTS_COMMAND_KEYFRAME_OFFSET + k * EFFECTS_COMMAND_KEYFRAME_WORDS;
+        float ease[4] = {command_float(&record[5]), command_float(&record[6]),
+                         command_float(&record[7]), command_float(&record[8])};
+
+        if (record[0] >= count ||
+            !effect_set_keyframe(&effects[record[0]], (effect_param_t)record[1], command_float(&record[3]),
+                                 command_float(&record[4]), (keyframe_interp_t)record[2], ease)) {
+            LOG_ERROR("Command buffer keyframe %u is invalid", k);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bring the engine's chain in line with a command buffer. Records are
+// ordered by priority the way effect_chain_sort would (stably, so equal
+// priorities keep submission order) and only entries that differ from the
+// current chain are rewritten. Returns the number of effects changed, -1 if
+// the buffer is malformed (the chain is then left untouched).
+int effects_engine_apply_commands(effects_engine_t* engine, uint32_t* commands, size_t size) {
+    if (!engine || !engine->chain || !commands) return -1;
+    if (size < EFFECTS_COMMAND_HEADER_WORDS * sizeof(uint32_t)) return -1;
+    if (commands[EFFECTS_COMMAND_MAGIC_WORD] != EFFECTS_COMMAND_MAGIC ||
+        commands[EFFECTS_COMMAND_VERSION_WORD] != EFFECTS_COMMAND_VERSION) {
+        LOG_ERROR("Command buffer has a bad magic or version");
+        return -1;
+    }
+
+    uint32_t count = commands[EFFECTS_COMMAND_COUNT_WORD];
+    size_t needed = (EFFECTS_COMMAND_HEADER_WORDS + (size_t)count * EFFECTS_COMMAND_RECORD_WORDS) * sizeof(uint32_t);
+    if (count > MAX_EFFECTS_CHAIN || size < needed) {
+        LOG_ERROR("Command buffer holds %u records in %zu bytes", count, size);
+        return -1;
+    }
+
+    uint32_t keyframe_count = commands[EFFECTS_COMMAND_KEYFRAME_COUNT_WORD];
+    if (keyframe_count > 0) {
+        needed = (EFFECTS_COMMAND_KEYFRAME_OFFSET + (size_t)keyframe_count * EFFECTS_COMMAND_KEYFRAME_WORDS) *
+                 sizeof(uint32_t);
+        if (keyframe_count > EFFECTS_COMMAND_MAX_KEYFRAMES || size < needed) {
+            LOG_ERROR("Command buffer holds %u keyframes in %zu bytes", keyframe_count, size);
+            return -1;
+        }
+    }
+
+    // Decoded in submission order, which keyframe records refer to
+    effect_t* decoded = engine->command_effects;
+    int order[MAX_EFFECTS_CHAIN];
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t* record = commands + EFFECTS_COMMAND_HEADER_WORDS + i * EFFECTS_COMMAND_RECORD_WORDS;
+        if (!decode_record(record, &decoded[i])) {
+            LOG_ERROR("Command buffer record %u has unknown effect type %u", i, record[0]);
+            return -1;
+        }
+
+        // Insertion sort by priority
+        int j = (int)i;
+        while (j > 0 && decoded[order[j - 1]].priority > decoded[i].priority) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (int)i;
+    }
+    if (!decode_keyframes(commands, keyframe_count, decoded, count)) return -1;
+
+    // A worker may be rendering the chain being rewritten
+    effects_engine_lock_chain(engine);
+    effect_chain_t* chain = engine->chain;
+    if (!effect_chain_reserve(chain, (int)count)) {
+        effects_engine_unlock_chain(engine);
+        return -1;
+    }
+    if (!chain->sorted) effect_chain_sort(chain);
+
+    // Decoded effects start zeroed, so equal effects compare equal bytewise
+    int changed = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const effect_t* effect = &decoded[order[i]];
+        if ((int)i < chain->count && memcmp(&chain->effects[i], effect, sizeof(effect_t)) == 0) continue;
+        memcpy(&chain->effects[i], effect, sizeof(effect_t));
+        changed++;
+    }
+    if (chain->count > (int)count) changed += chain->count - (int)count;
+
+    chain->count = (int)count;
+    chain->sorted = true;
+    if (changed > 0) chain->revision++;
+    effects_engine_unlock_chain(engine);
+    return changed;
+}
+
+// Apply a command buffer and, if it asks for it, render the session input
+// slot into the output slot. Results are written back into the buffer's
+// result words; the return value is the status word.
+int effects_engine_submit_commands(effects_engine_t* engine, uint32_t* commands, size_t size) {
+    if (!engine || !commands || size < EFFECTS_COMMAND_HEADER_WORDS * sizeof(uint32_t)) {
+        return COMMAND_STATUS_FAILED;
+    }
+
+    int32_t status = COMMAND_STATUS_NOT_PROCESSED;
+    int changed = effects_engine_apply_commands(engine, commands, size);
+
+    if (changed < 0) {
+        status = COMMAND_STATUS_FAILED;
+    } else if (commands[EFFECTS_COMMAND_FLAGS_WORD] & EFFECTS_COMMAND_PROCESS) {
+        double timestamp;
+        memcpy(&timestamp, &commands[EFFECTS_COMMAND_TIMESTAMP_WORD], sizeof(timestamp));
+        float budget_ms = command_float(&commands[EFFECTS_COMMAND_BUDGET_WORD]);
+        uint64_t source_id;
+        memcpy(&source_id, &commands[EFFECTS_COMMAND_SOURCE_WORD], sizeof(source_id));
+        effects_engine_set_source_id(engine, source_id);
+
+        render_quality_t quality;
+        status = effects_engine_process_session(engine, timestamp, budget_ms, &quality)
+                     ? (int32_t)quality : COMMAND_STATUS_FAILED;
+    }
+
+    memcpy(&commands[EFFECTS_COMMAND_STATUS_WORD], &status, sizeof(status));
+    commands[EFFECTS_COMMAND_CHAIN_COUNT_WORD] = (uint32_t)engine->chain->count;
+    commands[EFFECTS_COMMAND_CHANGED_WORD] = changed < 0 ? 0 : (uint32_t)changed;
+    command_set_float(&commands[EFFECTS_COMMAND_PROCESS_MS_WORD], (float)engine->last_process_time_ms);
+    commands[EFFECTS_COMMAND_FRAMES_WORD] = (uint32_t)engine->frames_processed;
+    return status;
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Engine-owned command buffer (EFFECTS_COMMAND_WORDS words); stable for the
+// engine's lifetime
+EMSCRIPTEN_KEEPALIVE
+uint32_t* js_engine_get_command_buffer(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return NULL;
+
+    return engine->commands;
+}
+
+// Submit the engine's command buffer; returns the status word
+EMSCRIPTEN_KEEPALIVE
+int js_engine_submit_commands(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return COMMAND_STATUS_FAILED;
+
+    return effects_engine_submit_commands(engine, engine->commands, sizeof(engine->commands));
+}
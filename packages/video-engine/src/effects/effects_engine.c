@@ -2,19 +2,27 @@
 #include "../include/video_engine.h"
 #include "../include/filters.h"
 #include "../include/transitions.h"
+#include "../include/engine_time.h"
+#include "../include/engine_trace.h"
+#include "../include/engine_counters.h"
+#include "../include/engine_log.h"
+#include "../include/handle_table.h"
+#include "../include/effect_chain_serial.h"
+#include "../include/interval_index.h"
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
 
-// Global effects engine instance
-static effects_engine_t* g_effects_engine = NULL;
+_Static_assert(STAGE_CACHE_STAGES >= MAX_EFFECTS_CHAIN, "stage cache must cover a full chain");
 
-// Comparison function for sorting effects by priority
+// Comparison function for sorting effects by priority: keys hold the
+// priority in the high word and the chain position in the low word
 static int effect_compare(const void* a, const void* b) {
-    const effect_t* effect_a = (const effect_t*)a;
-    const effect_t* effect_b = (const effect_t*)b;
-    return (int)(effect_a->priority - effect_b->priority);
+    int64_t key_a = *(const int64_t*)a;
+    int64_t key_b = *(const int64_t*)b;
+    return key_a < key_b ? -1 : key_a > key_b;
 }
 
 // Create effects engine
@@ -24,22 +32,22 @@ effects_engine_t* effects_engine_create(void) {
 
     memset(engine, 0, sizeof(effects_engine_t));
 
-    // Create memory pool for effects processing
-    engine->memory_pool = memory_pool_create(1920 * 1080 * 4, 8); // 8 RGBA frames
-    if (!engine->memory_pool) {
-        free(engine);
-        return NULL;
-    }
-
     // Create effect chain
     engine->chain = effect_chain_create();
     if (!engine->chain) {
-        memory_pool_destroy(engine->memory_pool);
         free(engine);
         return NULL;
     }
 
-    engine->chain->memory_pool = engine->memory_pool;
+    render_cancel_token_init(&engine->cancel);
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_init(&engine->chain_lock, NULL);
+#endif
+    effect_cost_model_init(&engine->costs);
+    stage_cache_init(&engine->stage_cache, STAGE_CACHE_DEFAULT_BUDGET);
+    result_cache_init(&engine->result_cache, RESULT_CACHE_DEFAULT_BUDGET);
+    engine->render_scale = 1;
+    effects_engine_reset_profile(engine);
     engine->initialized = true;
 
     return engine;
@@ -53,9 +61,14 @@ void effects_engine_destroy(effects_engine_t* engine) {
         effect_chain_destroy(engine->chain);
     }
 
-    if (engine->memory_pool) {
-        memory_pool_destroy(engine->memory_pool);
-    }
+    free(engine->proxy_frame.data);
+    free(engine->refine_band.data);
+    free(engine->input_slot.data); // One allocation backs both slots
+    stage_cache_destroy(&engine->stage_cache);
+    result_cache_destroy(&engine->result_cache);
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_destroy(&engine->chain_lock);
+#endif
 
     if (engine->encoder) {
         // Clean up encoder if exists
@@ -71,7 +84,13 @@ bool effects_engine_init(effects_engine_t* engine) {
 
     engine->frames_processed = 0;
     engine->last_process_time_ms = 0.0;
+    engine->total_process_ns = 0;
     engine->export_mode = false;
+    engine->priority = RENDER_PRIORITY_INTERACTIVE;
+    atomic_store(&engine->processing, false);
+    engine->frames_cancelled = 0;
+    engine->last_frame_cancelled = false;
+    engine->last_quality = RENDER_QUALITY_FULL;
 
     return true;
 }
@@ -93,7 +112,11 @@ effect_chain_t* effect_chain_create(void) {
     memset(chain, 0, sizeof(effect_chain_t));
     chain->count = 0;
     chain->sorted = true;
-    chain->temp_frames_allocated = false;
+
+    if (!effect_chain_reserve(chain, MAX_EFFECTS_CHAIN)) {
+        free(chain);
+        return NULL;
+    }
 
     return chain;
 }
@@ -102,37 +125,55 @@ effect_chain_t* effect_chain_create(void) {
 void effect_chain_destroy(effect_chain_t* chain) {
     if (!chain) return;
 
-    // Clean up temporary frames
-    if (chain->temp_frames_allocated) {
-        if (chain->temp_frame_1) {
-            if (chain->memory_pool && chain->temp_frame_1->data) {
-                memory_pool_free(chain->memory_pool, chain->temp_frame_1->data);
-            }
-            free(chain->temp_frame_1);
-        }
-        if (chain->temp_frame_2) {
-            if (chain->memory_pool && chain->temp_frame_2->data) {
-                memory_pool_free(chain->memory_pool, chain->temp_frame_2->data);
-            }
-            free(chain->temp_frame_2);
-        }
-    }
-
+    interval_index_free(&chain->index);
+    free(chain->effects);
+    free(chain->keyframe_hints);
     free(chain);
 }
 
-// Add effect to chain
+bool effect_chain_reserve(effect_chain_t* chain, int capacity) {
+    if (!chain || capacity > EFFECT_CHAIN_MAX_EFFECTS) return false;
+    if (capacity <= chain->capacity) return true;
+
+    int grown = chain->capacity > 0 ? chain->capacity : MAX_EFFECTS_CHAIN;
+    while (grown < capacity) grown *= 2;
+    if (grown > EFFECT_CHAIN_MAX_EFFECTS) grown = EFFECT_CHAIN_MAX_EFFECTS;
+
+    effect_t* effects = realloc(chain->effects, sizeof(effect_t) * grown);
+    if (!effects) return false;
+    chain->effects = effects;
+
+    uint8_t (*hints)[EFFECT_MAX_TRACKS] = realloc(chain->keyframe_hints, sizeof(*hints) * grown);
+    if (!hints) return false;
+    memset(hints + chain->capacity, 0, sizeof(*hints) * (grown - chain->capacity));
+    chain->keyframe_hints = hints;
+
+    engine_counter_alloc((sizeof(effect_t) + sizeof(*hints)) * (size_t)(grown - chain->capacity));
+    chain->capacity = grown;
+    return true;
+}
+
+// Add effect to chain, after the effects of its priority or a more urgent
+// one, so the index returned is its place in processing order
 int effect_chain_add(effect_chain_t* chain, effect_t* effect) {
-    if (!chain || !effect || chain->count >= MAX_EFFECTS_CHAIN) {
+    if (!chain || !effect || !effect_chain_reserve(chain, chain->count + 1)) {
         return -1;
     }
+    effect_chain_sort(chain);
+
+    // Effects usually arrive in processing order, which appends
+    int index = chain->count;
+    while (index > 0 && chain->effects[index - 1].priority > effect->priority) index--;
 
-    // Copy effect to chain
-    memcpy(&chain->effects[chain->count], effect, sizeof(effect_t));
+    int tail = chain->count - index;
+    memmove(&chain->effects[index + 1], &chain->effects[index], sizeof(effect_t) * tail);
+    memmove(&chain->keyframe_hints[index + 1], &chain->keyframe_hints[index], sizeof(chain->keyframe_hints[0]) * tail);
+    memcpy(&chain->effects[index], effect, sizeof(effect_t));
+    memset(&chain->keyframe_hints[index], 0, sizeof(chain->keyframe_hints[0]));
     chain->count++;
-    chain->sorted = false;
+    chain->revision++;
 
-    return chain->count - 1;
+    return index;
 }
 
 // Remove effect from chain
@@ -142,11 +183,12 @@ bool effect_chain_remove(effect_chain_t* chain, int index) {
     }
 
     // Shift effects down
-    for (int i = index; i < chain->count - 1; i++) {
-        memcpy(&chain->effects[i], &chain->effects[i + 1], sizeof(effect_t));
-    }
+    memmove(&chain->effects[index], &chain->effects[index + 1], sizeof(effect_t) * (chain->count - index - 1));
+    memmove(&chain->keyframe_hints[index], &chain->keyframe_hints[index + 1],
+            sizeof(chain->keyframe_hints[0]) * (chain->count - index - 1));
 
     chain->count--;
+    chain->revision++;
     return true;
 }
 
@@ -156,159 +198,1011 @@ void effect_chain_clear(effect_chain_t* chain) {
 
     chain->count = 0;
     chain->sorted = true;
+    chain->revision++;
 }
 
-// Sort effects by priority
+// Sort effects by priority. Stable, so effects of equal priority keep the
+// order they were added in and a chain has one processing order to hash.
+// Effects are moved once each, which matters on timeline-length chains.
 void effect_chain_sort(effect_chain_t* chain) {
     if (!chain || chain->count <= 1 || chain->sorted) return;
 
-    qsort(chain->effects, chain->count, sizeof(effect_t), effect_compare);
+    int count = chain->count;
+    int64_t* keys = malloc(sizeof(int64_t) * count);
+    effect_t* sorted = malloc(sizeof(effect_t) * count);
+    uint8_t (*hints)[EFFECT_MAX_TRACKS] = malloc(sizeof(*hints) * count);
+    if (!keys || !sorted || !hints) {
+        free(keys);
+        free(sorted);
+        free(hints);
+        LOG_ERROR("Out of memory sorting a chain of %d effects", count);
+        return;
+    }
+
+    // Priority, then position: equal priorities keep their order
+    for (int i = 0; i < count; i++) {
+        keys[i] = ((int64_t)chain->effects[i].priority << 32) | i;
+    }
+    qsort(keys, count, sizeof(int64_t), effect_compare);
+
+    for (int i = 0; i < count; i++) {
+        int from = (int)(keys[i] & 0xFFFFFFFF);
+        memcpy(&sorted[i], &chain->effects[from], sizeof(effect_t));
+        memcpy(&hints[i], &chain->keyframe_hints[from], sizeof(*hints));
+    }
+    memcpy(chain->effects, sorted, sizeof(effect_t) * count);
+    memcpy(chain->keyframe_hints, hints, sizeof(*hints) * count);
+    free(keys);
+    free(sorted);
+    free(hints);
+
+    // Indices moved: the interval index and plan refer to the old order
+    chain->index_valid = false;
+    chain->plan.valid = false;
     chain->sorted = true;
 }
 
-// Allocate temporary frames for processing
-static bool allocate_temp_frames(effect_chain_t* chain, int width, int height) {
-    if (!chain || !chain->memory_pool) return false;
+// Enabled effects in processing order with their time ranges; NaN bounds
+// never excluded a timestamp, so they index as unbounded
+static bool build_chain_index(effect_chain_t* chain) {
+    int count = chain->count;
+    double* starts = malloc(sizeof(double) * (count > 0 ? count : 1));
+    double* ends = malloc(sizeof(double) * (count > 0 ? count : 1));
+    int* ids = malloc(sizeof(int) * (count > 0 ? count : 1));
+    bool built = false;
+
+    if (starts && ends && ids) {
+        int indexed = 0;
+        for (int i = 0; i < count; i++) {
+            const effect_t* effect = &chain->effects[i];
+            if (!effect->enabled) continue;
+
+            starts[indexed] = isnan(effect->start_time) ? -INFINITY : effect->start_time;
+            ends[indexed] = isnan(effect->end_time) ? INFINITY : effect->end_time;
+            ids[indexed] = i;
+            indexed++;
+        }
+        built = interval_index_build(&chain->index, starts, ends, ids, indexed);
+    }
+
+    free(starts);
+    free(ends);
+    free(ids);
+    if (!built) {
+        LOG_ERROR("Out of memory indexing a chain of %d effects", count);
+        return false;
+    }
 
-    if (chain->temp_frames_allocated) return true;
+    chain->index_revision = chain->revision;
+    chain->index_valid = true;
+    return true;
+}
 
-    // Allocate frame structures
-    chain->temp_frame_1 = malloc(sizeof(video_frame_t));
-    chain->temp_frame_2 = malloc(sizeof(video_frame_t));
+static int index_compare(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
 
-    if (!chain->temp_frame_1 || !chain->temp_frame_2) {
-        return false;
+const effect_chain_plan_t* effect_chain_plan(effect_chain_t* chain, double timestamp) {
+    if (!chain) return NULL;
+
+    if (!chain->sorted) effect_chain_sort(chain);
+
+    effect_chain_plan_t* plan = &chain->plan;
+    if (plan->valid && plan->revision == chain->revision && interval_window_contains(&plan->window, timestamp)) {
+        return plan;
     }
 
-    // Allocate frame data from memory pool
-    int frame_size = width * height * 4; // RGBA
-    chain->temp_frame_1->data = memory_pool_alloc(chain->memory_pool);
-    chain->temp_frame_2->data = memory_pool_alloc(chain->memory_pool);
+    if (!chain->index_valid || chain->index_revision != chain->revision) {
+        if (!build_chain_index(chain)) return NULL;
+    }
 
-    if (!chain->temp_frame_1->data || !chain->temp_frame_2->data) {
-        return false;
+    // Hits come in start order; chain order is processing order once sorted
+    int hit_count;
+    int* hits = interval_index_query(&chain->index, timestamp, &hit_count, &plan->window);
+    qsort(hits, hit_count, sizeof(int), index_compare);
+
+    if (hit_count > MAX_EFFECTS_CHAIN) {
+        LOG_WARN("%d effects active at %.3fs; only the first %d run", hit_count, timestamp, MAX_EFFECTS_CHAIN);
+        hit_count = MAX_EFFECTS_CHAIN;
+    }
+    memcpy(plan->indices, hits, sizeof(int) * hit_count);
+    plan->count = hit_count;
+    plan->revision = chain->revision;
+    plan->valid = true;
+    engine_counter_add(ENGINE_COUNTER_PLAN_BUILDS, 1);
+    return plan;
+}
+
+// Blur radius an effect runs with at a quality level on a frame at 1/scale
+// of the source resolution. Spatial radii shrink with the frame so the
+// preview looks like the full-resolution result. Other spatial parameters
+// (vignette geometry, transform crop) are already relative to the frame.
+static int effective_blur_radius(float radius, render_quality_t quality, int scale) {
+    radius /= (float)(render_quality_proxy_factor(quality) * scale);
+    if (render_quality_reduced(quality)) radius *= 0.5f;
+    return (int)radius;
+}
+
+// Neutral settings, which users leave behind when stacking effects
+static bool color_correction_is_identity(const color_correction_t* p) {
+    return p->brightness == 0.0f && p->contrast == 0.0f && p->saturation == 0.0f &&
+           p->hue == 0.0f && p->gamma == 1.0f && p->exposure == 0.0f;
+}
+
+static bool transform_is_identity(const transform_params_t* p) {
+    return p->scale == 100.0f && p->rotation == 0.0f && !p->flip_horizontal && !p->flip_vertical &&
+           p->crop_x == 0 && p->crop_y == 0 && p->crop_width >= 100 && p->crop_height >= 100;
+}
+
+// Kernel an effect runs at a quality level and its work in cost units for a
+// frame of `pixels` pixels. Returns false when the effect does nothing, so
+// the chain skips it: neutral settings, zero intensity, or a radius below
+// one pixel.
+static bool effect_cost(const effect_t* effect, render_quality_t quality, int scale, double pixels,
+                        effect_cost_kind_t* kind, double* units) {
+    bool reduced = render_quality_reduced(quality);
+    float intensity = effect->params.filter.intensity;
+    int radius;
+
+    *units = pixels;
+    switch (effect->type) {
+        case EFFECT_TYPE_COLOR_CORRECTION:
+            *kind = EFFECT_COST_COLOR_CORRECTION;
+            return !color_correction_is_identity(&effect->params.color_correction);
+
+        case EFFECT_TYPE_BLUR:
+            radius = effective_blur_radius(effect->params.blur.radius, quality, scale);
+            *kind = EFFECT_COST_BLUR;
+            *units = pixels * 2.0 * (2 * radius + 1); // Two separable passes
+            return radius > 0;
+
+        case EFFECT_TYPE_FILTER:
+            switch (effect->params.filter.type) {
+                case FILTER_BLUR:
+                    radius = effective_blur_radius(effect->params.filter.intensity * 20.0f, quality, scale);
+                    *kind = EFFECT_COST_BLUR;
+                    *units = pixels * 2.0 * (2 * radius + 1);
+                    return radius > 0;
+                case FILTER_SHARPEN:
+                    *kind = EFFECT_COST_SHARPEN;
+                    return intensity != 0.0f;
+                case FILTER_EDGE_DETECTION:
+                    *kind = EFFECT_COST_EDGE_DETECTION;
+                    return intensity > 0.0f;
+                case FILTER_NOISE_REDUCTION:
+                    *kind = EFFECT_COST_NOISE_REDUCTION;
+                    return !reduced && intensity > 0.0f; // Denoise is skipped at reduced quality
+                default:
+                    // filter_apply ignores disabled filters and types it lacks;
+                    // chains run the rest as color corrections
+                    *kind = EFFECT_COST_FILTER;
+                    return effect->params.filter.enabled && effect->params.filter.type <= FILTER_HUE &&
+                           intensity != 0.0f;
+            }
+
+        case EFFECT_TYPE_TRANSFORM:
+            *kind = reduced ? EFFECT_COST_TRANSFORM_NEAREST : EFFECT_COST_TRANSFORM;
+            return !transform_is_identity(&effect->params.transform);
+
+        case EFFECT_TYPE_TRANSITION:
+            // Transitions require two frames - handled separately
+            return false;
     }
 
-    // Initialize frame metadata
-    chain->temp_frame_1->width = width;
-    chain->temp_frame_1->height = height;
-    chain->temp_frame_1->stride = width * 4;
-    chain->temp_frame_1->format = 1; // RGBA
+    return false;
+}
 
-    chain->temp_frame_2->width = width;
-    chain->temp_frame_2->height = height;
-    chain->temp_frame_2->stride = width * 4;
-    chain->temp_frame_2->format = 1; // RGBA
+// Brightness, contrast, saturation and hue filters are one-parameter color
+// corrections, which is how filter_apply runs them. Rewritten as one in
+// scratch (which may already hold the effect), they are skipped when
+// neutral and share a pass with the color corrections next to them.
+static const effect_t* as_color_correction(const effect_t* effect, effect_t* scratch) {
+    const filter_params_t* filter = &effect->params.filter;
+    if (effect->type != EFFECT_TYPE_FILTER || !filter->enabled || filter->type > FILTER_HUE) return effect;
+
+    color_correction_t params = {0};
+    params.gamma = 1.0f;
+    switch (filter->type) {
+        case FILTER_BRIGHTNESS:
+            params.brightness = filter->intensity;
+            break;
+        case FILTER_CONTRAST:
+            params.contrast = filter->intensity;
+            break;
+        case FILTER_SATURATION:
+            params.saturation = filter->intensity;
+            break;
+        default:
+            params.hue = filter->intensity * 180.0f; // Degrees
+            break;
+    }
 
-    chain->temp_frames_allocated = true;
-    return true;
+    if (scratch != effect) memcpy(scratch, effect, sizeof(effect_t));
+    scratch->type = EFFECT_TYPE_COLOR_CORRECTION;
+    scratch->params.color_correction = params;
+    return scratch;
 }
 
-// Process frame through effect chain
-bool effects_process_frame_chain(effect_chain_t* chain, video_frame_t* frame, double timestamp) {
+// Whether a color correction can share a pass with the color correction
+// after it. Tone curves compose exactly through their 8-bit LUTs, but
+// saturation and hue mix channels after the curve, so only the last of a
+// shared pass may adjust them.
+static bool folds_into(const effect_t* effect, const effect_t* next) {
+    return effect->type == EFFECT_TYPE_COLOR_CORRECTION && next->type == EFFECT_TYPE_COLOR_CORRECTION &&
+           effect->params.color_correction.saturation == 0.0f && effect->params.color_correction.hue == 0.0f;
+}
+
+// Rows above and below an output row that an effect reads at full quality,
+// or -1 when every output pixel may depend on the whole frame
+static int effect_reach(const effect_t* effect, int scale) {
+    switch (effect->type) {
+        case EFFECT_TYPE_BLUR:
+            return effective_blur_radius(effect->params.blur.radius, RENDER_QUALITY_FULL, scale);
+
+        case EFFECT_TYPE_FILTER:
+            switch (effect->params.filter.type) {
+                case FILTER_BLUR:
+                    return effective_blur_radius(effect->params.filter.intensity * 20.0f, RENDER_QUALITY_FULL, scale);
+                case FILTER_SHARPEN:
+                case FILTER_EDGE_DETECTION:
+                case FILTER_NOISE_REDUCTION:
+                    return 1; // 3x3 kernels
+                default:
+                    return 0;
+            }
+
+        case EFFECT_TYPE_TRANSFORM:
+            return -1; // Rotation and scaling move pixels across the frame
+
+        case EFFECT_TYPE_COLOR_CORRECTION:
+        case EFFECT_TYPE_TRANSITION:
+            return 0;
+    }
+
+    return -1;
+}
+
+// The chain's tone LUT for a color correction, rebuilding the least
+// recently used one only when no LUT matches its values
+static const color_lut_t* chain_color_lut(effect_chain_t* chain, const color_correction_t* params) {
+    float key[4] = {params->brightness, params->contrast, params->gamma, params->exposure};
+    int slot = 0;
+    for (int i = 0; i < EFFECT_CHAIN_LUTS; i++) {
+        color_lut_t* lut = &chain->luts[i];
+        if (lut->valid && memcmp(lut->key, key, sizeof(key)) == 0) {
+            slot = i;
+            break;
+        }
+        if (chain->lut_last_used[i] < chain->lut_last_used[slot]) slot = i;
+    }
+
+    chain->lut_last_used[slot] = ++chain->lut_clock;
+    if (color_lut_prepare(&chain->luts[slot], params)) {
+        engine_counter_add(ENGINE_COUNTER_LUT_REBUILDS, 1);
+    }
+    return &chain->luts[slot];
+}
+
+// Run one effect's kernel on a frame at a quality level and scale
+static void apply_effect(effect_chain_t* chain, const effect_t* effect, video_frame_t* frame,
+                         render_quality_t quality, int scale) {
+    switch (effect->type) {
+        case EFFECT_TYPE_COLOR_CORRECTION: {
+            const color_correction_t* params = &effect->params.color_correction;
+            filter_color_correction_lut(frame, params, chain_color_lut(chain, params));
+            break;
+        }
+
+        case EFFECT_TYPE_BLUR: {
+            blur_params_t params = effect->params.blur;
+            params.radius = (float)effective_blur_radius(params.radius, quality, scale);
+            filter_blur(frame, &params);
+            break;
+        }
+
+        case EFFECT_TYPE_FILTER:
+            switch (effect->params.filter.type) {
+                case FILTER_BLUR: {
+                    // Same mapping as filter_apply, but with the radius adjusted
+                    blur_params_t params;
+                    params.radius = (float)effective_blur_radius(effect->params.filter.intensity * 20.0f, quality, scale);
+                    params.gaussian = true;
+                    params.iterations = 1;
+                    filter_blur(frame, &params);
+                    break;
+                }
+                case FILTER_SHARPEN:
+                    filter_sharpen(frame, effect->params.filter.intensity);
+                    break;
+                case FILTER_EDGE_DETECTION:
+                    filter_edge_detection_new(frame, effect->params.filter.intensity);
+                    break;
+                case FILTER_NOISE_REDUCTION:
+                    if (!render_quality_reduced(quality)) {
+                        filter_noise_reduction(frame, effect->params.filter.intensity);
+                    }
+                    break;
+                default: {
+                    filter_params_t params = effect->params.filter;
+                    filter_apply(frame, &params);
+                    break;
+                }
+            }
+            break;
+
+        case EFFECT_TYPE_TRANSFORM: {
+            transform_params_t params = effect->params.transform;
+            if (render_quality_reduced(quality)) {
+                params.interpolation = TRANSFORM_INTERP_NEAREST;
+            }
+            filter_transform(frame, &params);
+            break;
+        }
+
+        case EFFECT_TYPE_TRANSITION:
+            // Transitions require two frames - handled separately
+            break;
+    }
+}
+
+// Run one stage of the chain: a single effect, or adjacent color
+// corrections as one pass with their tone LUTs composed
+static void apply_stage(effect_chain_t* chain, const effect_t* const* effects, int count, video_frame_t* frame,
+                        render_quality_t quality, int scale) {
+    if (count == 1) {
+        apply_effect(chain, effects[0], frame, quality, scale);
+        return;
+    }
+
+    color_lut_t composed;
+    memcpy(composed.tone, chain_color_lut(chain, &effects[0]->params.color_correction)->tone, sizeof(composed.tone));
+    for (int i = 1; i < count; i++) {
+        const color_lut_t* lut = chain_color_lut(chain, &effects[i]->params.color_correction);
+        for (int level = 0; level < 256; level++) {
+            composed.tone[level] = lut->tone[composed.tone[level]];
+        }
+    }
+    composed.valid = true;
+    filter_color_correction_lut(frame, &effects[count - 1]->params.color_correction, &composed);
+}
+
+// Run the chain on a frame at a quality level (the frame is already at the
+// level's resolution, and at 1/scale of the source's before that). Timings
+// go to the engine's cost model and profile when an engine is given. With
+// an engine whose caller named the source, the stage cache keeps the input
+// of the effect being edited and the chain resumes from it.
+static bool process_chain(effect_chain_t* chain, video_frame_t* frame, double timestamp,
+                          render_quality_t quality, int scale, effects_engine_t* engine) {
     if (!chain || !frame || chain->count == 0) {
         return true; // No effects to apply
     }
 
-    // Sort effects if needed
-    if (!chain->sorted) {
-        effect_chain_sort(chain);
+    double pixels = (double)frame->width * frame->height;
+
+    // Effects that do something at this timestamp and quality, in priority
+    // order, with keyframed parameters evaluated at the timestamp. Each
+    // stage is one pass over the frame: stage s runs effects [first[s],
+    // first[s + 1]), more than one only for adjacent color corrections.
+    const effect_chain_plan_t* plan = effect_chain_plan(chain, timestamp);
+    if (!plan) return false;
+
+    const effect_t* effects[MAX_EFFECTS_CHAIN];
+    int first[MAX_EFFECTS_CHAIN + 1];
+    effect_cost_kind_t kinds[MAX_EFFECTS_CHAIN];
+    double units[MAX_EFFECTS_CHAIN];
+    int effect_count = 0;
+    int stage_count = 0;
+    for (int p = 0; p < plan->count; p++) {
+        int i = plan->indices[p];
+        const effect_t* effect = effect_evaluate(&chain->effects[i], timestamp, chain->keyframe_hints[i],
+                                                 &chain->evaluated[p]);
+        effect = as_color_correction(effect, &chain->evaluated[p]);
+        if (!effect_cost(effect, quality, scale, pixels, &kinds[stage_count], &units[stage_count])) continue;
+
+        if (effect_count == 0 || !folds_into(effects[effect_count - 1], effect)) {
+            first[stage_count++] = effect_count;
+        }
+        effects[effect_count++] = effect;
+    }
+    first[stage_count] = effect_count;
+
+    stage_cache_t* cache = NULL;
+    uint64_t keys[MAX_EFFECTS_CHAIN];
+    int resume = -1;
+    int snapshot = -1;
+    if (engine && engine->source_id != 0 && engine->stage_cache.budget > 0) {
+        cache = &engine->stage_cache;
+        uint64_t key = stage_cache_seed(engine->source_id, timestamp, frame->width, frame->height, quality, scale);
+        for (int s = 0; s < stage_count; s++) {
+            for (int e = first[s]; e < first[s + 1]; e++) {
+                key = effect_hash(effects[e], key);
+            }
+            keys[s] = key;
+        }
+        resume = stage_cache_find(cache, keys, stage_count);
+        snapshot = stage_cache_plan(cache, keys, stage_count, resume);
+        engine_counter_add(ENGINE_COUNTER_FRAME_CACHE_HITS, (uint64_t)(resume + 1));
+        engine_counter_add(ENGINE_COUNTER_FRAME_CACHE_MISSES, (uint64_t)(stage_count - resume - 1));
     }
 
-    // Allocate temporary frames if needed
-    if (!allocate_temp_frames(chain, frame->width, frame->height)) {
-        return false;
+    // Kernels run in place on the frame; the cache costs one copy to resume
+    // and one to keep the input of the edited effect
+    if (resume >= 0) {
+        uint64_t copy_start_ns = engine_time_ns();
+        TRACE_BEGIN(trace_copy);
+        memcpy(frame->data, cache->frame.data, (size_t)frame->width * frame->height * 4);
+        engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, (uint64_t)pixels * 4);
+        TRACE_END(trace_copy, "chain", "copy", frame->frame_number);
+        latency_histogram_record(&engine->stage_latency[PROFILE_STAGE_COPY], engine_time_ns() - copy_start_ns);
     }
 
-    video_frame_t* current_frame = frame;
-    video_frame_t* temp_frame = chain->temp_frame_1;
+    for (int s = resume + 1; s < stage_count; s++) {
+        effect_cost_kind_t kind = kinds[s];
+
+        // Cancelled: stop between effects, leaving the frame unspecified
+        if (!render_checkpoint()) return false;
+
+        uint64_t kernel_start_ns = engine_time_ns();
+        TRACE_BEGIN(trace_kernel);
+        apply_stage(chain, &effects[first[s]], first[s + 1] - first[s], frame, quality, scale);
+        TRACE_END(trace_kernel, "effect", effect_cost_kind_name(kind), frame->frame_number);
+        uint64_t end_ns = engine_time_ns();
 
-    // Process each effect in priority order
-    for (int i = 0; i < chain->count; i++) {
-        effect_t* effect = &chain->effects[i];
+        uint64_t pass_bytes = (uint64_t)pixels * 4 * (kind == EFFECT_COST_BLUR ? 2 : 1);
+        engine_counter_kernel(kind, pass_bytes, pass_bytes);
 
-        if (!effect->enabled) continue;
+        // A kernel that stopped early says nothing about its cost, and its
+        // output must not be cached
+        if (engine && !render_cancelled()) {
+            latency_histogram_record(&engine->effect_latency[kind], end_ns - kernel_start_ns);
+            effect_cost_model_record(&engine->costs, kind, units[s], end_ns - kernel_start_ns);
 
-        // Check if effect is active at this timestamp
-        if (timestamp < effect->start_time || timestamp > effect->end_time) {
-            continue;
+            if (s == snapshot) {
+                TRACE_BEGIN(trace_copy);
+                if (stage_cache_store(cache, frame, keys[s])) {
+                    engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, (uint64_t)pixels * 4);
+                }
+                TRACE_END(trace_copy, "chain", "copy", frame->frame_number);
+                latency_histogram_record(&engine->stage_latency[PROFILE_STAGE_COPY], engine_time_ns() - end_ns);
+            }
         }
+    }
 
-        // Copy current frame to temp frame if we need to preserve original
-        if (i > 0) {
-            memcpy(temp_frame->data, current_frame->data,
-                   current_frame->width * current_frame->height * 4);
-            temp_frame->timestamp = current_frame->timestamp;
-            temp_frame->frame_number = current_frame->frame_number;
-            current_frame = temp_frame;
+    // The last kernel may have stopped early
+    return !render_cancelled();
+}
+
+// Process frame through effect chain at full quality
+bool effects_process_frame_chain(effect_chain_t* chain, video_frame_t* frame, double timestamp) {
+    return process_chain(chain, frame, timestamp, RENDER_QUALITY_FULL, 1, NULL);
+}
+
+// Predicted chain cost in nanoseconds at a quality level
+static double estimate_chain_cost(effects_engine_t* engine, const video_frame_t* frame,
+                                  double timestamp, render_quality_t quality, int scale) {
+    int factor = render_quality_proxy_factor(quality);
+    double full_pixels = (double)frame->width * frame->height;
+    double pixels = (double)((frame->width + factor - 1) / factor) *
+                    ((frame->height + factor - 1) / factor);
+
+    double total = 0.0;
+    if (factor > 1) {
+        total += effect_cost_model_estimate(&engine->costs, EFFECT_COST_RESAMPLE, full_pixels);
+    }
+
+    effect_chain_t* chain = engine->chain;
+    const effect_chain_plan_t* plan = effect_chain_plan(chain, timestamp);
+    effect_t scratch[2]; // The previous effect may live in the other one
+    int slot = 0;
+    const effect_t* previous = NULL;
+    for (int p = 0; plan && p < plan->count; p++) {
+        effect_cost_kind_t kind;
+        double units;
+        const effect_t* effect = effect_evaluate(&chain->effects[plan->indices[p]], timestamp, NULL, &scratch[slot]);
+        effect = as_color_correction(effect, &scratch[slot]);
+        if (!effect_cost(effect, quality, scale, pixels, &kind, &units)) continue;
+
+        // A color correction sharing the previous one's pass costs nothing more
+        if (!previous || !folds_into(previous, effect)) {
+            total += effect_cost_model_estimate(&engine->costs, kind, units);
         }
+        previous = effect;
+        slot ^= 1;
+    }
 
-        // Apply effect based on type
-        switch (effect->type) {
-            case EFFECT_TYPE_COLOR_CORRECTION:
-                filter_color_correction(current_frame, &effect->params.color_correction);
-                break;
-
-            case EFFECT_TYPE_FILTER:
-                switch (effect->params.filter.type) {
-                    case FILTER_BLUR:
-                        filter_blur(current_frame, &effect->params.blur);
-                        break;
-                    case FILTER_SHARPEN:
-                        filter_sharpen(current_frame, effect->params.filter.intensity);
-                        break;
-                    case FILTER_EDGE_DETECTION:
-                        filter_edge_detection_new(current_frame, effect->params.filter.intensity);
-                        break;
-                    default:
-                        filter_apply(current_frame, &effect->params.filter);
-                        break;
-                }
-                break;
+    return total;
+}
+
+// Best level predicted to meet the budget; when none does, the cheapest one
+static render_quality_t choose_quality(effects_engine_t* engine, const video_frame_t* frame,
+                                       double timestamp, double budget_ms, int scale) {
+    if (budget_ms <= 0.0) return RENDER_QUALITY_FULL;
+
+    double budget_ns = budget_ms * 1e6;
+    render_quality_t cheapest = RENDER_QUALITY_FULL;
+    double cheapest_cost = INFINITY;
 
-            case EFFECT_TYPE_TRANSFORM:
-                filter_transform(current_frame, &effect->params.transform);
-                break;
+    for (int q = RENDER_QUALITY_FULL; q < RENDER_QUALITY_COUNT; q++) {
+        double cost = estimate_chain_cost(engine, frame, timestamp, (render_quality_t)q, scale);
+        if (cost <= budget_ns) return (render_quality_t)q;
 
-            case EFFECT_TYPE_TRANSITION:
-                // Transitions require two frames - handled separately
-                break;
+        if (cost < cheapest_cost) {
+            cheapest_cost = cost;
+            cheapest = (render_quality_t)q;
         }
+    }
 
-        // Swap temp frames for next iteration
-        if (temp_frame == chain->temp_frame_1) {
-            temp_frame = chain->temp_frame_2;
-        } else {
-            temp_frame = chain->temp_frame_1;
+    // Nothing fits: render as cheaply as possible rather than drop the frame
+    return cheapest;
+}
+
+// Render the chain on a downscaled copy of the frame and scale it back up
+static bool process_chain_proxy(effects_engine_t* engine, video_frame_t* frame, double timestamp,
+                                render_quality_t quality, int scale) {
+    int factor = render_quality_proxy_factor(quality);
+    int proxy_width = (frame->width + factor - 1) / factor;
+    int proxy_height = (frame->height + factor - 1) / factor;
+    size_t proxy_size = (size_t)proxy_width * proxy_height * 4;
+
+    if (proxy_size > engine->proxy_capacity) {
+        uint8_t* data = realloc(engine->proxy_frame.data, proxy_size);
+        if (!data) return false;
+        engine_counter_alloc(proxy_size);
+        engine->proxy_frame.data = data;
+        engine->proxy_capacity = proxy_size;
+    }
+
+    uint64_t start_ns = engine_time_ns();
+    TRACE_BEGIN(trace_downscale);
+    video_frame_downscale_area(frame, &engine->proxy_frame, factor);
+    TRACE_END(trace_downscale, "chain", "proxy_downscale", frame->frame_number);
+    uint64_t downscale_ns = engine_time_ns() - start_ns;
+
+    if (!process_chain(engine->chain, &engine->proxy_frame, timestamp, quality, scale, engine)) {
+        return false;
+    }
+
+    start_ns = engine_time_ns();
+    TRACE_BEGIN(trace_upscale);
+    video_frame_upscale(&engine->proxy_frame, frame, frame->width, frame->height);
+    TRACE_END(trace_upscale, "chain", "proxy_upscale", frame->frame_number);
+    uint64_t upscale_ns = engine_time_ns() - start_ns;
+
+    latency_histogram_record(&engine->stage_latency[PROFILE_STAGE_DOWNSCALE], downscale_ns);
+    latency_histogram_record(&engine->stage_latency[PROFILE_STAGE_UPSCALE], upscale_ns);
+    latency_histogram_record(&engine->effect_latency[EFFECT_COST_RESAMPLE], downscale_ns + upscale_ns);
+    uint64_t full_bytes = (uint64_t)frame->width * frame->height * 4;
+    engine_counter_kernel(EFFECT_COST_RESAMPLE, full_bytes + proxy_size, proxy_size + full_bytes);
+    effect_cost_model_record(&engine->costs, EFFECT_COST_RESAMPLE,
+                             (double)frame->width * frame->height, downscale_ns + upscale_ns);
+    return true;
+}
+
+// Result and disk cache key of a frame of source_id rendered by the current
+// chain; 0 when the source is unnamed or both caches are off
+static uint64_t result_cache_key(effects_engine_t* engine, uint64_t source_id, const video_frame_t* frame,
+                                 double timestamp, int scale) {
+    if (source_id == 0 || (engine->result_cache.budget == 0 && !engine->disk_cache)) return 0;
+
+    // The chain hash covers keyframed parameters as evaluated at timestamp,
+    // so timestamps where an animation holds still share a frame
+    uint64_t chain_hash = effect_chain_hash_at(engine->chain, timestamp);
+    if (chain_hash == 0) return 0;
+
+    uint64_t key = stage_cache_seed(source_id, 0.0, frame->width, frame->height, 0, scale) ^ chain_hash;
+    return key != 0 ? key : 1;
+}
+
+// Deferred ring entries keep the priority and kind in the low bits of the
+// ring pointer
+#define DEFERRED_PRIORITY_MASK (uintptr_t)3
+#define DEFERRED_PRERENDER (uintptr_t)4
+#define DEFERRED_FLAG_MASK (uintptr_t)7
+_Static_assert(RENDER_PRIORITY_COUNT <= 4, "priorities must fit the deferred entry bits");
+_Static_assert(_Alignof(frame_ring_t) > DEFERRED_FLAG_MASK, "ring pointers must leave the flag bits free");
+
+static void process_ring_job(void* context, void* payload);
+static void prerender_ring_job(void* context, void* payload);
+
+static inline void chain_lock(effects_engine_t* engine) {
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_lock(&engine->chain_lock);
+#else
+    (void)engine;
+#endif
+}
+
+static inline void chain_unlock(effects_engine_t* engine) {
+#if RENDER_SCHEDULER_THREADS
+    pthread_mutex_unlock(&engine->chain_lock);
+#else
+    (void)engine;
+#endif
+}
+
+static inline bool claim_engine(effects_engine_t* engine) {
+    bool expected = false;
+    return atomic_compare_exchange_strong(&engine->processing, &expected, true);
+}
+
+// Release the claim and requeue the ring work deferred while it was held
+static void release_engine(effects_engine_t* engine) {
+    atomic_store(&engine->processing, false);
+
+    for (int i = 0; i < EFFECTS_DEFERRED_RINGS; i++) {
+        uintptr_t entry = atomic_exchange(&engine->deferred[i], 0);
+        if (entry == 0) continue;
+
+        frame_ring_t* ring = (frame_ring_t*)(entry & ~DEFERRED_FLAG_MASK);
+        render_priority_t priority = (render_priority_t)(entry & DEFERRED_PRIORITY_MASK);
+        render_job_fn fn = (entry & DEFERRED_PRERENDER) ? prerender_ring_job : process_ring_job;
+        if (!render_scheduler_submit(engine->scheduler, priority, fn, engine, ring)) {
+            LOG_WARN("Deferred ring work could not be requeued; its frames stay pending");
         }
     }
+}
 
-    // Copy final result back to original frame if we used temp frames
-    if (current_frame != frame) {
-        memcpy(frame->data, current_frame->data,
-               frame->width * frame->height * 4);
+// Take a ring up again on the scheduler once the engine is released. False
+// when there is no scheduler to requeue on or no room to remember the ring.
+static bool defer_ring(effects_engine_t* engine, frame_ring_t* ring, render_priority_t priority, bool prerender) {
+    if (!engine->scheduler) return false;
+
+    uintptr_t entry = (uintptr_t)ring | (uintptr_t)priority | (prerender ? DEFERRED_PRERENDER : 0);
+    bool stored = false;
+    for (int i = 0; i < EFFECTS_DEFERRED_RINGS && !stored; i++) {
+        uintptr_t expected = 0;
+        stored = atomic_load(&engine->deferred[i]) == entry ||
+                 atomic_compare_exchange_strong(&engine->deferred[i], &expected, entry);
+    }
+    if (!stored) {
+        LOG_WARN("Too many rings deferred on one engine; frames stay pending");
+        return false;
     }
 
+    // The claim may have been released before the entry landed
+    if (claim_engine(engine)) release_engine(engine);
     return true;
 }
 
-// Process frame through effects engine
-bool effects_process_frame(effects_engine_t* engine, video_frame_t* frame, double timestamp) {
-    if (!engine || !engine->initialized) return false;
+// Whether ring work more urgent than priority is waiting for the claim
+static bool deferred_before(effects_engine_t* engine, render_priority_t priority) {
+    for (int i = 0; i < EFFECTS_DEFERRED_RINGS; i++) {
+        uintptr_t entry = atomic_load(&engine->deferred[i]);
+        if (entry != 0 && (render_priority_t)(entry & DEFERRED_PRIORITY_MASK) < priority) return true;
+    }
+    return false;
+}
+
+// Ring work at priority found the engine claimed. Interactive work does not
+// wait out a pre-render frame: that is cancelled and rendered again later.
+static void defer_claimed(effects_engine_t* engine, frame_ring_t* ring, render_priority_t priority, bool prerender) {
+    if (!defer_ring(engine, ring, priority, prerender)) return;
+    if (priority < RENDER_PRIORITY_PREFETCH && engine->prerendering) effects_engine_cancel(engine);
+}
 
-    clock_t start_time = clock();
+// Process a frame at 1/scale of its source's resolution, degrading quality
+// as needed so the chain is predicted to finish within budget_ms. The
+// caller holds the engine claim and the chain lock.
+static bool render_frame(effects_engine_t* engine, video_frame_t* frame, double timestamp,
+                         double budget_ms, int scale, render_quality_t* quality_used) {
+    // Jobs keep the scheduler and priority they run at; direct calls use the
+    // engine's. Either way the frame observes this engine's cancel token.
+    render_context_t* outer = render_context_current();
+    render_context_t context;
+    render_context_enter(&context,
+                         outer ? outer->scheduler : engine->scheduler,
+                         outer ? outer->priority : engine->priority,
+                         &engine->cancel);
+
+    uint64_t start_ns = engine_time_ns();
+    TRACE_BEGIN(trace_frame);
 
     frame->timestamp = timestamp;
-    bool result = effects_process_frame_chain(engine->chain, frame, timestamp);
+    render_quality_t quality = choose_quality(engine, frame, timestamp, budget_ms, scale);
+    uint64_t result_key = result_cache_key(engine, engine->source_id, frame, timestamp, scale);
+    bool result;
+    if (result_cache_lookup(&engine->result_cache, result_key, frame, quality, &quality)) {
+        engine_counter_add(ENGINE_COUNTER_RESULT_CACHE_HITS, 1);
+        result = true;
+    } else if (disk_cache_lookup(engine->disk_cache, result_key, frame)) {
+        // Disk holds full quality only; keep it in memory for the next hit
+        quality = RENDER_QUALITY_FULL;
+        result_cache_store(&engine->result_cache, result_key, frame, quality, engine->prerendering);
+        result = true;
+    } else {
+        if (result_key != 0) engine_counter_add(ENGINE_COUNTER_RESULT_CACHE_MISSES, 1);
+
+        if (render_quality_proxy_factor(quality) > 1 && engine->chain->count > 0) {
+            result = process_chain_proxy(engine, frame, timestamp, quality, scale);
+        } else {
+            result = process_chain(engine->chain, frame, timestamp, quality, scale, engine);
+        }
+
+        if (result && !render_cancelled()) {
+            result_cache_store(&engine->result_cache, result_key, frame, quality, engine->prerendering);
+            if (quality == RENDER_QUALITY_FULL) disk_cache_store(engine->disk_cache, result_key, frame);
+        }
+    }
+    bool cancelled = render_cancelled();
+    TRACE_END(trace_frame, "engine", cancelled ? "process_frame (cancelled)" : "process_frame", frame->frame_number);
+
+    render_context_leave(&context);
+    engine->source_id = 0; // Names one frame only
+    engine->last_quality = quality;
+    if (quality_used) *quality_used = quality;
 
     // Update performance metrics
-    clock_t end_time = clock();
-    engine->last_process_time_ms = ((double)(end_time - start_time) / CLOCKS_PER_SEC) * 1000.0;
+    uint64_t elapsed_ns = engine_time_ns() - start_ns;
+    engine->last_frame_cancelled = cancelled;
+    if (cancelled) {
+        engine->frames_cancelled++;
+        engine_counters_publish();
+        return false;
+    }
+    engine->last_process_time_ms = elapsed_ns / 1e6;
+    engine->total_process_ns += elapsed_ns;
+    latency_histogram_record(&engine->stage_latency[PROFILE_STAGE_FRAME], elapsed_ns);
     engine->frames_processed++;
+    engine_counter_add(ENGINE_COUNTER_FRAMES, 1);
+    engine_counters_publish();
 
     return result;
 }
 
+static bool process_frame(effects_engine_t* engine, video_frame_t* frame, double timestamp,
+                          double budget_ms, int scale, render_quality_t* quality_used) {
+    if (!engine || !engine->initialized || !frame) return false;
+
+    // A job run inline at a checkpoint must not re-enter the engine it preempted
+    if (!claim_engine(engine)) return false;
+    chain_lock(engine);
+    bool result = render_frame(engine, frame, timestamp, budget_ms, scale, quality_used);
+    chain_unlock(engine);
+    release_engine(engine);
+    return result;
+}
+
+// Process frame through effects engine
+bool effects_process_frame(effects_engine_t* engine, video_frame_t* frame, double timestamp) {
+    return effects_process_frame_budget(engine, frame, timestamp, 0.0, NULL);
+}
+
+// Process frame, degrading quality as needed so the chain is predicted to
+// finish within budget_ms (<= 0 = no deadline, always full quality). The
+// level used is reported through quality_used.
+bool effects_process_frame_budget(effects_engine_t* engine, video_frame_t* frame, double timestamp,
+                                  double budget_ms, render_quality_t* quality_used) {
+    return process_frame(engine, frame, timestamp, budget_ms, 1, quality_used);
+}
+
+// Render a ring slot in place with the engine claimed
+static bool render_slot(effects_engine_t* engine, frame_ring_slot_t* slot) {
+    video_frame_t frame;
+    frame.data = slot->data;
+    frame.width = slot->width;
+    frame.height = slot->height;
+    frame.stride = slot->width * 4;
+    frame.format = 1; // RGBA
+    frame.timestamp = slot->timestamp;
+    frame.frame_number = slot->frame_number;
+
+    engine->source_id = slot->source_id;
+    return render_frame(engine, &frame, slot->timestamp, 0.0, 1, NULL);
+}
+
+// Consume published frames from a ring, process them in place and hand them
+// to the reader. Returns the number of slots handed on (processed, failed or
+// dropped as stale). A ring met while the engine is busy, or behind more
+// urgent deferred work, is left pending and taken up again on the scheduler.
+int effects_engine_process_ring(effects_engine_t* engine, frame_ring_t* ring, int max_frames) {
+    if (!engine || !engine->initialized || !ring) return 0;
+
+    render_context_t* outer = render_context_current();
+    render_priority_t priority = outer ? outer->priority : engine->priority;
+
+    int processed = 0;
+    while (max_frames <= 0 || processed < max_frames) {
+        if (frame_ring_get_pending(ring) == 0) break;
+        if (!claim_engine(engine)) {
+            defer_claimed(engine, ring, priority, false);
+            break;
+        }
+
+        frame_ring_slot_t* slot = frame_ring_begin_process(ring);
+        if (!slot) {
+            release_engine(engine);
+            break;
+        }
+
+        // Scrubbing: a newer frame is already queued, so this one is obsolete
+        if (engine->drop_stale_frames && frame_ring_get_pending(ring) > 1) {
+            frame_ring_end_process(ring, FRAME_RING_STATUS_CANCELLED);
+            engine->frames_cancelled++;
+        } else {
+            chain_lock(engine);
+            bool success = render_slot(engine, slot);
+            chain_unlock(engine);
+            frame_ring_end_process(ring, success ? FRAME_RING_STATUS_DONE :
+                                   engine->last_frame_cancelled ? FRAME_RING_STATUS_CANCELLED :
+                                   FRAME_RING_STATUS_FAILED);
+        }
+        processed++;
+
+        bool yield = deferred_before(engine, priority) && defer_ring(engine, ring, priority, false);
+        release_engine(engine);
+        if (yield) break;
+    }
+
+    return processed;
+}
+
+// Attach engine to a (possibly shared) scheduler at the given priority class
+void effects_engine_set_scheduler(effects_engine_t* engine, render_scheduler_t* scheduler, render_priority_t priority) {
+    if (!engine) return;
+
+    engine->scheduler = scheduler;
+    engine->priority = priority;
+}
+
+static void process_ring_job(void* context, void* payload) {
+    effects_engine_process_ring((effects_engine_t*)context, (frame_ring_t*)payload, 0);
+}
+
+// Queue draining of a ring on the engine's scheduler
+bool effects_engine_submit_ring(effects_engine_t* engine, frame_ring_t* ring, render_priority_t priority) {
+    if (!engine || !ring || !engine->scheduler) return false;
+
+    return render_scheduler_submit(engine->scheduler, priority, process_ring_job, engine, ring);
+}
+
+// Render published ring frames into the result cache at prefetch priority,
+// each in place in its slot. Returns the number of slots handed on, or
+// EFFECTS_PRERENDER_EDITED / EFFECTS_PRERENDER_FULL when it stopped early
+// with frames still queued; JS then re-plans from the playhead or waits for
+// playback to use up prefetched frames. EFFECTS_PRERENDER_PREEMPTED means
+// more urgent ring work was waiting and the rest of the ring follows it on
+// the scheduler.
+int effects_engine_prerender_ring(effects_engine_t* engine, frame_ring_t* ring, int max_frames) {
+    if (!engine || !engine->initialized || !ring) return 0;
+
+    render_context_t context;
+    render_context_enter(&context, engine->scheduler, RENDER_PRIORITY_PREFETCH, &engine->cancel);
+
+    int processed = 0;
+    int status = 0;
+    while (status == 0 && (max_frames <= 0 || processed < max_frames)) {
+        if (frame_ring_get_pending(ring) == 0) break;
+        if (!claim_engine(engine)) {
+            defer_claimed(engine, ring, RENDER_PRIORITY_PREFETCH, true);
+            break;
+        }
+        chain_lock(engine);
+
+        effect_chain_t* chain = engine->chain;
+        frame_ring_slot_t* slot = NULL;
+        if (chain->revision != engine->prerender_revision) {
+            if (processed > 0) {
+                status = EFFECTS_PRERENDER_EDITED;
+            } else {
+                result_cache_evict_prefetched(&engine->result_cache);
+                engine->prerender_revision = chain->revision;
+            }
+        }
+        if (status == 0 && !result_cache_can_prefetch(&engine->result_cache, ring->slot_size)) {
+            status = EFFECTS_PRERENDER_FULL;
+        }
+        if (status == 0) slot = frame_ring_begin_process(ring);
+
+        if (slot && slot->source_id == 0) {
+            // Only a named source can be found again
+            frame_ring_end_process(ring, FRAME_RING_STATUS_CANCELLED);
+            processed++;
+        } else if (slot) {
+            engine->prerendering = true;
+            bool success = render_slot(engine, slot);
+            engine->prerendering = false;
+            frame_ring_end_process(ring, success ? FRAME_RING_STATUS_DONE :
+                                   engine->last_frame_cancelled ? FRAME_RING_STATUS_CANCELLED :
+                                   FRAME_RING_STATUS_FAILED);
+            processed++;
+        }
+        chain_unlock(engine);
+
+        if (status == 0 && deferred_before(engine, RENDER_PRIORITY_PREFETCH) &&
+            defer_ring(engine, ring, RENDER_PRIORITY_PREFETCH, true)) {
+            status = EFFECTS_PRERENDER_PREEMPTED;
+        }
+        release_engine(engine);
+        if (status == 0 && !slot) break;
+    }
+
+    render_context_leave(&context);
+    return status != 0 ? status : processed;
+}
+
+static void prerender_ring_job(void* context, void* payload) {
+    effects_engine_prerender_ring((effects_engine_t*)context, (frame_ring_t*)payload, 0);
+}
+
+// Queue pre-rendering of a ring on the engine's scheduler
+bool effects_engine_submit_prerender(effects_engine_t* engine, frame_ring_t* ring) {
+    if (!engine || !ring || !engine->scheduler) return false;
+
+    return render_scheduler_submit(engine->scheduler, RENDER_PRIORITY_PREFETCH, prerender_ring_job, engine, ring);
+}
+
+// Serialize a chain edit against rendering
+void effects_engine_lock_chain(effects_engine_t* engine) {
+    if (!engine) return;
+
+#if RENDER_SCHEDULER_THREADS
+    if (pthread_mutex_trylock(&engine->chain_lock) == 0) return;
+    // The pre-rendered frame would show the old chain anyway
+    if (engine->prerendering) effects_engine_cancel(engine);
+    pthread_mutex_lock(&engine->chain_lock);
+#endif
+}
+
+void effects_engine_unlock_chain(effects_engine_t* engine) {
+    if (!engine) return;
+
+    chain_unlock(engine);
+}
+
+// Abandon the frame currently being processed (safe from any thread)
+void effects_engine_cancel(effects_engine_t* engine) {
+    if (!engine) return;
+
+    render_cancel_token_cancel(&engine->cancel);
+}
+
+// Latest-frame-wins ring processing for scrubbing
+void effects_engine_set_drop_stale_frames(effects_engine_t* engine, bool drop) {
+    if (!engine) return;
+
+    engine->drop_stale_frames = drop;
+}
+
+// Name the pixels of the next frame processed, so stages computed for the
+// same source are reused (0 = unknown, nothing cached). Applies to one frame.
+void effects_engine_set_source_id(effects_engine_t* engine, uint64_t source_id) {
+    if (!engine) return;
+
+    engine->source_id = source_id;
+}
+
+// Bytes the stage cache may hold (0 disables it and frees its frames)
+void effects_engine_set_stage_cache_budget(effects_engine_t* engine, size_t bytes) {
+    if (!engine) return;
+
+    stage_cache_set_budget(&engine->stage_cache, bytes);
+}
+
+// Bytes of finished frames to keep (0 disables the cache), optionally
+// QOI-compressed
+void effects_engine_set_result_cache(effects_engine_t* engine, size_t bytes, bool compress) {
+    if (!engine) return;
+
+    result_cache_set_budget(&engine->result_cache, bytes);
+    result_cache_set_compression(&engine->result_cache, compress);
+}
+
+// Forget every cached stage and frame, e.g. when source ids are reassigned
+void effects_engine_clear_caches(effects_engine_t* engine) {
+    if (!engine) return;
+
+    stage_cache_set_budget(&engine->stage_cache, engine->stage_cache.budget);
+    result_cache_clear(&engine->result_cache);
+}
+
+// Attach a disk cache shared with other engines and processes; the caller
+// keeps ownership and closes it after detaching every engine
+void effects_engine_set_disk_cache(effects_engine_t* engine, disk_cache_t* cache) {
+    if (!engine) return;
+
+    engine->disk_cache = cache;
+}
+
 // Effect creation helpers
 effect_t* effect_create_color_correction(float brightness, float contrast, float saturation, float hue) {
     effect_t* effect = malloc(sizeof(effect_t));
@@ -336,7 +1230,7 @@ effect_t* effect_create_blur(float radius, bool gaussian) {
     if (!effect) return NULL;
 
     memset(effect, 0, sizeof(effect_t));
-    effect->type = EFFECT_TYPE_FILTER;
+    effect->type = EFFECT_TYPE_BLUR;
     effect->priority = EFFECT_PRIORITY_FILTER;
     effect->enabled = true;
     effect->start_time = 0.0;
@@ -390,6 +1284,80 @@ effect_t* effect_create_filter(filter_type_t type, float intensity) {
     return effect;
 }
 
+// Field a keyframe parameter drives in an effect of its type, or NULL
+static float* effect_param_field(effect_t* effect, int param) {
+    switch (effect->type) {
+        case EFFECT_TYPE_COLOR_CORRECTION: {
+            color_correction_t* p = &effect->params.color_correction;
+            switch (param) {
+                case EFFECT_PARAM_BRIGHTNESS: return &p->brightness;
+                case EFFECT_PARAM_CONTRAST: return &p->contrast;
+                case EFFECT_PARAM_SATURATION: return &p->saturation;
+                case EFFECT_PARAM_HUE: return &p->hue;
+                case EFFECT_PARAM_GAMMA: return &p->gamma;
+                case EFFECT_PARAM_EXPOSURE: return &p->exposure;
+                default: return NULL;
+            }
+        }
+        case EFFECT_TYPE_BLUR:
+            return param == EFFECT_PARAM_BLUR_RADIUS ? &effect->params.blur.radius : NULL;
+        case EFFECT_TYPE_TRANSFORM:
+            if (param == EFFECT_PARAM_SCALE) return &effect->params.transform.scale;
+            return param == EFFECT_PARAM_ROTATION ? &effect->params.transform.rotation : NULL;
+        case EFFECT_TYPE_FILTER:
+            return param == EFFECT_PARAM_INTENSITY ? &effect->params.filter.intensity : NULL;
+        case EFFECT_TYPE_TRANSITION:
+            return NULL;
+    }
+    return NULL;
+}
+
+// Keyframe animation
+bool effect_set_keyframe(effect_t* effect, effect_param_t param, float time, float value,
+                         keyframe_interp_t interpolation, const float* ease) {
+    if (!effect || !effect_param_field(effect, param)) return false;
+
+    int t = 0;
+    while (t < effect->track_count && effect->tracks[t].param != param) t++;
+    if (t == effect->track_count) {
+        if (t >= EFFECT_MAX_TRACKS) return false;
+
+        // Added to the effect only once it holds a keyframe
+        memset(&effect->tracks[t], 0, sizeof(keyframe_track_t));
+        effect->tracks[t].param = (uint8_t)param;
+    }
+
+    if (!keyframe_track_set(&effect->tracks[t], time, value, interpolation, ease)) return false;
+    if (t == effect->track_count) effect->track_count++;
+    return true;
+}
+
+void effect_clear_keyframes(effect_t* effect, effect_param_t param) {
+    if (!effect) return;
+
+    int kept = 0;
+    for (int t = 0; t < effect->track_count; t++) {
+        if (param == EFFECT_PARAM_COUNT || effect->tracks[t].param == param) continue;
+        if (kept != t) effect->tracks[kept] = effect->tracks[t];
+        kept++;
+    }
+    effect->track_count = kept;
+}
+
+const effect_t* effect_evaluate(const effect_t* effect, double timestamp, uint8_t* hints, effect_t* scratch) {
+    if (effect->track_count == 0) return effect;
+
+    // Tracks stay behind: the copy renders and hashes as a still effect
+    memcpy(scratch, effect, offsetof(effect_t, track_count));
+    scratch->track_count = 0;
+    for (int t = 0; t < effect->track_count; t++) {
+        const keyframe_track_t* track = &effect->tracks[t];
+        float* field = effect_param_field(scratch, track->param);
+        if (field) *field = keyframe_track_evaluate(track, timestamp, hints ? &hints[t] : NULL);
+    }
+    return scratch;
+}
+
 // Performance metrics
 double effects_engine_get_last_process_time(effects_engine_t* engine) {
     return engine ? engine->last_process_time_ms : 0.0;
@@ -403,7 +1371,314 @@ void effects_engine_get_stats(effects_engine_t* engine, int* frames_processed, d
     }
 
     if (frames_processed) *frames_processed = engine->frames_processed;
-    if (avg_time) *avg_time = engine->last_process_time_ms;
+    if (avg_time) {
+        *avg_time = engine->frames_processed > 0 ?
+            (double)engine->total_process_ns / engine->frames_processed / 1e6 : 0.0;
+    }
+}
+
+static void summarize_histogram(const latency_histogram_t* histogram, profile_stat_t* stat) {
+    stat->count = latency_histogram_count(histogram);
+    stat->mean_ms = (float)(latency_histogram_mean(histogram) / 1e6);
+    stat->p50_ms = (float)(latency_histogram_percentile(histogram, 50.0) / 1e6);
+    stat->p95_ms = (float)(latency_histogram_percentile(histogram, 95.0) / 1e6);
+    stat->p99_ms = (float)(latency_histogram_percentile(histogram, 99.0) / 1e6);
+    stat->max_ms = (float)(latency_histogram_max(histogram) / 1e6);
+}
+
+// Snapshot per-effect-kind and per-stage latency over the rolling window
+void effects_engine_get_profile(effects_engine_t* engine, effects_profile_t* profile) {
+    if (!engine || !profile) return;
+
+    profile->effect_count = EFFECT_COST_COUNT;
+    profile->stage_count = PROFILE_STAGE_COUNT;
+    for (int i = 0; i < EFFECT_COST_COUNT; i++) {
+        summarize_histogram(&engine->effect_latency[i], &profile->effects[i]);
+    }
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++) {
+        summarize_histogram(&engine->stage_latency[i], &profile->stages[i]);
+    }
+}
+
+void effects_engine_reset_profile(effects_engine_t* engine) {
+    if (!engine) return;
+
+    for (int i = 0; i < EFFECT_COST_COUNT; i++) {
+        latency_histogram_init(&engine->effect_latency[i], LATENCY_DEFAULT_WINDOW);
+    }
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++) {
+        latency_histogram_init(&engine->stage_latency[i], LATENCY_DEFAULT_WINDOW);
+    }
+}
+
+// Output slot dimensions follow the input size and render scale
+static void size_output_slot(effects_engine_t* engine) {
+    int scale = engine->render_scale;
+    video_frame_t* output = &engine->output_slot;
+    output->width = (engine->input_slot.width + scale - 1) / scale;
+    output->height = (engine->input_slot.height + scale - 1) / scale;
+    output->stride = output->width * 4;
+    output->format = 1; // RGBA
+}
+
+// Size the session I/O slots for frames of width x height. Slot pointers
+// change whenever the size grows.
+bool effects_engine_set_session_size(effects_engine_t* engine, int width, int height) {
+    if (!engine || width <= 0 || height <= 0) return false;
+    if (!claim_engine(engine)) return false;
+
+    size_t frame_size = (size_t)width * height * 4;
+    if (frame_size > engine->session_capacity) {
+        uint8_t* data = malloc(frame_size * 2);
+        if (!data) {
+            release_engine(engine);
+            return false;
+        }
+
+        free(engine->input_slot.data);
+        engine->input_slot.data = data;
+        engine->output_slot.data = data + frame_size;
+        engine->session_capacity = frame_size;
+        engine_counter_alloc(frame_size * 2);
+    }
+
+    engine->input_slot.width = width;
+    engine->input_slot.height = height;
+    engine->input_slot.stride = width * 4;
+    engine->input_slot.format = 1; // RGBA
+    engine->refine_pending = false;
+    size_output_slot(engine);
+    release_engine(engine);
+    return true;
+}
+
+// Preview at 1/scale of the session resolution (1, 2 or 4). Spatial
+// parameters are scaled to match, so the output looks like a downscaled
+// full-resolution render at 1/scale^2 of the cost.
+bool effects_engine_set_render_scale(effects_engine_t* engine, int scale) {
+    if (!engine || (scale != 1 && scale != 2 && scale != 4)) return false;
+    if (!claim_engine(engine)) return false;
+
+    engine->render_scale = scale;
+    engine->refine_pending = false;
+    if (engine->input_slot.data) size_output_slot(engine);
+    release_engine(engine);
+    return true;
+}
+
+// Process the input slot into the output slot. The input is left intact so
+// the same source can be re-rendered after a parameter change without JS
+// uploading it again.
+bool effects_engine_process_session(effects_engine_t* engine, double timestamp, double budget_ms,
+                                    render_quality_t* quality_used) {
+    if (!engine || !engine->initialized || !engine->input_slot.data) return false;
+    if (!claim_engine(engine)) return false;
+
+    video_frame_t* output = &engine->output_slot;
+    size_t frame_size = (size_t)output->width * output->height * 4;
+    if (engine->render_scale > 1) {
+        uint64_t input_bytes = (uint64_t)engine->input_slot.width * engine->input_slot.height * 4;
+        video_frame_downscale_area(&engine->input_slot, output, engine->render_scale);
+        engine_counter_kernel(EFFECT_COST_RESAMPLE, input_bytes, frame_size);
+    } else {
+        memcpy(output->data, engine->input_slot.data, frame_size);
+        engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, frame_size);
+    }
+    output->frame_number = engine->frames_processed;
+
+    uint64_t source_id = engine->source_id; // render_frame clears it
+    render_quality_t quality = RENDER_QUALITY_FULL;
+    chain_lock(engine);
+    bool result = render_frame(engine, output, timestamp, budget_ms, engine->render_scale, &quality);
+    if (quality_used) *quality_used = quality;
+
+    // A preview below full quality is refined by effects_engine_refine_session
+    engine->refine_pending = result && quality != RENDER_QUALITY_FULL && engine->chain->count > 0;
+    if (engine->refine_pending) {
+        engine->refine_timestamp = timestamp;
+        engine->refine_source_id = source_id;
+        engine->refine_revision = engine->chain->revision;
+        engine->refine_next_row = 0;
+    }
+    chain_unlock(engine);
+    release_engine(engine);
+    return result;
+}
+
+// Output rows each refinement band covers, and the halo of extra rows above
+// and below it the chain reads. A chain with a non-local effect refines the
+// whole frame at once.
+static int refine_band_rows(effects_engine_t* engine, int* halo) {
+    const video_frame_t* output = &engine->output_slot;
+    effect_chain_t* chain = engine->chain;
+    double timestamp = engine->refine_timestamp;
+
+    const effect_chain_plan_t* plan = effect_chain_plan(chain, timestamp);
+    effect_t scratch;
+    *halo = 0;
+    for (int p = 0; plan && p < plan->count; p++) {
+        effect_cost_kind_t kind;
+        double units;
+        const effect_t* effect = effect_evaluate(&chain->effects[plan->indices[p]], timestamp, NULL, &scratch);
+        if (!effect_cost(effect, RENDER_QUALITY_FULL, engine->render_scale, 0.0, &kind, &units)) continue;
+
+        int reach = effect_reach(effect, engine->render_scale);
+        if (reach < 0) {
+            *halo = 0;
+            return output->height;
+        }
+        *halo += reach;
+    }
+
+    int rows = EFFECTS_REFINE_BAND_PIXELS / output->width;
+    if (rows < 16) rows = 16;
+    // A band whose halo outweighs it costs more than the whole frame
+    if (rows < 4 * *halo || rows >= output->height) {
+        *halo = 0;
+        return output->height;
+    }
+    return rows;
+}
+
+// Fill the band frame with output rows [first, last) of the session input,
+// downscaled to the render scale
+static bool refine_load_band(effects_engine_t* engine, int first, int last) {
+    const video_frame_t* input = &engine->input_slot;
+    int scale = engine->render_scale;
+    int width = engine->output_slot.width;
+    size_t band_size = (size_t)width * (last - first) * 4;
+
+    if (band_size > engine->refine_capacity) {
+        uint8_t* data = realloc(engine->refine_band.data, band_size);
+        if (!data) return false;
+        engine_counter_alloc(band_size);
+        engine->refine_band.data = data;
+        engine->refine_capacity = band_size;
+    }
+
+    video_frame_t* band = &engine->refine_band;
+    band->width = width;
+    band->height = last - first;
+    band->stride = width * 4;
+    band->format = 1; // RGBA
+    band->timestamp = engine->refine_timestamp;
+    band->frame_number = engine->output_slot.frame_number;
+
+    if (scale == 1) {
+        memcpy(band->data, input->data + (size_t)first * input->stride, band_size);
+        engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, band_size);
+        return true;
+    }
+
+    // Output row r averages input rows [r * scale, (r + 1) * scale), so
+    // downscaling just the band's input rows matches a whole-frame downscale
+    int input_first = first * scale;
+    int input_last = last * scale < input->height ? last * scale : input->height;
+    video_frame_t view = *input;
+    view.data = input->data + (size_t)input_first * input->stride;
+    view.height = input_last - input_first;
+    video_frame_downscale_area(&view, band, scale);
+    engine_counter_kernel(EFFECT_COST_RESAMPLE, (uint64_t)view.width * view.height * 4, band_size);
+    return true;
+}
+
+// Re-render the last session preview at full quality, band by band, over
+// the output slot at prefetch priority. Stops between bands for more urgent
+// ring work deferred on the engine; *preempted then reports it.
+static int refine_session(effects_engine_t* engine, int max_bands, bool* preempted) {
+    *preempted = false;
+    if (!engine || !engine->input_slot.data) return -1;
+    if (!engine->refine_pending) return 0;
+    if (!claim_engine(engine)) return -1;
+
+    effect_chain_t* chain = engine->chain;
+    video_frame_t* output = &engine->output_slot;
+    int scale = engine->render_scale;
+    render_context_t context;
+    render_context_enter(&context, engine->scheduler, RENDER_PRIORITY_PREFETCH, &engine->cancel);
+
+    int halo = 0;
+    int band_rows = 1;
+    int rendered = 0;
+    bool result = true;
+    bool stale = false;
+    while (engine->refine_next_row < output->height && (max_bands <= 0 || rendered < max_bands)) {
+        chain_lock(engine);
+        // An edit makes the preview stale; the next session render replaces it anyway
+        stale = chain->revision != engine->refine_revision;
+        if (stale) {
+            chain_unlock(engine);
+            break;
+        }
+
+        band_rows = refine_band_rows(engine, &halo);
+        int first = engine->refine_next_row;
+        int last = first + band_rows < output->height ? first + band_rows : output->height;
+        int band_first = first - halo > 0 ? first - halo : 0;
+        int band_last = last + halo < output->height ? last + halo : output->height;
+
+        TRACE_BEGIN(trace_band);
+        result = refine_load_band(engine, band_first, band_last) &&
+                 process_chain(chain, &engine->refine_band, engine->refine_timestamp,
+                               RENDER_QUALITY_FULL, scale, NULL);
+        TRACE_END(trace_band, "engine", "refine_band", output->frame_number);
+        chain_unlock(engine);
+        // A cancelled band is simply rendered again by the next call
+        if (!result) break;
+
+        size_t row_bytes = (size_t)output->stride;
+        memcpy(output->data + (size_t)first * row_bytes,
+               engine->refine_band.data + (size_t)(first - band_first) * row_bytes,
+               (size_t)(last - first) * row_bytes);
+        engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, (uint64_t)(last - first) * row_bytes);
+        engine->refine_next_row = last;
+        rendered++;
+
+        if (deferred_before(engine, RENDER_PRIORITY_PREFETCH)) {
+            *preempted = engine->refine_next_row < output->height;
+            break;
+        }
+    }
+    bool cancelled = render_cancelled();
+    render_context_leave(&context);
+
+    int remaining = 0;
+    if (stale) {
+        engine->refine_pending = false;
+    } else if (!result && !cancelled) {
+        engine->refine_pending = false;
+        remaining = -1;
+    } else if (engine->refine_next_row < output->height) {
+        remaining = (output->height - engine->refine_next_row + band_rows - 1) / band_rows;
+    } else {
+        engine->refine_pending = false;
+        engine->last_quality = RENDER_QUALITY_FULL;
+        uint64_t key = result_cache_key(engine, engine->refine_source_id, output, engine->refine_timestamp, scale);
+        result_cache_store(&engine->result_cache, key, output, RENDER_QUALITY_FULL, false);
+        disk_cache_store(engine->disk_cache, key, output);
+    }
+    release_engine(engine);
+    return remaining;
+}
+
+int effects_engine_refine_session(effects_engine_t* engine, int max_bands) {
+    bool preempted;
+    return refine_session(engine, max_bands, &preempted);
+}
+
+static void refine_session_job(void* context, void* payload) {
+    (void)payload;
+    effects_engine_t* engine = (effects_engine_t*)context;
+    bool preempted;
+    // Bands left behind for more urgent work follow it on the scheduler
+    if (refine_session(engine, 0, &preempted) > 0 && preempted) effects_engine_submit_refine(engine);
+}
+
+// Queue refinement of the last session preview on the engine's scheduler
+bool effects_engine_submit_refine(effects_engine_t* engine) {
+    if (!engine || !engine->scheduler) return false;
+
+    return render_scheduler_submit(engine->scheduler, RENDER_PRIORITY_PREFETCH, refine_session_job, engine, NULL);
 }
 
 // ============================================================================
@@ -412,45 +1687,45 @@ void effects_engine_get_stats(effects_engine_t* engine, int* frames_processed, d
 
 // Create effects engine from JavaScript
 EMSCRIPTEN_KEEPALIVE
-int js_effects_engine_create(void) {
+engine_handle_t js_effects_engine_create(void) {
     effects_engine_t* engine = effects_engine_create();
-    if (!engine) return 0;
+    if (!engine) return HANDLE_INVALID;
 
     if (!effects_engine_init(engine)) {
         effects_engine_destroy(engine);
-        return 0;
+        return HANDLE_INVALID;
     }
 
-    g_effects_engine = engine; // Store global reference
-    return (int)(uintptr_t)engine;
+    engine_handle_t handle = handle_register(engine, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (handle == HANDLE_INVALID) {
+        effects_engine_cleanup(engine);
+        effects_engine_destroy(engine);
+    }
+    return handle;
 }
 
 // Destroy effects engine from JavaScript
 EMSCRIPTEN_KEEPALIVE
-void js_effects_engine_destroy(int engine_ptr) {
-    if (engine_ptr == 0) return;
+void js_effects_engine_destroy(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_release(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
 
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
     effects_engine_cleanup(engine);
     effects_engine_destroy(engine);
-
-    if (g_effects_engine == engine) {
-        g_effects_engine = NULL;
-    }
 }
 
 // Add color correction effect
 EMSCRIPTEN_KEEPALIVE
-int js_effect_chain_add_color_correction(int engine_ptr, float brightness, float contrast, float saturation, float hue) {
-    if (engine_ptr == 0) return -1;
-
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+int js_effect_chain_add_color_correction(engine_handle_t engine_handle, float brightness, float contrast, float saturation, float hue) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return -1;
 
     effect_t* effect = effect_create_color_correction(brightness, contrast, saturation, hue);
     if (!effect) return -1;
 
+    effects_engine_lock_chain(engine);
     int index = effect_chain_add(engine->chain, effect);
+    effects_engine_unlock_chain(engine);
     free(effect); // Chain makes a copy
 
     return index;
@@ -458,16 +1733,16 @@ int js_effect_chain_add_color_correction(int engine_ptr, float brightness, float
 
 // Add blur effect
 EMSCRIPTEN_KEEPALIVE
-int js_effect_chain_add_blur(int engine_ptr, float radius, int gaussian) {
-    if (engine_ptr == 0) return -1;
-
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+int js_effect_chain_add_blur(engine_handle_t engine_handle, float radius, int gaussian) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return -1;
 
     effect_t* effect = effect_create_blur(radius, gaussian != 0);
     if (!effect) return -1;
 
+    effects_engine_lock_chain(engine);
     int index = effect_chain_add(engine->chain, effect);
+    effects_engine_unlock_chain(engine);
     free(effect);
 
     return index;
@@ -475,16 +1750,16 @@ int js_effect_chain_add_blur(int engine_ptr, float radius, int gaussian) {
 
 // Add transform effect
 EMSCRIPTEN_KEEPALIVE
-int js_effect_chain_add_transform(int engine_ptr, float scale, float rotation, int flip_h, int flip_v) {
-    if (engine_ptr == 0) return -1;
-
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+int js_effect_chain_add_transform(engine_handle_t engine_handle, float scale, float rotation, int flip_h, int flip_v) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return -1;
 
     effect_t* effect = effect_create_transform(scale, rotation, flip_h, flip_v);
     if (!effect) return -1;
 
+    effects_engine_lock_chain(engine);
     int index = effect_chain_add(engine->chain, effect);
+    effects_engine_unlock_chain(engine);
     free(effect);
 
     return index;
@@ -492,16 +1767,16 @@ int js_effect_chain_add_transform(int engine_ptr, float scale, float rotation, i
 
 // Add generic filter effect
 EMSCRIPTEN_KEEPALIVE
-int js_effect_chain_add_filter(int engine_ptr, int filter_type, float intensity) {
-    if (engine_ptr == 0) return -1;
-
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+int js_effect_chain_add_filter(engine_handle_t engine_handle, int filter_type, float intensity) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return -1;
 
     effect_t* effect = effect_create_filter((filter_type_t)filter_type, intensity);
     if (!effect) return -1;
 
+    effects_engine_lock_chain(engine);
     int index = effect_chain_add(engine->chain, effect);
+    effects_engine_unlock_chain(engine);
     free(effect);
 
     return index;
@@ -509,22 +1784,20 @@ int js_effect_chain_add_filter(int engine_ptr, int filter_type, float intensity)
 
 // Clear all effects
 EMSCRIPTEN_KEEPALIVE
-void js_effect_chain_clear(int engine_ptr) {
-    if (engine_ptr == 0) return;
-
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+void js_effect_chain_clear(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return;
 
+    effects_engine_lock_chain(engine);
     effect_chain_clear(engine->chain);
+    effects_engine_unlock_chain(engine);
 }
 
 // Process frame with all effects
 EMSCRIPTEN_KEEPALIVE
-int js_effects_process_frame(int engine_ptr, uint8_t* frame_data, int width, int height, int format, double timestamp) {
-    if (engine_ptr == 0 || !frame_data || width <= 0 || height <= 0) return 0;
-
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
-    if (!engine) return 0;
+int js_effects_process_frame(engine_handle_t engine_handle, uint8_t* frame_data, int width, int height, int format, double timestamp) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || !frame_data || width <= 0 || height <= 0) return 0;
 
     // Create temporary frame structure
     video_frame_t frame;
@@ -539,42 +1812,348 @@ int js_effects_process_frame(int engine_ptr, uint8_t* frame_data, int width, int
     return effects_process_frame(engine, &frame, timestamp) ? 1 : 0;
 }
 
-// Get effect chain count
+// Process frame within a time budget; returns the quality level used, -1 on failure
+EMSCRIPTEN_KEEPALIVE
+int js_effects_process_frame_budget(engine_handle_t engine_handle, uint8_t* frame_data, int width, int height, int format,
+                                    double timestamp, double budget_ms) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || !frame_data || width <= 0 || height <= 0) return -1;
+
+    video_frame_t frame;
+    frame.data = frame_data;
+    frame.width = width;
+    frame.height = height;
+    frame.stride = width * 4; // Assume RGBA
+    frame.format = format;
+    frame.timestamp = timestamp;
+    frame.frame_number = engine->frames_processed;
+
+    render_quality_t quality;
+    if (!effects_process_frame_budget(engine, &frame, timestamp, budget_ms, &quality)) return -1;
+    return (int)quality;
+}
+
+// Quality level used for the last frame (render_quality_t)
+EMSCRIPTEN_KEEPALIVE
+int js_effects_get_last_quality(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return (int)engine->last_quality;
+}
+
+// Size the session slots; 1 on success
+EMSCRIPTEN_KEEPALIVE
+int js_engine_set_session_size(engine_handle_t engine_handle, int width, int height) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return effects_engine_set_session_size(engine, width, height) ? 1 : 0;
+}
+
+// Session input slot; JS writes RGBA pixels here (0 before the size is set)
+EMSCRIPTEN_KEEPALIVE
+uint8_t* js_engine_get_input_slot(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return NULL;
+
+    return engine->input_slot.data;
+}
+
+// Session output slot; JS reads the processed frame here as a view
+EMSCRIPTEN_KEEPALIVE
+uint8_t* js_engine_get_output_slot(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return NULL;
+
+    return engine->output_slot.data;
+}
+
+// Preview at 1/scale of the session size (1, 2 or 4); 1 on success. The
+// output slot shrinks to match; read its size back before viewing it.
+EMSCRIPTEN_KEEPALIVE
+int js_engine_set_render_scale(engine_handle_t engine_handle, int scale) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return effects_engine_set_render_scale(engine, scale) ? 1 : 0;
+}
+
+// Output slot size at the current session size and render scale
+EMSCRIPTEN_KEEPALIVE
+int js_engine_get_output_width(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return engine->output_slot.width;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int js_engine_get_output_height(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return engine->output_slot.height;
+}
+
+// Process the input slot into the output slot (budget_ms <= 0 = full
+// quality); returns the quality level used, -1 on failure
+EMSCRIPTEN_KEEPALIVE
+int js_engine_process_session(engine_handle_t engine_handle, double timestamp, double budget_ms) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return -1;
+
+    render_quality_t quality;
+    if (!effects_engine_process_session(engine, timestamp, budget_ms, &quality)) return -1;
+    return (int)quality;
+}
+
+// Refine the last session preview; bands still to render, -1 on failure
+EMSCRIPTEN_KEEPALIVE
+int js_engine_refine_session(engine_handle_t engine_handle, int max_bands) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return -1;
+
+    return effects_engine_refine_session(engine, max_bands);
+}
+
+// Queue refinement of the last session preview on the engine's scheduler
 EMSCRIPTEN_KEEPALIVE
-int js_effect_chain_get_count(int engine_ptr) {
-    if (engine_ptr == 0) return 0;
+int js_engine_submit_refine(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return effects_engine_submit_refine(engine) ? 1 : 0;
+}
+
+// Name the source of the next frame (exact up to 2^53; 0 = unknown)
+EMSCRIPTEN_KEEPALIVE
+void js_engine_set_source_id(engine_handle_t engine_handle, double source_id) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_set_source_id(engine, source_id > 0 ? (uint64_t)source_id : 0);
+}
+
+// Stage cache budget in megabytes (0 disables the cache)
+EMSCRIPTEN_KEEPALIVE
+void js_engine_set_stage_cache_budget(engine_handle_t engine_handle, int megabytes) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_set_stage_cache_budget(engine, megabytes > 0 ? (size_t)megabytes << 20 : 0);
+}
+
+// Result cache budget in megabytes (0 disables the cache); compress stores
+// frames QOI-compressed, trading a pass per store and hit for 2-4x capacity
+EMSCRIPTEN_KEEPALIVE
+void js_engine_set_result_cache(engine_handle_t engine_handle, int megabytes, int compress) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_set_result_cache(engine, megabytes > 0 ? (size_t)megabytes << 20 : 0, compress != 0);
+}
+
+// Forget all cached stages and frames
+EMSCRIPTEN_KEEPALIVE
+void js_engine_clear_caches(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_clear_caches(engine);
+}
+
+// Process up to max_frames published ring slots (0 = drain the ring)
+EMSCRIPTEN_KEEPALIVE
+int js_effects_process_ring(engine_handle_t engine_handle, engine_handle_t ring_handle, int max_frames) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!engine || !ring) return 0;
+
+    return effects_engine_process_ring(engine, ring, max_frames);
+}
+
+// Attach engine to a scheduler (scheduler handle 0 detaches)
+EMSCRIPTEN_KEEPALIVE
+void js_effects_engine_set_scheduler(engine_handle_t engine_handle, engine_handle_t scheduler_handle, int priority) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
 
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+    render_scheduler_t* scheduler = handle_get(scheduler_handle, HANDLE_TYPE_SCHEDULER);
+
+    effects_engine_set_scheduler(engine, scheduler, (render_priority_t)priority);
+}
+
+// Queue ring processing at a priority class
+EMSCRIPTEN_KEEPALIVE
+int js_effects_submit_ring(engine_handle_t engine_handle, engine_handle_t ring_handle, int priority) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!engine || !ring) return 0;
+
+    return effects_engine_submit_ring(engine, ring, (render_priority_t)priority) ? 1 : 0;
+}
+
+// Pre-render up to max_frames published ring frames (0 = drain the ring);
+// negative when stopped by an edit or a full cache
+EMSCRIPTEN_KEEPALIVE
+int js_engine_prerender_ring(engine_handle_t engine_handle, engine_handle_t ring_handle, int max_frames) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!engine || !ring) return 0;
+
+    return effects_engine_prerender_ring(engine, ring, max_frames);
+}
+
+// Queue pre-rendering of a ring at prefetch priority
+EMSCRIPTEN_KEEPALIVE
+int js_engine_submit_prerender(engine_handle_t engine_handle, engine_handle_t ring_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    frame_ring_t* ring = handle_get(ring_handle, HANDLE_TYPE_FRAME_RING);
+    if (!engine || !ring) return 0;
+
+    return effects_engine_submit_prerender(engine, ring) ? 1 : 0;
+}
+
+// Abandon the in-flight frame (e.g. the user scrubbed past it)
+EMSCRIPTEN_KEEPALIVE
+void js_effects_cancel(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_cancel(engine);
+}
+
+// Only process the newest published ring frame
+EMSCRIPTEN_KEEPALIVE
+void js_effects_set_drop_stale_frames(engine_handle_t engine_handle, int drop) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_set_drop_stale_frames(engine, drop != 0);
+}
+
+// Frames abandoned by cancellation or stale-frame dropping
+EMSCRIPTEN_KEEPALIVE
+int js_effects_get_frames_cancelled(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
+
+    return engine->frames_cancelled;
+}
+
+// Get effect chain count
+EMSCRIPTEN_KEEPALIVE
+int js_effect_chain_get_count(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return 0;
 
     return engine->chain->count;
 }
 
-// Remove effect by index
+// Remove effect by index; later effects move down by one
+EMSCRIPTEN_KEEPALIVE
+int js_effect_chain_remove(engine_handle_t engine_handle, int index) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || !engine->chain) return 0;
+
+    effects_engine_lock_chain(engine);
+    bool removed = effect_chain_remove(engine->chain, index);
+    effects_engine_unlock_chain(engine);
+    return removed ? 1 : 0;
+}
+
+// Keyframe a parameter of the effect at a chain index, as returned by
+// js_effect_chain_add_*; x1-y2 are the Bezier easing controls (ignored for
+// other interpolations). 1 on success.
 EMSCRIPTEN_KEEPALIVE
-int js_effect_chain_remove(int engine_ptr, int index) {
-    if (engine_ptr == 0) return 0;
+int js_effect_set_keyframe(engine_handle_t engine_handle, int index, int param, float time, float value,
+                           int interpolation, float x1, float y1, float x2, float y2) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || !engine->chain) return 0;
+
+    float ease[4] = {x1, y1, x2, y2};
+    effects_engine_lock_chain(engine);
+    effect_chain_t* chain = engine->chain;
+    bool set = index >= 0 && index < chain->count &&
+               effect_set_keyframe(&chain->effects[index], (effect_param_t)param, time, value,
+                                   (keyframe_interp_t)interpolation, ease);
+    if (set) chain->revision++;
+    effects_engine_unlock_chain(engine);
+    return set ? 1 : 0;
+}
+
+// Drop a parameter's keyframes, or all of the effect's with EFFECT_PARAM_COUNT
+EMSCRIPTEN_KEEPALIVE
+int js_effect_clear_keyframes(engine_handle_t engine_handle, int index, int param) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine || !engine->chain) return 0;
+
+    effects_engine_lock_chain(engine);
+    effect_chain_t* chain = engine->chain;
+    bool found = index >= 0 && index < chain->count;
+    if (found) {
+        effect_clear_keyframes(&chain->effects[index], (effect_param_t)param);
+        chain->revision++;
+    }
+    effects_engine_unlock_chain(engine);
+    return found ? 1 : 0;
+}
 
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
+// Limit the effect at a chain index, as returned by js_effect_chain_add_*,
+// to timeline seconds [start_time, end_time]. The range does not change the
+// effect's place in processing order, so the index stays valid.
+EMSCRIPTEN_KEEPALIVE
+int js_effect_set_time_range(engine_handle_t engine_handle, int index, double start_time, double end_time) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
     if (!engine || !engine->chain) return 0;
 
-    return effect_chain_remove(engine->chain, index) ? 1 : 0;
+    effects_engine_lock_chain(engine);
+    effect_chain_t* chain = engine->chain;
+    bool found = index >= 0 && index < chain->count;
+    if (found) {
+        effect_t* effect = &chain->effects[index];
+        effect->start_time = start_time;
+        effect->end_time = end_time;
+        chain->revision++;
+    }
+    effects_engine_unlock_chain(engine);
+    return found ? 1 : 0;
 }
 
 // Get performance stats
 EMSCRIPTEN_KEEPALIVE
-double js_effects_get_last_process_time(int engine_ptr) {
-    if (engine_ptr == 0) return 0.0;
+double js_effects_get_last_process_time(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0.0;
 
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
     return effects_engine_get_last_process_time(engine);
 }
 
 // Get frames processed count
 EMSCRIPTEN_KEEPALIVE
-int js_effects_get_frames_processed(int engine_ptr) {
-    if (engine_ptr == 0) return 0;
+int js_effects_get_frames_processed(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return 0;
 
-    effects_engine_t* engine = (effects_engine_t*)(uintptr_t)engine_ptr;
-    return engine ? engine->frames_processed : 0;
-}
\ No newline at end of file
+    return engine->frames_processed;
+}
+
+// Refresh and return the engine's profile snapshot (effects_profile_t*)
+EMSCRIPTEN_KEEPALIVE
+const effects_profile_t* js_effects_get_profile(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return NULL;
+
+    effects_engine_get_profile(engine, &engine->profile);
+    return &engine->profile;
+}
+
+// Clear all latency histograms
+EMSCRIPTEN_KEEPALIVE
+void js_effects_reset_profile(engine_handle_t engine_handle) {
+    effects_engine_t* engine = handle_get(engine_handle, HANDLE_TYPE_EFFECTS_ENGINE);
+    if (!engine) return;
+
+    effects_engine_reset_profile(engine);
+}
@@ -0,0 +1,155 @@
+#include "../include/interval_index.h"
+#include "../include/engine_counters.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct interval_t {
+    double start;
+    double end;
+    int id;
+} interval_t;
+
+static int interval_compare(const void* a, const void* b) {
+    const interval_t* x = a;
+    const interval_t* y = b;
+    if (x->start != y->start) return x->start < y->start ? -1 : 1;
+    return x->id - y->id;
+}
+
+static int double_compare(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+static bool grow(void** array, size_t element, int capacity) {
+    void* grown = realloc(*array, element * capacity);
+    if (!grown) return false;
+    *array = grown;
+    return true;
+}
+
+static bool reserve(interval_index_t* index, int count) {
+    if (count <= index->capacity) return true;
+
+    int capacity = index->capacity > 0 ? index->capacity : 64;
+    while (capacity < count) capacity *= 2;
+    if (!grow((void**)&index->starts, sizeof(double), capacity) ||
+        !grow((void**)&index->ends, sizeof(double), capacity) ||
+        !grow((void**)&index->max_ends, sizeof(double), capacity) ||
+        !grow((void**)&index->sorted_ends, sizeof(double), capacity) ||
+        !grow((void**)&index->ids, sizeof(int), capacity) ||
+        !grow((void**)&index->hits, sizeof(int), capacity)) {
+        return false;
+    }
+    engine_counter_alloc((sizeof(double) * 4 + sizeof(int) * 2) * (size_t)(capacity - index->capacity));
+    index->capacity = capacity;
+    return true;
+}
+
+// Subtree over positions [lo, hi) is rooted at their midpoint
+static double build_max_ends(interval_index_t* index, int lo, int hi) {
+    if (lo >= hi) return -INFINITY;
+
+    int mid = lo + (hi - lo) / 2;
+    double max_end = index->ends[mid];
+    double left = build_max_ends(index, lo, mid);
+    double right = build_max_ends(index, mid + 1, hi);
+    if (left > max_end) max_end = left;
+    if (right > max_end) max_end = right;
+    index->max_ends[mid] = max_end;
+    return max_end;
+}
+
+bool interval_index_build(interval_index_t* index, const double* starts, const double* ends,
+                          const int* ids, int count) {
+    if (!index || count < 0) return false;
+    if (!reserve(index, count > 0 ? count : 1)) return false;
+
+    interval_t* intervals = malloc(sizeof(interval_t) * (count > 0 ? count : 1));
+    if (!intervals) return false;
+    for (int i = 0; i < count; i++) {
+        intervals[i].start = starts[i];
+        intervals[i].end = ends[i];
+        intervals[i].id = ids[i];
+    }
+    qsort(intervals, count, sizeof(interval_t), interval_compare);
+
+    for (int i = 0; i < count; i++) {
+        index->starts[i] = intervals[i].start;
+        index->ends[i] = intervals[i].end;
+        index->ids[i] = intervals[i].id;
+    }
+    free(intervals);
+
+    memcpy(index->sorted_ends, index->ends, sizeof(double) * count);
+    qsort(index->sorted_ends, count, sizeof(double), double_compare);
+    index->count = count;
+    build_max_ends(index, 0, count);
+    return true;
+}
+
+void interval_index_free(interval_index_t* index) {
+    if (!index) return;
+
+    free(index->starts);
+    free(index->ends);
+    free(index->max_ends);
+    free(index->sorted_ends);
+    free(index->ids);
+    free(index->hits);
+    memset(index, 0, sizeof(interval_index_t));
+}
+
+static void query_subtree(interval_index_t* index, int lo, int hi, double t, int* count, interval_window_t* window) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (index->max_ends[mid] < t) return; // Everything below ended before t
+
+        query_subtree(index, lo, mid, t, count, window);
+        if (index->starts[mid] > t) return;   // So does everything to the right
+
+        if (index->ends[mid] >= t) {
+            index->hits[(*count)++] = index->ids[mid];
+            if (index->starts[mid] > window->from) window->from = index->starts[mid];
+            if (index->ends[mid] < window->to) window->to = index->ends[mid];
+        }
+        lo = mid + 1;
+    }
+}
+
+int* interval_index_query(interval_index_t* index, double t, int* count, interval_window_t* window) {
+    window->from = -INFINITY;
+    window->to = INFINITY;
+    *count = 0;
+    query_subtree(index, 0, index->count, t, count, window);
+
+    // First start after t
+    int lo = 0;
+    int hi = index->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (index->starts[mid] <= t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    window->before = lo < index->count ? index->starts[lo] : INFINITY;
+
+    // Last end before t
+    lo = 0;
+    hi = index->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (index->sorted_ends[mid] < t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    window->after = lo > 0 ? index->sorted_ends[lo - 1] : -INFINITY;
+
+    return index->hits;
+}
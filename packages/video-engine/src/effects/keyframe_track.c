@@ -0,0 +1,114 @@
+#include "../include/keyframe_track.h"
+#include <math.h>
+#include <string.h>
+
+bool keyframe_track_set(keyframe_track_t* track, float time, float value,
+                        keyframe_interp_t interpolation, const float* ease) {
+    if (!track || !isfinite(time) || interpolation < 0 || interpolation >= KEYFRAME_INTERP_COUNT) return false;
+
+    int index = 0;
+    while (index < track->count && track->keys[index].time < time) index++;
+
+    if (index == track->count || track->keys[index].time != time) {
+        if (track->count >= KEYFRAME_TRACK_MAX_KEYS) return false;
+
+        memmove(&track->keys[index + 1], &track->keys[index], (track->count - index) * sizeof(keyframe_t));
+        memmove(&track->interpolation[index + 1], &track->interpolation[index], track->count - index);
+        track->count++;
+    }
+
+    keyframe_t* key = &track->keys[index];
+    memset(key, 0, sizeof(keyframe_t));
+    key->time = time;
+    key->value = value;
+    if (interpolation == KEYFRAME_INTERP_BEZIER && ease) {
+        memcpy(key->ease, ease, sizeof(key->ease));
+    }
+    track->interpolation[index] = (uint8_t)interpolation;
+    return true;
+}
+
+// One coordinate of a cubic Bezier from 0 to 1 with inner control points p1, p2
+static inline float bezier_at(float p1, float p2, float s) {
+    float u = 1.0f - s;
+    return 3.0f * u * u * s * p1 + 3.0f * u * s * s * p2 + s * s * s;
+}
+
+static inline float bezier_slope(float p1, float p2, float s) {
+    float u = 1.0f - s;
+    return 3.0f * u * u * p1 + 6.0f * u * s * (p2 - p1) + 3.0f * s * s * (1.0f - p2);
+}
+
+// Eased progress for linear progress x: solve bezier_x(s) = x, return bezier_y(s)
+static float bezier_ease(const float* ease, float x) {
+    float x1 = fminf(fmaxf(ease[0], 0.0f), 1.0f);
+    float x2 = fminf(fmaxf(ease[2], 0.0f), 1.0f);
+
+    // Newton from s = x converges in a few steps on typical curves
+    float s = x;
+    for (int i = 0; i < 8; i++) {
+        float error = bezier_at(x1, x2, s) - x;
+        if (fabsf(error) < 1e-6f) return bezier_at(ease[1], ease[3], s);
+
+        float slope = bezier_slope(x1, x2, s);
+        if (fabsf(slope) < 1e-6f) break;
+        s = fminf(fmaxf(s - error / slope, 0.0f), 1.0f);
+    }
+
+    // Flat stretches stall Newton; with x1, x2 in [0, 1] bezier_x is monotonic
+    float lo = 0.0f;
+    float hi = 1.0f;
+    for (int i = 0; i < 24; i++) {
+        s = 0.5f * (lo + hi);
+        if (bezier_at(x1, x2, s) < x) {
+            lo = s;
+        } else {
+            hi = s;
+        }
+    }
+    return bezier_at(ease[1], ease[3], 0.5f * (lo + hi));
+}
+
+float keyframe_track_evaluate(const keyframe_track_t* track, double time, uint8_t* hint) {
+    int count = track->count;
+    const keyframe_t* keys = track->keys;
+    if (count == 0) return 0.0f;
+    if (time <= keys[0].time) return keys[0].value;
+    if (time >= keys[count - 1].time) return keys[count - 1].value;
+
+    // Segment i runs from keys[i] to keys[i + 1]
+    int segment = hint ? *hint : 0;
+    if (segment >= count - 1 || time < keys[segment].time || time >= keys[segment + 1].time) {
+        if (segment + 2 < count && time >= keys[segment + 1].time && time < keys[segment + 2].time) {
+            segment++;
+        } else {
+            int lo = 0;
+            int hi = count - 2;
+            while (lo < hi) {
+                int mid = (lo + hi + 1) / 2;
+                if (keys[mid].time <= time) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            segment = lo;
+        }
+        if (hint) *hint = (uint8_t)segment;
+    }
+
+    const keyframe_t* from = &keys[segment];
+    const keyframe_t* to = &keys[segment + 1];
+    float t = (float)((time - from->time) / (to->time - from->time));
+
+    switch (track->interpolation[segment]) {
+        case KEYFRAME_INTERP_HOLD:
+            return from->value;
+        case KEYFRAME_INTERP_BEZIER:
+            t = bezier_ease(from->ease, t);
+            break;
+        default:
+            break;
+    }
+    return from->value + (to->value - from->value) * t;
+}
@@ -0,0 +1,190 @@
+#include "../include/result_cache.h"
+#include "../include/engine_counters.h"
+#include "../include/qoi_codec.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void free_entry(result_cache_t* cache, result_cache_entry_t* entry) {
+    free(entry->data);
+    cache->used -= entry->size;
+    if (entry->prefetched) cache->prefetched_bytes -= entry->size;
+    memset(entry, 0, sizeof(result_cache_entry_t));
+}
+
+// Drop least recently used frames until extra bytes fit the budget
+static bool make_room(result_cache_t* cache, size_t extra) {
+    if (extra > cache->budget) return false;
+
+    while (cache->used + extra > cache->budget) {
+        result_cache_entry_t* oldest = NULL;
+        for (int i = 0; i < RESULT_CACHE_ENTRIES; i++) {
+            result_cache_entry_t* entry = &cache->entries[i];
+            if (entry->key != 0 && (!oldest || entry->last_used < oldest->last_used)) {
+                oldest = entry;
+            }
+        }
+        if (!oldest) return false;
+        free_entry(cache, oldest);
+    }
+    return true;
+}
+
+void result_cache_init(result_cache_t* cache, size_t budget) {
+    if (!cache) return;
+
+    memset(cache, 0, sizeof(result_cache_t));
+    cache->budget = budget;
+}
+
+void result_cache_clear(result_cache_t* cache) {
+    if (!cache) return;
+
+    for (int i = 0; i < RESULT_CACHE_ENTRIES; i++) {
+        free_entry(cache, &cache->entries[i]);
+    }
+}
+
+void result_cache_destroy(result_cache_t* cache) {
+    if (!cache) return;
+
+    result_cache_clear(cache);
+    free(cache->scratch);
+    cache->scratch = NULL;
+    cache->scratch_capacity = 0;
+}
+
+void result_cache_set_budget(result_cache_t* cache, size_t budget) {
+    if (!cache) return;
+
+    cache->budget = budget;
+    make_room(cache, 0);
+    if (budget == 0) {
+        free(cache->scratch);
+        cache->scratch = NULL;
+        cache->scratch_capacity = 0;
+    }
+}
+
+void result_cache_set_compression(result_cache_t* cache, bool compress) {
+    if (!cache) return;
+
+    cache->compress = compress;
+}
+
+static result_cache_entry_t* find_entry(result_cache_t* cache, uint64_t key) {
+    for (int i = 0; i < RESULT_CACHE_ENTRIES; i++) {
+        if (cache->entries[i].key == key) return &cache->entries[i];
+    }
+    return NULL;
+}
+
+bool result_cache_lookup(result_cache_t* cache, uint64_t key, video_frame_t* frame,
+                         render_quality_t max_quality, render_quality_t* quality) {
+    if (!cache || !frame || key == 0 || cache->budget == 0) return false;
+
+    result_cache_entry_t* entry = find_entry(cache, key);
+    if (!entry || entry->width != frame->width || entry->height != frame->height ||
+        entry->quality > max_quality) {
+        return false;
+    }
+
+    size_t pixel_count = (size_t)frame->width * frame->height;
+    if (entry->compressed) {
+        if (!qoi_decode(entry->data, entry->size, frame->data, pixel_count)) {
+            free_entry(cache, entry);
+            return false;
+        }
+    } else {
+        memcpy(frame->data, entry->data, pixel_count * 4);
+        engine_counter_add(ENGINE_COUNTER_CHAIN_COPY_BYTES, pixel_count * 4);
+    }
+
+    if (entry->prefetched) {
+        entry->prefetched = false;
+        cache->prefetched_bytes -= entry->size;
+    }
+    entry->last_used = ++cache->clock;
+    if (quality) *quality = entry->quality;
+    return true;
+}
+
+bool result_cache_store(result_cache_t* cache, uint64_t key, const video_frame_t* frame,
+                        render_quality_t quality, bool prefetched) {
+    if (!cache || !frame || !frame->data || key == 0 || cache->budget == 0) return false;
+
+    result_cache_entry_t* entry = find_entry(cache, key);
+    if (entry) {
+        if (entry->quality < quality) return false;
+        free_entry(cache, entry);
+    }
+
+    size_t pixel_count = (size_t)frame->width * frame->height;
+    const uint8_t* source = frame->data;
+    size_t size = pixel_count * 4;
+    bool compressed = false;
+
+    if (cache->compress) {
+        if (size > cache->scratch_capacity) {
+            uint8_t* scratch = realloc(cache->scratch, size);
+            if (scratch) {
+                engine_counter_alloc(size);
+                cache->scratch = scratch;
+                cache->scratch_capacity = size;
+            }
+        }
+
+        // Only worth keeping when smaller than raw; noise can defeat the codec
+        size_t encoded = size <= cache->scratch_capacity
+                             ? qoi_encode(frame->data, pixel_count, cache->scratch, size - 1)
+                             : 0;
+        if (encoded > 0) {
+            source = cache->scratch;
+            size = encoded;
+            compressed = true;
+        }
+    }
+
+    if (!make_room(cache, size)) return false;
+
+    entry = find_entry(cache, 0);
+    if (!entry) {
+        // Every slot is taken by frames small enough to fit the budget
+        result_cache_entry_t* oldest = &cache->entries[0];
+        for (int i = 1; i < RESULT_CACHE_ENTRIES; i++) {
+            if (cache->entries[i].last_used < oldest->last_used) oldest = &cache->entries[i];
+        }
+        free_entry(cache, oldest);
+        entry = oldest;
+    }
+
+    entry->data = malloc(size);
+    if (!entry->data) return false;
+    engine_counter_alloc(size);
+    memcpy(entry->data, source, size);
+
+    entry->key = key;
+    entry->size = size;
+    entry->width = frame->width;
+    entry->height = frame->height;
+    entry->quality = quality;
+    entry->compressed = compressed;
+    entry->prefetched = prefetched;
+    entry->last_used = ++cache->clock;
+    cache->used += size;
+    if (prefetched) cache->prefetched_bytes += size;
+    return true;
+}
+
+bool result_cache_can_prefetch(const result_cache_t* cache, size_t bytes) {
+    if (!cache) return false;
+
+    return cache->prefetched_bytes + bytes <= cache->budget / 2;
+}
+
+void result_cache_evict_prefetched(result_cache_t* cache) {
+    if (!cache) return;
+
+    for (int i = 0; i < RESULT_CACHE_ENTRIES; i++) {
+        if (cache->entries[i].prefetched) free_entry(cache, &cache->entries[i]);
+    }
+}
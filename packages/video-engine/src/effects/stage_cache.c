@@ -0,0 +1,96 @@
+#include "../include/stage_cache.h"
+#include "../include/engine_counters.h"
+#include <stdlib.h>
+#include <string.h>
+
+void stage_cache_init(stage_cache_t* cache, size_t budget) {
+    if (!cache) return;
+
+    memset(cache, 0, sizeof(stage_cache_t));
+    cache->budget = budget;
+}
+
+void stage_cache_destroy(stage_cache_t* cache) {
+    if (!cache) return;
+
+    free(cache->frame.data);
+    size_t budget = cache->budget;
+    memset(cache, 0, sizeof(stage_cache_t));
+    cache->budget = budget;
+}
+
+void stage_cache_set_budget(stage_cache_t* cache, size_t budget) {
+    if (!cache) return;
+
+    stage_cache_destroy(cache);
+    cache->budget = budget;
+}
+
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+uint64_t stage_cache_seed(uint64_t source_id, double timestamp, int width, int height, int quality, int scale) {
+    uint64_t time_bits;
+    memcpy(&time_bits, &timestamp, sizeof(time_bits));
+
+    uint64_t h = mix64(source_id);
+    h = mix64(h ^ time_bits);
+    h = mix64(h ^ ((uint64_t)(uint32_t)width << 32 | (uint32_t)height));
+    return mix64(h ^ ((uint64_t)(uint32_t)quality << 32 | (uint32_t)scale));
+}
+
+int stage_cache_find(const stage_cache_t* cache, const uint64_t* keys, int count) {
+    if (!cache || !keys || cache->key == 0) return -1;
+
+    if (count > STAGE_CACHE_STAGES) count = STAGE_CACHE_STAGES;
+    for (int stage = count - 1; stage >= 0; stage--) {
+        if (keys[stage] == cache->key) return stage;
+    }
+    return -1;
+}
+
+int stage_cache_plan(stage_cache_t* cache, const uint64_t* keys, int count, int resume) {
+    if (!cache || !keys) return -1;
+
+    if (count > STAGE_CACHE_STAGES) count = STAGE_CACHE_STAGES;
+    int changed = 0;
+    while (changed < count && changed < cache->count && keys[changed] == cache->keys[changed]) changed++;
+
+    memcpy(cache->keys, keys, sizeof(uint64_t) * count);
+    cache->count = count;
+
+    // Nothing changed, or effects only dropped off the end: the snapshot stays
+    if (changed >= count || changed - 1 <= resume) return -1;
+    return changed - 1;
+}
+
+bool stage_cache_store(stage_cache_t* cache, const video_frame_t* frame, uint64_t key) {
+    if (!cache || !frame || cache->budget == 0) return false;
+
+    size_t size = (size_t)frame->width * frame->height * 4;
+    cache->key = 0;
+
+    if (size > cache->capacity) {
+        if (size > cache->budget) return false;
+
+        uint8_t* data = realloc(cache->frame.data, size);
+        if (!data) return false;
+        engine_counter_alloc(size);
+        cache->frame.data = data;
+        cache->capacity = size;
+    }
+
+    memcpy(cache->frame.data, frame->data, size);
+    cache->frame.width = frame->width;
+    cache->frame.height = frame->height;
+    cache->frame.stride = frame->width * 4;
+    cache->frame.format = 1; // RGBA
+    cache->key = key;
+    return true;
+}
@@ -1,4 +1,6 @@
 #include "filters.h"
+#include "render_scheduler.h"
+#include "engine_counters.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,11 +18,15 @@ void filter_blur(video_frame_t* frame, blur_params_t* params) {
     // Allocate temporary buffer
     uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
     if (!temp_data) return;
+    engine_counter_alloc(width * height * 4);
     
     memcpy(temp_data, frame->data, width * height * 4);
+    engine_counter_add(ENGINE_COUNTER_SCRATCH_COPY_BYTES, width * height * 4);
     
     // Horizontal blur pass
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
             int count = 0;
@@ -45,10 +51,19 @@ void filter_blur(video_frame_t* frame, blur_params_t* params) {
         }
     }
     
+    // Cancelled during the horizontal pass: skip the vertical one
+    if (render_cancelled()) {
+        free(temp_data);
+        return;
+    }
+    
     // Vertical blur pass
     memcpy(temp_data, frame->data, width * height * 4);
+    engine_counter_add(ENGINE_COUNTER_SCRATCH_COPY_BYTES, width * height * 4);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
             int count = 0;
@@ -85,8 +100,10 @@ void filter_sharpen(video_frame_t* frame, float intensity) {
     // Allocate temporary buffer
     uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
     if (!temp_data) return;
+    engine_counter_alloc(width * height * 4);
     
     memcpy(temp_data, frame->data, width * height * 4);
+    engine_counter_add(ENGINE_COUNTER_SCRATCH_COPY_BYTES, width * height * 4);
     
     // Apply sharpening kernel
     float kernel[9] = {
@@ -96,6 +113,8 @@ void filter_sharpen(video_frame_t* frame, float intensity) {
     };
     
     for (int y = 1; y < height - 1; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 1; x < width - 1; x++) {
             float sum_r = 0, sum_g = 0, sum_b = 0;
             
@@ -1,6 +1,8 @@
 #include "filters.h"
+#include "render_scheduler.h"
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Clamp value between 0 and 255
 static inline uint8_t clamp_uint8(float value) {
@@ -65,71 +67,81 @@ static void hsv_to_rgb(float h, float s, float v, uint8_t* r, uint8_t* g, uint8_
     }
 }
 
+bool color_lut_prepare(color_lut_t* lut, const color_correction_t* params) {
+    float key[4] = {params->brightness, params->contrast, params->gamma, params->exposure};
+    if (lut->valid && memcmp(lut->key, key, sizeof(key)) == 0) return false;
+
+    // Same operations in the same order as the per-pixel code this replaced,
+    // so the output is unchanged
+    float exposure_multiplier = powf(2.0f, params->exposure);
+    for (int level = 0; level < 256; level++) {
+        float value = level / 255.0f;
+        value += params->brightness;
+        value = (value - 0.5f) * (1.0f + params->contrast) + 0.5f;
+        if (params->gamma != 1.0f) {
+            value = powf(fmaxf(value, 0.0f), 1.0f / params->gamma);
+        }
+        value *= exposure_multiplier;
+
+        lut->tone[level] = clamp_uint8(value * 255.0f);
+    }
+
+    memcpy(lut->key, key, sizeof(key));
+    lut->valid = true;
+    return true;
+}
+
 void filter_color_correction(video_frame_t* frame, color_correction_t* params) {
     if (!frame || !frame->data || !params || frame->format != 1) return; // RGBA only
-    
-    int pixel_count = frame->width * frame->height;
+
+    color_lut_t lut;
+    lut.valid = false;
+    color_lut_prepare(&lut, params);
+    filter_color_correction_lut(frame, params, &lut);
+}
+
+void filter_color_correction_lut(video_frame_t* frame, const color_correction_t* params, const color_lut_t* lut) {
+    if (!frame || !frame->data || !params || !lut || frame->format != 1) return; // RGBA only
+
+    int width = frame->width;
+    int height = frame->height;
     uint8_t* data = frame->data;
-    
-    for (int i = 0; i < pixel_count; i++) {
-        int idx = i * 4;
-        uint8_t r = data[idx + 0];
-        uint8_t g = data[idx + 1];
-        uint8_t b = data[idx + 2];
-        uint8_t a = data[idx + 3];
-        
-        // Convert to float for processing
-        float rf = r / 255.0f;
-        float gf = g / 255.0f;
-        float bf = b / 255.0f;
-        
-        // Apply brightness
-        rf += params->brightness;
-        gf += params->brightness;
-        bf += params->brightness;
-        
-        // Apply contrast
-        rf = (rf - 0.5f) * (1.0f + params->contrast) + 0.5f;
-        gf = (gf - 0.5f) * (1.0f + params->contrast) + 0.5f;
-        bf = (bf - 0.5f) * (1.0f + params->contrast) + 0.5f;
-        
-        // Apply gamma correction
-        if (params->gamma != 1.0f) {
-            rf = powf(fmaxf(rf, 0.0f), 1.0f / params->gamma);
-            gf = powf(fmaxf(gf, 0.0f), 1.0f / params->gamma);
-            bf = powf(fmaxf(bf, 0.0f), 1.0f / params->gamma);
+    bool hsv = params->saturation != 0.0f || params->hue != 0.0f;
+
+    for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
+        uint8_t* row = data + (size_t)y * width * 4;
+        if (!hsv) {
+            for (int x = 0; x < width; x++) {
+                uint8_t* px = row + x * 4;
+                px[0] = lut->tone[px[0]];
+                px[1] = lut->tone[px[1]];
+                px[2] = lut->tone[px[2]];
+            }
+            continue;
         }
-        
-        // Apply exposure
-        float exposure_multiplier = powf(2.0f, params->exposure);
-        rf *= exposure_multiplier;
-        gf *= exposure_multiplier;
-        bf *= exposure_multiplier;
-        
-        // Apply saturation and hue adjustments using HSV
-        if (params->saturation != 0.0f || params->hue != 0.0f) {
+
+        for (int x = 0; x < width; x++) {
+            uint8_t* px = row + x * 4;
+
+            // Apply saturation and hue adjustments using HSV
             float h, s, v;
-            rgb_to_hsv(clamp_uint8(rf * 255.0f), clamp_uint8(gf * 255.0f), clamp_uint8(bf * 255.0f), &h, &s, &v);
-            
+            uint8_t r, g, b;
+            rgb_to_hsv(lut->tone[px[0]], lut->tone[px[1]], lut->tone[px[2]], &h, &s, &v);
+
             // Adjust hue
             h += params->hue;
-            
+
             // Adjust saturation
             s *= (1.0f + params->saturation);
             s = fmaxf(0.0f, fminf(1.0f, s));
-            
+
             hsv_to_rgb(h, s, v, &r, &g, &b);
-        } else {
-            r = clamp_uint8(rf * 255.0f);
-            g = clamp_uint8(gf * 255.0f);
-            b = clamp_uint8(bf * 255.0f);
+            px[0] = r;
+            px[1] = g;
+            px[2] = b;
         }
-        
-        // Write back to buffer
-        data[idx + 0] = r;
-        data[idx + 1] = g;
-        data[idx + 2] = b;
-        data[idx + 3] = a; // Preserve alpha
     }
 }
 
@@ -1,19 +1,21 @@
 #include "filters.h"
-#include <stdio.h>
+#include "render_scheduler.h"
+#include "engine_counters.h"
+#include "engine_log.h"
 #include <math.h>
 #include <stdlib.h>
 
 void filter_edge_detection_new(video_frame_t* frame, float intensity) {
     if (!frame || !frame->data || intensity < 0.0f) {
-        printf("❌ Invalid parameters for edge detection filter\n");
+        LOG_WARN("Invalid parameters for edge detection filter");
         return;
     }
     
     // Clamp intensity to valid range
     if (intensity > 1.0f) intensity = 1.0f;
     
-    printf("🔍 Applying edge detection filter (intensity: %.2f) to %dx%d frame\n", 
-           intensity, frame->width, frame->height);
+    LOG_FRAME("Applying edge detection filter (intensity: %.2f) to %dx%d frame", 
+              intensity, frame->width, frame->height);
     
     uint8_t* data = frame->data;
     int width = frame->width;
@@ -22,9 +24,10 @@ void filter_edge_detection_new(video_frame_t* frame, float intensity) {
     // Create temporary buffer for processed image
     uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
     if (!temp_data) {
-        printf("❌ Failed to allocate memory for edge detection\n");
+        LOG_ERROR("Failed to allocate memory for edge detection");
         return;
     }
+    engine_counter_alloc(width * height * 4);
     
     // Copy original data to temp buffer
     for (int i = 0; i < width * height * 4; i++) {
@@ -45,6 +48,8 @@ void filter_edge_detection_new(video_frame_t* frame, float intensity) {
     };
     
     for (int y = 1; y < height - 1; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 1; x < width - 1; x++) {
             int pixel_offset = (y * width + x) * 4;
             
@@ -109,5 +114,4 @@ void filter_edge_detection_new(video_frame_t* frame, float intensity) {
     }
     
     free(temp_data);
-    printf("✅ Edge detection filter applied successfully\n");
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "../include/filters.h"
 #include "../include/video_engine.h"
+#include "../include/render_scheduler.h"
+#include "../include/engine_counters.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -114,10 +116,14 @@ void filter_noise_reduction(video_frame_t* frame, float strength) {
     // Create temporary buffer
     uint8_t* temp_data = malloc(width * height * channels);
     if (!temp_data) return;
+    engine_counter_alloc(width * height * channels);
 
     memcpy(temp_data, data, width * height * channels);
+    engine_counter_add(ENGINE_COUNTER_SCRATCH_COPY_BYTES, width * height * channels);
 
     for (int y = 1; y < height - 1; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 1; x < width - 1; x++) {
             for (int c = 0; c < channels; c++) {
                 int idx = (y * width + x) * channels + c;
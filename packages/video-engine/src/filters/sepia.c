@@ -1,4 +1,5 @@
 #include "filters.h"
+#include "render_scheduler.h"
 #include <math.h>
 
 // Apply sepia filter to video frame
@@ -11,6 +12,8 @@ void filter_sepia(video_frame_t* frame, float intensity) {
     
     // Process each pixel
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int index = (y * width + x) * 4; // RGBA format
             
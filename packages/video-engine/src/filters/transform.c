@@ -1,5 +1,8 @@
 #include "filters.h"
+#include "render_scheduler.h"
+#include "engine_counters.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 // Helper function to perform bilinear sampling
@@ -68,8 +71,10 @@ void filter_transform(video_frame_t* frame, transform_params_t* params) {
     // Allocate temporary buffer for transformation
     uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
     if (!temp_data) return;
+    engine_counter_alloc(width * height * 4);
     
     memcpy(temp_data, frame->data, width * height * 4);
+    engine_counter_add(ENGINE_COUNTER_SCRATCH_COPY_BYTES, width * height * 4);
     
     // Clear the output buffer
     memset(frame->data, 0, width * height * 4);
@@ -99,9 +104,13 @@ void filter_transform(video_frame_t* frame, transform_params_t* params) {
     float center_y = height * 0.5f;
     
     uint32_t* output_pixels = (uint32_t*)frame->data;
+    uint32_t* input_pixels = (uint32_t*)temp_data;
+    bool nearest = params->interpolation == TRANSFORM_INTERP_NEAREST;
     
     // Apply transformation for each pixel
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             // Apply cropping
             if (x < crop_left || x >= crop_right || y < crop_top || y >= crop_bottom) {
@@ -130,9 +139,13 @@ void filter_transform(video_frame_t* frame, transform_params_t* params) {
                 source_y = height - 1 - source_y;
             }
             
-            // Sample from source image with bilinear interpolation
+            // Sample from source image
             if (source_x >= 0 && source_x < width && source_y >= 0 && source_y < height) {
-                output_pixels[y * width + x] = sample_pixel(temp_data, width, height, source_x, source_y);
+                if (nearest) {
+                    output_pixels[y * width + x] = input_pixels[(int)source_y * width + (int)source_x];
+                } else {
+                    output_pixels[y * width + x] = sample_pixel(temp_data, width, height, source_x, source_y);
+                }
             } else {
                 // Outside source bounds - set to transparent/black
                 output_pixels[y * width + x] = 0x00000000;
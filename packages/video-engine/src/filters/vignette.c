@@ -1,18 +1,19 @@
 #include "filters.h"
-#include <stdio.h>
+#include "render_scheduler.h"
+#include "engine_log.h"
 #include <math.h>
 
 void filter_vignette(video_frame_t* frame, float intensity) {
     if (!frame || !frame->data || intensity < 0.0f) {
-        printf("❌ Invalid parameters for vignette filter\n");
+        LOG_WARN("Invalid parameters for vignette filter");
         return;
     }
     
     // Clamp intensity to valid range
     if (intensity > 1.0f) intensity = 1.0f;
     
-    printf("⚫ Applying vignette filter (intensity: %.2f) to %dx%d frame\n", 
-           intensity, frame->width, frame->height);
+    LOG_FRAME("Applying vignette filter (intensity: %.2f) to %dx%d frame", 
+              intensity, frame->width, frame->height);
     
     uint8_t* data = frame->data;
     int width = frame->width;
@@ -24,6 +25,8 @@ void filter_vignette(video_frame_t* frame, float intensity) {
     float max_distance = sqrtf(center_x * center_x + center_y * center_y);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int pixel_offset = (y * width + x) * 4; // RGBA format
             
@@ -65,6 +68,4 @@ void filter_vignette(video_frame_t* frame, float intensity) {
             data[pixel_offset + 3] = a; // Keep original alpha
         }
     }
-    
-    printf("✅ Vignette filter applied successfully\n");
 }
\ No newline at end of file
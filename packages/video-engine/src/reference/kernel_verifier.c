@@ -0,0 +1,388 @@
+#include "../include/kernel_verifier.h"
+#include "../include/reference_kernels.h"
+#include "../include/filters.h"
+#include "../include/transitions.h"
+#include "../include/string_builder.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define VERIFY_MAX_WIDTH 97  // Odd on purpose
+#define VERIFY_MAX_HEIGHT 67
+#define VERIFY_PARAMS 8
+#define VERIFY_GUARD_BYTES 64
+#define VERIFY_GUARD_VALUE 0xA5
+
+// One random test case. Inputs hold two RGBA frames' worth of bytes, which
+// conversions reinterpret as RGB or YUV; params are uniform in [0, 1) and
+// each kernel maps them onto its own parameter ranges.
+typedef struct verify_case_t {
+    int width;
+    int height;
+    uint8_t* input[2];
+    float params[VERIFY_PARAMS];
+} verify_case_t;
+
+// Run the production or reference kernel for a case into `out`, returning
+// the number of output bytes to compare
+typedef size_t (*verify_run_fn)(const verify_case_t* c, uint8_t* out, bool reference);
+
+typedef struct verify_kernel_t {
+    const char* name;
+    verify_run_fn run;
+    int max_tolerance;     // Per byte
+    double mean_tolerance;
+} verify_kernel_t;
+
+static inline uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline float random_unit(uint32_t* state) {
+    return (next_random(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+static video_frame_t wrap_frame(uint8_t* data, int width, int height) {
+    video_frame_t frame = {data, width, height, width * 4, 1, 0.0, 0};
+    return frame;
+}
+
+// ============================================================================
+// Kernel adapters
+// ============================================================================
+
+// In-place RGBA filters taking a single strength parameter in [lo, hi]
+#define VERIFY_FILTER(name, lo, hi)                                                     \
+    static size_t run_##name(const verify_case_t* c, uint8_t* out, bool reference) {    \
+        size_t size = (size_t)c->width * c->height * 4;                                 \
+        memcpy(out, c->input[0], size);                                                 \
+        video_frame_t frame = wrap_frame(out, c->width, c->height);                     \
+        float amount = lerp((lo), (hi), c->params[0]);                                  \
+        (reference ? reference_filter_##name : filter_##name)(&frame, amount);          \
+        return size;                                                                    \
+    }
+
+VERIFY_FILTER(sharpen, 0.0f, 2.0f)
+VERIFY_FILTER(edge_detection_new, 0.0f, 1.0f)
+VERIFY_FILTER(noise_reduction, 0.0f, 1.0f)
+VERIFY_FILTER(sepia, 0.0f, 1.0f)
+VERIFY_FILTER(black_and_white, 0.0f, 1.0f)
+VERIFY_FILTER(vintage, 0.0f, 1.0f)
+VERIFY_FILTER(vignette, 0.0f, 1.0f)
+
+static size_t run_color_correction(const verify_case_t* c, uint8_t* out, bool reference) {
+    size_t size = (size_t)c->width * c->height * 4;
+    memcpy(out, c->input[0], size);
+    video_frame_t frame = wrap_frame(out, c->width, c->height);
+
+    color_correction_t params;
+    params.brightness = lerp(-0.5f, 0.5f, c->params[0]);
+    params.contrast = lerp(-0.8f, 1.0f, c->params[1]);
+    params.saturation = c->params[2] < 0.25f ? 0.0f : lerp(-1.0f, 1.0f, c->params[3]);
+    params.hue = c->params[4] < 0.25f ? 0.0f : lerp(-180.0f, 180.0f, c->params[5]);
+    params.gamma = c->params[6] < 0.25f ? 1.0f : lerp(0.3f, 3.0f, c->params[7]);
+    params.exposure = lerp(-2.0f, 2.0f, c->params[1] * c->params[6]);
+
+    (reference ? reference_filter_color_correction : filter_color_correction)(&frame, &params);
+    return size;
+}
+
+static size_t run_blur(const verify_case_t* c, uint8_t* out, bool reference) {
+    size_t size = (size_t)c->width * c->height * 4;
+    memcpy(out, c->input[0], size);
+    video_frame_t frame = wrap_frame(out, c->width, c->height);
+
+    blur_params_t params;
+    params.radius = lerp(0.0f, 12.0f, c->params[0]);
+    params.gaussian = c->params[1] < 0.5f;
+    params.iterations = 1;
+
+    (reference ? reference_filter_blur : filter_blur)(&frame, &params);
+    return size;
+}
+
+static size_t run_transform(const verify_case_t* c, uint8_t* out, bool reference) {
+    size_t size = (size_t)c->width * c->height * 4;
+    memcpy(out, c->input[0], size);
+    video_frame_t frame = wrap_frame(out, c->width, c->height);
+
+    transform_params_t params;
+    params.scale = lerp(50.0f, 250.0f, c->params[0]);
+    params.rotation = c->params[1] < 0.25f ? 0.0f : lerp(-180.0f, 180.0f, c->params[2]);
+    params.flip_horizontal = c->params[3] < 0.3f;
+    params.flip_vertical = c->params[4] < 0.3f;
+    params.crop_x = c->params[5] < 0.5f ? 0 : (int)(c->params[5] * 20.0f);
+    params.crop_y = c->params[6] < 0.5f ? 0 : (int)(c->params[6] * 20.0f);
+    params.crop_width = 100 - params.crop_x;
+    params.crop_height = 100 - params.crop_y;
+    params.interpolation = c->params[7] < 0.5f ? TRANSFORM_INTERP_BILINEAR : TRANSFORM_INTERP_NEAREST;
+
+    (reference ? reference_filter_transform : filter_transform)(&frame, &params);
+    return size;
+}
+
+// Two-input transitions writing a separate output frame
+#define VERIFY_TRANSITION(name)                                                           \
+    static size_t run_##name(const verify_case_t* c, uint8_t* out, bool reference) {      \
+        video_frame_t from = wrap_frame(c->input[0], c->width, c->height);                \
+        video_frame_t to = wrap_frame(c->input[1], c->width, c->height);                  \
+        video_frame_t output = wrap_frame(out, c->width, c->height);                      \
+        float progress = lerp(-0.1f, 1.1f, c->params[0]);                                 \
+        (reference ? reference_transition_##name : transition_##name)(&from, &to, &output, progress); \
+        return (size_t)c->width * c->height * 4;                                          \
+    }
+
+VERIFY_TRANSITION(fade)
+VERIFY_TRANSITION(dissolve)
+VERIFY_TRANSITION(wipe_left)
+VERIFY_TRANSITION(wipe_right)
+VERIFY_TRANSITION(wipe_up)
+VERIFY_TRANSITION(wipe_down)
+
+static size_t yuv420_size(int width, int height) {
+    return (size_t)width * height + 2 * (size_t)((width + 1) / 2) * ((height + 1) / 2);
+}
+
+static size_t run_rgb_to_yuv420(const verify_case_t* c, uint8_t* out, bool reference) {
+    (reference ? reference_convert_rgb_to_yuv420 : convert_rgb_to_yuv420)(c->input[0], out, c->width, c->height);
+    return yuv420_size(c->width, c->height);
+}
+
+static size_t run_yuv420_to_rgb(const verify_case_t* c, uint8_t* out, bool reference) {
+    (reference ? reference_convert_yuv420_to_rgb : convert_yuv420_to_rgb)(c->input[0], out, c->width, c->height);
+    return (size_t)c->width * c->height * 3;
+}
+
+static size_t run_rgba_to_rgb(const verify_case_t* c, uint8_t* out, bool reference) {
+    (reference ? reference_convert_rgba_to_rgb : convert_rgba_to_rgb)(c->input[0], out, c->width, c->height);
+    return (size_t)c->width * c->height * 3;
+}
+
+static size_t run_rgb_to_rgba(const verify_case_t* c, uint8_t* out, bool reference) {
+    uint8_t alpha = (uint8_t)(c->params[0] * 256.0f);
+    (reference ? reference_convert_rgb_to_rgba : convert_rgb_to_rgba)(c->input[0], out, c->width, c->height, alpha);
+    return (size_t)c->width * c->height * 4;
+}
+
+// Resampling targets up to twice the source size in each dimension
+static void target_size(const verify_case_t* c, int* width, int* height) {
+    *width = 1 + (int)(c->params[0] * 2 * c->width);
+    *height = 1 + (int)(c->params[1] * 2 * c->height);
+}
+
+static size_t run_resize(const verify_case_t* c, uint8_t* out, bool reference) {
+    int width, height;
+    target_size(c, &width, &height);
+    video_frame_t src = wrap_frame(c->input[0], c->width, c->height);
+    video_frame_t dst = wrap_frame(out, width, height);
+    (reference ? reference_frame_resize : video_frame_resize)(&src, &dst, width, height);
+    return (size_t)width * height * 4;
+}
+
+static size_t run_upscale(const verify_case_t* c, uint8_t* out, bool reference) {
+    int width, height;
+    target_size(c, &width, &height);
+    video_frame_t src = wrap_frame(c->input[0], c->width, c->height);
+    video_frame_t dst = wrap_frame(out, width, height);
+    (reference ? reference_frame_upscale : video_frame_upscale)(&src, &dst, width, height);
+    return (size_t)width * height * 4;
+}
+
+static size_t run_downscale_area(const verify_case_t* c, uint8_t* out, bool reference) {
+    int factor = 1 + (int)(c->params[0] * 4.0f);
+    video_frame_t src = wrap_frame(c->input[0], c->width, c->height);
+    video_frame_t dst = wrap_frame(out, 0, 0);
+    (reference ? reference_frame_downscale_area : video_frame_downscale_area)(&src, &dst, factor);
+    return (size_t)((c->width + factor - 1) / factor) * ((c->height + factor - 1) / factor) * 4;
+}
+
+// Tolerances: exact for integer and selection kernels, one level of rounding
+// for float pipelines, color correction and transform included (both measured
+// exact over 20000 cases on 200 seeds; the slack is for other compilers'
+// float contraction).
+static const verify_kernel_t kernels[] = {
+    {"color_correction",   run_color_correction,     1, 0.01},
+    {"blur",               run_blur,                 1, 0.01},
+    {"sharpen",            run_sharpen,              1, 0.01},
+    {"edge_detection",     run_edge_detection_new,   1, 0.01},
+    {"noise_reduction",    run_noise_reduction,      1, 0.01},
+    {"transform",          run_transform,            1, 0.01},
+    {"sepia",              run_sepia,                1, 0.01},
+    {"black_and_white",    run_black_and_white,      1, 0.01},
+    {"vintage",            run_vintage,              1, 0.01},
+    {"vignette",           run_vignette,             1, 0.01},
+    {"fade",               run_fade,                 1, 0.01},
+    {"dissolve",           run_dissolve,             0, 0.0},
+    {"wipe_left",          run_wipe_left,            0, 0.0},
+    {"wipe_right",         run_wipe_right,           0, 0.0},
+    {"wipe_up",            run_wipe_up,              0, 0.0},
+    {"wipe_down",          run_wipe_down,            0, 0.0},
+    {"rgb_to_yuv420",      run_rgb_to_yuv420,        1, 0.01},
+    {"yuv420_to_rgb",      run_yuv420_to_rgb,        1, 0.01},
+    {"rgba_to_rgb",        run_rgba_to_rgb,          0, 0.0},
+    {"rgb_to_rgba",        run_rgb_to_rgba,          0, 0.0},
+    {"resize",             run_resize,               1, 0.01},
+    {"upscale",            run_upscale,              1, 0.01},
+    {"downscale_area",     run_downscale_area,       0, 0.0},
+};
+
+#define KERNEL_COUNT ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+// Case sizes cycle through the degenerate shapes before random ones
+static void random_size(uint32_t* state, int index, int* width, int* height) {
+    *width = 1 + (int)(next_random(state) % VERIFY_MAX_WIDTH);
+    *height = 1 + (int)(next_random(state) % VERIFY_MAX_HEIGHT);
+
+    switch (index % 8) {
+        case 0: *width = 1; *height = 1; break;
+        case 1: *width = 1; break;
+        case 2: *height = 1; break;
+        case 3: *width |= 1; break;  // Odd width
+        default: break;
+    }
+}
+
+static void random_content(uint32_t* state, uint8_t* data, size_t size, int width) {
+    uint32_t style = next_random(state) % 4;
+    uint8_t flat = (uint8_t)next_random(state);
+
+    for (size_t i = 0; i < size; i++) {
+        switch (style) {
+            case 0: data[i] = (uint8_t)next_random(state); break;                          // Noise
+            case 1: data[i] = (uint8_t)((i / 4 % width) * 255 / (width > 1 ? width - 1 : 1)); break; // Gradient
+            case 2: data[i] = flat; break;                                                 // Flat
+            default: data[i] = (next_random(state) & 1) ? 255 : 0; break;                 // Extremes
+        }
+    }
+}
+
+int kernel_verifier_count(void) {
+    return KERNEL_COUNT;
+}
+
+const char* kernel_verifier_name(int index) {
+    if (index < 0 || index >= KERNEL_COUNT) return NULL;
+    return kernels[index].name;
+}
+
+// Verify one kernel; false if it failed or could not be run (then result->cases is 0)
+bool kernel_verifier_run(int index, uint32_t seed, int cases, kernel_verify_result_t* result) {
+    if (!result) return false;
+    memset(result, 0, sizeof(kernel_verify_result_t));
+    if (index < 0 || index >= KERNEL_COUNT || cases <= 0) return false;
+
+    const verify_kernel_t* kernel = &kernels[index];
+    result->kernel = kernel->name;
+    result->max_tolerance = kernel->max_tolerance;
+    result->mean_tolerance = kernel->mean_tolerance;
+
+    size_t input_size = (size_t)VERIFY_MAX_WIDTH * VERIFY_MAX_HEIGHT * 4;
+    size_t output_size = input_size * 4 + VERIFY_GUARD_BYTES; // Resampling doubles both sides
+    uint8_t* buffer = malloc(2 * input_size + 2 * output_size);
+    if (!buffer) return false;
+
+    verify_case_t c;
+    c.input[0] = buffer;
+    c.input[1] = buffer + input_size;
+    uint8_t* production = buffer + 2 * input_size;
+    uint8_t* reference = production + output_size;
+
+    // Kernels differ in how they consume the stream, so seed per kernel
+    uint32_t state = seed * 2654435761u + (uint32_t)index * 40503u + 1u;
+    if (state == 0) state = 1;
+
+    double error_sum = 0.0;
+    double compared = 0.0;
+
+    for (int i = 0; i < cases; i++) {
+        random_size(&state, i, &c.width, &c.height);
+        size_t frame_size = (size_t)c.width * c.height * 4;
+        random_content(&state, c.input[0], frame_size, c.width);
+        random_content(&state, c.input[1], frame_size, c.width);
+        for (int p = 0; p < VERIFY_PARAMS; p++) {
+            c.params[p] = random_unit(&state);
+        }
+
+        memset(production, VERIFY_GUARD_VALUE, output_size);
+        memset(reference, VERIFY_GUARD_VALUE, output_size);
+        size_t size = kernel->run(&c, production, false);
+        kernel->run(&c, reference, true);
+
+        for (size_t b = size; b < size + VERIFY_GUARD_BYTES; b++) {
+            if (production[b] != VERIFY_GUARD_VALUE) {
+                result->overrun = true;
+                break;
+            }
+        }
+
+        for (size_t b = 0; b < size; b++) {
+            int diff = abs((int)production[b] - (int)reference[b]);
+            if (diff > result->max_abs_error) result->max_abs_error = diff;
+            error_sum += diff;
+        }
+        compared += (double)size;
+        result->cases++;
+    }
+
+    free(buffer);
+
+    result->mean_abs_error = compared > 0.0 ? error_sum / compared : 0.0;
+    result->passed = !result->overrun &&
+                     result->max_abs_error <= kernel->max_tolerance &&
+                     result->mean_abs_error <= kernel->mean_tolerance;
+    return result->passed;
+}
+
+// Verify every kernel and describe the outcome, one line per kernel
+char* kernel_verifier_report(uint32_t seed, int cases, bool* passed) {
+    if (passed) *passed = false;
+    if (cases <= 0) return NULL;
+
+    string_builder_t report;
+    if (!string_builder_init(&report, 4096)) return NULL;
+
+    bool all_passed = true;
+    string_builder_append(&report, "kernel verification (seed %u, %d cases per kernel)\n", seed, cases);
+
+    for (int i = 0; i < KERNEL_COUNT; i++) {
+        kernel_verify_result_t result;
+        bool ok = kernel_verifier_run(i, seed, cases, &result);
+        all_passed = all_passed && ok;
+        if (result.cases == 0) {
+            string_builder_append(&report, "%-18s ERROR  could not run\n", kernels[i].name);
+            break;
+        }
+
+        string_builder_append(&report, "%-18s %s  max %3d (tol %3d)  mean %.4f (tol %.4f)%s\n",
+                              kernels[i].name, ok ? "PASS" : "FAIL",
+                              result.max_abs_error, result.max_tolerance,
+                              result.mean_abs_error, result.mean_tolerance,
+                              result.overrun ? "  OVERRUN" : "");
+    }
+
+    string_builder_append(&report, "result: %s\n", all_passed ? "PASS" : "FAIL");
+    if (passed) *passed = all_passed;
+    return string_builder_finish(&report, NULL);
+}
+
+// ============================================================================
+// JavaScript Bindings
+// ============================================================================
+
+// Verify all kernels; returns the report as a C string (free it with js_free), NULL if cases <= 0
+EMSCRIPTEN_KEEPALIVE
+char* js_kernel_verify(int seed, int cases) {
+    return kernel_verifier_report((uint32_t)seed, cases, NULL);
+}
@@ -0,0 +1,1285 @@
+#include "../include/reference_kernels.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Frozen scalar copies of the engine's kernels, kept as the ground truth for
+// kernel_verifier. They are deliberately plain: no scheduler checkpoints,
+// logging, counters or tracing, and they must not be optimized. When a
+// production kernel's intended output changes, change its reference in the
+// same commit.
+
+// YUV to RGB conversion coefficients (ITU-R BT.709)
+static const float YUV_TO_RGB_MATRIX[9] = {
+    1.0f,  0.0f,      1.5748f,     // Y, U, V -> R
+    1.0f, -0.1873f,  -0.4681f,     // Y, U, V -> G
+    1.0f,  1.8556f,   0.0f         // Y, U, V -> B
+};
+
+// RGB to YUV conversion coefficients (ITU-R BT.709)
+static const float RGB_TO_YUV_MATRIX[9] = {
+    0.2126f,  0.7152f,  0.0722f,   // R, G, B -> Y
+   -0.1146f, -0.3854f,  0.5f,      // R, G, B -> U
+    0.5f,    -0.4542f, -0.0458f    // R, G, B -> V
+};
+
+static inline uint8_t clamp_uint8(float value) {
+    if (value < 0.0f) return 0;
+    if (value > 255.0f) return 255;
+    return (uint8_t)value;
+}
+
+// ============================================================================
+// Filters
+// ============================================================================
+
+static void rgb_to_hsv(uint8_t r, uint8_t g, uint8_t b, float* h, float* s, float* v) {
+    float rf = r / 255.0f;
+    float gf = g / 255.0f;
+    float bf = b / 255.0f;
+
+    float max_val = fmaxf(rf, fmaxf(gf, bf));
+    float min_val = fminf(rf, fminf(gf, bf));
+    float delta = max_val - min_val;
+
+    *v = max_val;
+
+    if (max_val == 0.0f) {
+        *s = 0.0f;
+    } else {
+        *s = delta / max_val;
+    }
+
+    if (delta == 0.0f) {
+        *h = 0.0f;
+    } else if (max_val == rf) {
+        *h = 60.0f * ((gf - bf) / delta);
+        if (*h < 0.0f) *h += 360.0f;
+    } else if (max_val == gf) {
+        *h = 60.0f * ((bf - rf) / delta) + 120.0f;
+    } else {
+        *h = 60.0f * ((rf - gf) / delta) + 240.0f;
+    }
+}
+
+static void hsv_to_rgb(float h, float s, float v, uint8_t* r, uint8_t* g, uint8_t* b) {
+    if (s == 0.0f) {
+        *r = *g = *b = clamp_uint8(v * 255.0f);
+        return;
+    }
+
+    h = fmodf(h, 360.0f);
+    if (h < 0.0f) h += 360.0f;
+
+    int hi = (int)(h / 60.0f);
+    float f = (h / 60.0f) - hi;
+    float p = v * (1.0f - s);
+    float q = v * (1.0f - s * f);
+    float t = v * (1.0f - s * (1.0f - f));
+
+    switch (hi) {
+        case 0: *r = clamp_uint8(v * 255.0f); *g = clamp_uint8(t * 255.0f); *b = clamp_uint8(p * 255.0f); break;
+        case 1: *r = clamp_uint8(q * 255.0f); *g = clamp_uint8(v * 255.0f); *b = clamp_uint8(p * 255.0f); break;
+        case 2: *r = clamp_uint8(p * 255.0f); *g = clamp_uint8(v * 255.0f); *b = clamp_uint8(t * 255.0f); break;
+        case 3: *r = clamp_uint8(p * 255.0f); *g = clamp_uint8(q * 255.0f); *b = clamp_uint8(v * 255.0f); break;
+        case 4: *r = clamp_uint8(t * 255.0f); *g = clamp_uint8(p * 255.0f); *b = clamp_uint8(v * 255.0f); break;
+        default: *r = clamp_uint8(v * 255.0f); *g = clamp_uint8(p * 255.0f); *b = clamp_uint8(q * 255.0f); break;
+    }
+}
+
+void reference_filter_color_correction(video_frame_t* frame, color_correction_t* params) {
+    if (!frame || !frame->data || !params || frame->format != 1) return; // RGBA only
+
+    int width = frame->width;
+    int height = frame->height;
+    uint8_t* data = frame->data;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4;
+            uint8_t r = data[idx + 0];
+            uint8_t g = data[idx + 1];
+            uint8_t b = data[idx + 2];
+            uint8_t a = data[idx + 3];
+
+            // Convert to float for processing
+            float rf = r / 255.0f;
+            float gf = g / 255.0f;
+            float bf = b / 255.0f;
+
+            // Apply brightness
+            rf += params->brightness;
+            gf += params->brightness;
+            bf += params->brightness;
+
+            // Apply contrast
+            rf = (rf - 0.5f) * (1.0f + params->contrast) + 0.5f;
+            gf = (gf - 0.5f) * (1.0f + params->contrast) + 0.5f;
+            bf = (bf - 0.5f) * (1.0f + params->contrast) + 0.5f;
+
+            // Apply gamma correction
+            if (params->gamma != 1.0f) {
+                rf = powf(fmaxf(rf, 0.0f), 1.0f / params->gamma);
+                gf = powf(fmaxf(gf, 0.0f), 1.0f / params->gamma);
+                bf = powf(fmaxf(bf, 0.0f), 1.0f / params->gamma);
+            }
+
+            // Apply exposure
+            float exposure_multiplier = powf(2.0f, params->exposure);
+            rf *= exposure_multiplier;
+            gf *= exposure_multiplier;
+            bf *= exposure_multiplier;
+
+            // Apply saturation and hue adjustments using HSV
+            if (params->saturation != 0.0f || params->hue != 0.0f) {
+                float h, s, v;
+                rgb_to_hsv(clamp_uint8(rf * 255.0f), clamp_uint8(gf * 255.0f), clamp_uint8(bf * 255.0f), &h, &s, &v);
+
+                // Adjust hue
+                h += params->hue;
+
+                // Adjust saturation
+                s *= (1.0f + params->saturation);
+                s = fmaxf(0.0f, fminf(1.0f, s));
+
+                hsv_to_rgb(h, s, v, &r, &g, &b);
+            } else {
+                r = clamp_uint8(rf * 255.0f);
+                g = clamp_uint8(gf * 255.0f);
+                b = clamp_uint8(bf * 255.0f);
+            }
+
+            // Write back to buffer
+            data[idx + 0] = r;
+            data[idx + 1] = g;
+            data[idx + 2] = b;
+            data[idx + 3] = a; // Preserve alpha
+        }
+    }
+}
+
+void reference_filter_blur(video_frame_t* frame, blur_params_t* params) {
+    if (!frame || !frame->data || !params || frame->format != 1) return; // RGBA only
+
+    int width = frame->width;
+    int height = frame->height;
+    int radius = (int)params->radius;
+
+    if (radius <= 0) return;
+
+    // Allocate temporary buffer
+    uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
+    if (!temp_data) return;
+
+    memcpy(temp_data, frame->data, width * height * 4);
+
+    // Horizontal blur pass
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            int count = 0;
+
+            for (int dx = -radius; dx <= radius; dx++) {
+                int nx = x + dx;
+                if (nx >= 0 && nx < width) {
+                    int idx = (y * width + nx) * 4;
+                    sum_r += temp_data[idx + 0];
+                    sum_g += temp_data[idx + 1];
+                    sum_b += temp_data[idx + 2];
+                    sum_a += temp_data[idx + 3];
+                    count++;
+                }
+            }
+
+            int idx = (y * width + x) * 4;
+            frame->data[idx + 0] = sum_r / count;
+            frame->data[idx + 1] = sum_g / count;
+            frame->data[idx + 2] = sum_b / count;
+            frame->data[idx + 3] = sum_a / count;
+        }
+    }
+
+    // Vertical blur pass
+    memcpy(temp_data, frame->data, width * height * 4);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            int count = 0;
+
+            for (int dy = -radius; dy <= radius; dy++) {
+                int ny = y + dy;
+                if (ny >= 0 && ny < height) {
+                    int idx = (ny * width + x) * 4;
+                    sum_r += temp_data[idx + 0];
+                    sum_g += temp_data[idx + 1];
+                    sum_b += temp_data[idx + 2];
+                    sum_a += temp_data[idx + 3];
+                    count++;
+                }
+            }
+
+            int idx = (y * width + x) * 4;
+            frame->data[idx + 0] = sum_r / count;
+            frame->data[idx + 1] = sum_g / count;
+            frame->data[idx + 2] = sum_b / count;
+            frame->data[idx + 3] = sum_a / count;
+        }
+    }
+
+    free(temp_data);
+}
+
+void reference_filter_sharpen(video_frame_t* frame, float intensity) {
+    if (!frame || !frame->data || frame->format != 1) return; // RGBA only
+
+    int width = frame->width;
+    int height = frame->height;
+
+    // Allocate temporary buffer
+    uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
+    if (!temp_data) return;
+
+    memcpy(temp_data, frame->data, width * height * 4);
+
+    // Apply sharpening kernel
+    float kernel[9] = {
+        0, -intensity, 0,
+        -intensity, 1 + 4 * intensity, -intensity,
+        0, -intensity, 0
+    };
+
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1; x < width - 1; x++) {
+            float sum_r = 0, sum_g = 0, sum_b = 0;
+
+            for (int ky = -1; ky <= 1; ky++) {
+                for (int kx = -1; kx <= 1; kx++) {
+                    int idx = ((y + ky) * width + (x + kx)) * 4;
+                    float weight = kernel[(ky + 1) * 3 + (kx + 1)];
+
+                    sum_r += temp_data[idx + 0] * weight;
+                    sum_g += temp_data[idx + 1] * weight;
+                    sum_b += temp_data[idx + 2] * weight;
+                }
+            }
+
+            int idx = (y * width + x) * 4;
+            frame->data[idx + 0] = (uint8_t)fmaxf(0.0f, fminf(255.0f, sum_r));
+            frame->data[idx + 1] = (uint8_t)fmaxf(0.0f, fminf(255.0f, sum_g));
+            frame->data[idx + 2] = (uint8_t)fmaxf(0.0f, fminf(255.0f, sum_b));
+        }
+    }
+
+    free(temp_data);
+}
+
+void reference_filter_edge_detection_new(video_frame_t* frame, float intensity) {
+    if (!frame || !frame->data || intensity < 0.0f) return;
+
+    // Clamp intensity to valid range
+    if (intensity > 1.0f) intensity = 1.0f;
+
+    uint8_t* data = frame->data;
+    int width = frame->width;
+    int height = frame->height;
+
+    // Create temporary buffer for processed image
+    uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
+    if (!temp_data) return;
+
+    // Copy original data to temp buffer
+    for (int i = 0; i < width * height * 4; i++) {
+        temp_data[i] = data[i];
+    }
+
+    // Sobel edge detection kernels
+    int sobel_x[3][3] = {
+        {-1, 0, 1},
+        {-2, 0, 2},
+        {-1, 0, 1}
+    };
+
+    int sobel_y[3][3] = {
+        {-1, -2, -1},
+        { 0,  0,  0},
+        { 1,  2,  1}
+    };
+
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1; x < width - 1; x++) {
+            int pixel_offset = (y * width + x) * 4;
+
+            float gx_r = 0, gx_g = 0, gx_b = 0;
+            float gy_r = 0, gy_g = 0, gy_b = 0;
+
+            // Apply Sobel kernels
+            for (int ky = -1; ky <= 1; ky++) {
+                for (int kx = -1; kx <= 1; kx++) {
+                    int sample_x = x + kx;
+                    int sample_y = y + ky;
+                    int sample_offset = (sample_y * width + sample_x) * 4;
+
+                    float r = temp_data[sample_offset] / 255.0f;
+                    float g = temp_data[sample_offset + 1] / 255.0f;
+                    float b = temp_data[sample_offset + 2] / 255.0f;
+
+                    int kernel_x = sobel_x[ky + 1][kx + 1];
+                    int kernel_y = sobel_y[ky + 1][kx + 1];
+
+                    gx_r += r * kernel_x;
+                    gx_g += g * kernel_x;
+                    gx_b += b * kernel_x;
+
+                    gy_r += r * kernel_y;
+                    gy_g += g * kernel_y;
+                    gy_b += b * kernel_y;
+                }
+            }
+
+            // Calculate gradient magnitude
+            float magnitude_r = sqrtf(gx_r * gx_r + gy_r * gy_r);
+            float magnitude_g = sqrtf(gx_g * gx_g + gy_g * gy_g);
+            float magnitude_b = sqrtf(gx_b * gx_b + gy_b * gy_b);
+
+            // Use average magnitude for edge strength
+            float edge_strength = (magnitude_r + magnitude_g + magnitude_b) / 3.0f;
+
+            // Clamp edge strength
+            edge_strength = fmaxf(0.0f, fminf(1.0f, edge_strength * 3.0f)); // Amplify edges
+
+            // Get original pixel values
+            float orig_r = temp_data[pixel_offset] / 255.0f;
+            float orig_g = temp_data[pixel_offset + 1] / 255.0f;
+            float orig_b = temp_data[pixel_offset + 2] / 255.0f;
+
+            // Mix edge detection with original image based on intensity
+            float final_r = orig_r + (edge_strength - orig_r) * intensity;
+            float final_g = orig_g + (edge_strength - orig_g) * intensity;
+            float final_b = orig_b + (edge_strength - orig_b) * intensity;
+
+            // Clamp final values
+            final_r = fmaxf(0.0f, fminf(1.0f, final_r));
+            final_g = fmaxf(0.0f, fminf(1.0f, final_g));
+            final_b = fmaxf(0.0f, fminf(1.0f, final_b));
+
+            data[pixel_offset] = (uint8_t)(final_r * 255.0f);
+            data[pixel_offset + 1] = (uint8_t)(final_g * 255.0f);
+            data[pixel_offset + 2] = (uint8_t)(final_b * 255.0f);
+            // Alpha channel remains unchanged
+        }
+    }
+
+    free(temp_data);
+}
+
+void reference_filter_noise_reduction(video_frame_t* frame, float strength) {
+    if (!frame || !frame->data || strength <= 0.0f) return;
+
+    int width = frame->width;
+    int height = frame->height;
+    uint8_t* data = frame->data;
+    int channels = (frame->format == 1) ? 4 : 3; // RGBA or RGB
+
+    // Simple averaging filter for noise reduction
+    // Apply a 3x3 weighted average with the center pixel having more weight
+    float center_weight = 1.0f - (strength * 0.3f);
+    float neighbor_weight = strength * 0.05f;
+
+    // Create temporary buffer
+    uint8_t* temp_data = malloc(width * height * channels);
+    if (!temp_data) return;
+
+    memcpy(temp_data, data, width * height * channels);
+
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1; x < width - 1; x++) {
+            for (int c = 0; c < channels; c++) {
+                int idx = (y * width + x) * channels + c;
+
+                // Skip alpha channel if RGBA
+                if (channels == 4 && c == 3) {
+                    continue;
+                }
+
+                float sum = 0.0f;
+                sum += temp_data[idx] * center_weight; // center pixel
+
+                // 8 neighbors
+                sum += temp_data[((y-1) * width + (x-1)) * channels + c] * neighbor_weight;
+                sum += temp_data[((y-1) * width + x) * channels + c] * neighbor_weight;
+                sum += temp_data[((y-1) * width + (x+1)) * channels + c] * neighbor_weight;
+                sum += temp_data[(y * width + (x-1)) * channels + c] * neighbor_weight;
+                sum += temp_data[(y * width + (x+1)) * channels + c] * neighbor_weight;
+                sum += temp_data[((y+1) * width + (x-1)) * channels + c] * neighbor_weight;
+                sum += temp_data[((y+1) * width + x) * channels + c] * neighbor_weight;
+                sum += temp_data[((y+1) * width + (x+1)) * channels + c] * neighbor_weight;
+
+                data[idx] = (uint8_t)(sum + 0.5f);
+            }
+        }
+    }
+
+    free(temp_data);
+}
+
+static inline uint32_t sample_pixel(uint8_t* data, int width, int height, float x, float y) {
+    // Clamp coordinates to image bounds
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x >= width - 1) x = width - 1;
+    if (y >= height - 1) y = height - 1;
+
+    int x1 = (int)x;
+    int y1 = (int)y;
+    int x2 = x1 + 1;
+    int y2 = y1 + 1;
+
+    if (x2 >= width) x2 = width - 1;
+    if (y2 >= height) y2 = height - 1;
+
+    float fx = x - x1;
+    float fy = y - y1;
+
+    // Get four neighboring pixels
+    uint32_t* pixels = (uint32_t*)data;
+    uint32_t p11 = pixels[y1 * width + x1];
+    uint32_t p12 = pixels[y1 * width + x2];
+    uint32_t p21 = pixels[y2 * width + x1];
+    uint32_t p22 = pixels[y2 * width + x2];
+
+    // Extract RGBA components
+    uint8_t r11 = p11 & 0xFF;
+    uint8_t g11 = (p11 >> 8) & 0xFF;
+    uint8_t b11 = (p11 >> 16) & 0xFF;
+    uint8_t a11 = (p11 >> 24) & 0xFF;
+
+    uint8_t r12 = p12 & 0xFF;
+    uint8_t g12 = (p12 >> 8) & 0xFF;
+    uint8_t b12 = (p12 >> 16) & 0xFF;
+    uint8_t a12 = (p12 >> 24) & 0xFF;
+
+    uint8_t r21 = p21 & 0xFF;
+    uint8_t g21 = (p21 >> 8) & 0xFF;
+    uint8_t b21 = (p21 >> 16) & 0xFF;
+    uint8_t a21 = (p21 >> 24) & 0xFF;
+
+    uint8_t r22 = p22 & 0xFF;
+    uint8_t g22 = (p22 >> 8) & 0xFF;
+    uint8_t b22 = (p22 >> 16) & 0xFF;
+    uint8_t a22 = (p22 >> 24) & 0xFF;
+
+    // Bilinear interpolation
+    float r = r11 * (1 - fx) * (1 - fy) + r12 * fx * (1 - fy) + r21 * (1 - fx) * fy + r22 * fx * fy;
+    float g = g11 * (1 - fx) * (1 - fy) + g12 * fx * (1 - fy) + g21 * (1 - fx) * fy + g22 * fx * fy;
+    float b = b11 * (1 - fx) * (1 - fy) + b12 * fx * (1 - fy) + b21 * (1 - fx) * fy + b22 * fx * fy;
+    float a = a11 * (1 - fx) * (1 - fy) + a12 * fx * (1 - fy) + a21 * (1 - fx) * fy + a22 * fx * fy;
+
+    return ((uint32_t)(a + 0.5f) << 24) | ((uint32_t)(b + 0.5f) << 16) | ((uint32_t)(g + 0.5f) << 8) | (uint32_t)(r + 0.5f);
+}
+
+void reference_filter_transform(video_frame_t* frame, transform_params_t* params) {
+    if (!frame || !frame->data || !params) return;
+
+    int width = frame->width;
+    int height = frame->height;
+
+    // Allocate temporary buffer for transformation
+    uint8_t* temp_data = (uint8_t*)malloc(width * height * 4);
+    if (!temp_data) return;
+
+    memcpy(temp_data, frame->data, width * height * 4);
+
+    // Clear the output buffer
+    memset(frame->data, 0, width * height * 4);
+
+    // Convert parameters
+    float scale_factor = params->scale / 100.0f;
+    float rotation_rad = params->rotation * M_PI / 180.0f;
+
+    // Calculate crop boundaries
+    int crop_left = (params->crop_x * width) / 100;
+    int crop_top = (params->crop_y * height) / 100;
+    int crop_right = crop_left + (params->crop_width * width) / 100;
+    int crop_bottom = crop_top + (params->crop_height * height) / 100;
+
+    // Clamp crop boundaries
+    if (crop_left < 0) crop_left = 0;
+    if (crop_top < 0) crop_top = 0;
+    if (crop_right > width) crop_right = width;
+    if (crop_bottom > height) crop_bottom = height;
+
+    // Pre-calculate rotation matrix
+    float cos_theta = cosf(rotation_rad);
+    float sin_theta = sinf(rotation_rad);
+
+    // Center coordinates
+    float center_x = width * 0.5f;
+    float center_y = height * 0.5f;
+
+    uint32_t* output_pixels = (uint32_t*)frame->data;
+    uint32_t* input_pixels = (uint32_t*)temp_data;
+    bool nearest = params->interpolation == TRANSFORM_INTERP_NEAREST;
+
+    // Apply transformation for each pixel
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            // Apply cropping
+            if (x < crop_left || x >= crop_right || y < crop_top || y >= crop_bottom) {
+                // Outside crop area - set to transparent/black
+                output_pixels[y * width + x] = 0x00000000;
+                continue;
+            }
+
+            // Transform coordinates relative to center
+            float tx = (x - center_x) / scale_factor;
+            float ty = (y - center_y) / scale_factor;
+
+            // Apply rotation
+            float rx = tx * cos_theta - ty * sin_theta;
+            float ry = tx * sin_theta + ty * cos_theta;
+
+            // Translate back and apply flipping
+            float source_x = rx + center_x;
+            float source_y = ry + center_y;
+
+            if (params->flip_horizontal) {
+                source_x = width - 1 - source_x;
+            }
+
+            if (params->flip_vertical) {
+                source_y = height - 1 - source_y;
+            }
+
+            // Sample from source image
+            if (source_x >= 0 && source_x < width && source_y >= 0 && source_y < height) {
+                if (nearest) {
+                    output_pixels[y * width + x] = input_pixels[(int)source_y * width + (int)source_x];
+                } else {
+                    output_pixels[y * width + x] = sample_pixel(temp_data, width, height, source_x, source_y);
+                }
+            } else {
+                // Outside source bounds - set to transparent/black
+                output_pixels[y * width + x] = 0x00000000;
+            }
+        }
+    }
+
+    free(temp_data);
+}
+
+void reference_filter_sepia(video_frame_t* frame, float intensity) {
+    if (!frame || !frame->data || intensity < 0.0f) return;
+
+    int width = frame->width;
+    int height = frame->height;
+    uint8_t* data = frame->data;
+
+    // Process each pixel
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int index = (y * width + x) * 4; // RGBA format
+
+            // Get original RGB values
+            uint8_t r = data[index];
+            uint8_t g = data[index + 1];
+            uint8_t b = data[index + 2];
+            // Alpha stays the same
+
+            // Convert to float for calculations
+            float rf = r / 255.0f;
+            float gf = g / 255.0f;
+            float bf = b / 255.0f;
+
+            // Classic sepia tone formula
+            float sepia_r = (rf * 0.393f) + (gf * 0.769f) + (bf * 0.189f);
+            float sepia_g = (rf * 0.349f) + (gf * 0.686f) + (bf * 0.168f);
+            float sepia_b = (rf * 0.272f) + (gf * 0.534f) + (bf * 0.131f);
+
+            // Clamp to valid range
+            if (sepia_r > 1.0f) sepia_r = 1.0f;
+            if (sepia_g > 1.0f) sepia_g = 1.0f;
+            if (sepia_b > 1.0f) sepia_b = 1.0f;
+
+            // Mix with original based on intensity (0.0 = original, 1.0 = full sepia)
+            float final_r = rf + (sepia_r - rf) * intensity;
+            float final_g = gf + (sepia_g - gf) * intensity;
+            float final_b = bf + (sepia_b - bf) * intensity;
+
+            // Convert back to uint8_t
+            data[index] = (uint8_t)(final_r * 255.0f + 0.5f);
+            data[index + 1] = (uint8_t)(final_g * 255.0f + 0.5f);
+            data[index + 2] = (uint8_t)(final_b * 255.0f + 0.5f);
+            // data[index + 3] (alpha) remains unchanged
+        }
+    }
+}
+
+void reference_filter_black_and_white(video_frame_t* frame, float intensity) {
+    if (!frame || !frame->data || intensity < 0.0f) return;
+
+    // Clamp intensity to valid range
+    if (intensity > 1.0f) intensity = 1.0f;
+
+    uint8_t* data = frame->data;
+    int width = frame->width;
+    int height = frame->height;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int pixel_offset = (y * width + x) * 4; // RGBA format
+
+            uint8_t r = data[pixel_offset];
+            uint8_t g = data[pixel_offset + 1];
+            uint8_t b = data[pixel_offset + 2];
+            uint8_t a = data[pixel_offset + 3]; // Preserve alpha
+
+            // Convert to float for calculations
+            float rf = r / 255.0f;
+            float gf = g / 255.0f;
+            float bf = b / 255.0f;
+
+            // Use luminance formula (ITU-R BT.709 standard for HDTV)
+            // This is the standard used in video processing
+            float luminance = 0.2126f * rf + 0.7152f * gf + 0.0722f * bf;
+
+            // Mix with original based on intensity
+            float final_r = rf + (luminance - rf) * intensity;
+            float final_g = gf + (luminance - gf) * intensity;
+            float final_b = bf + (luminance - bf) * intensity;
+
+            // Clamp values to [0,1] and convert back to uint8_t
+            final_r = fmaxf(0.0f, fminf(1.0f, final_r));
+            final_g = fmaxf(0.0f, fminf(1.0f, final_g));
+            final_b = fmaxf(0.0f, fminf(1.0f, final_b));
+
+            data[pixel_offset] = (uint8_t)(final_r * 255.0f);
+            data[pixel_offset + 1] = (uint8_t)(final_g * 255.0f);
+            data[pixel_offset + 2] = (uint8_t)(final_b * 255.0f);
+            data[pixel_offset + 3] = a; // Keep original alpha
+        }
+    }
+}
+
+void reference_filter_vintage(video_frame_t* frame, float intensity) {
+    if (!frame || !frame->data || intensity < 0.0f) return;
+
+    // Clamp intensity to valid range
+    if (intensity > 1.0f) intensity = 1.0f;
+
+    uint8_t* data = frame->data;
+    int width = frame->width;
+    int height = frame->height;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int pixel_offset = (y * width + x) * 4; // RGBA format
+
+            uint8_t r = data[pixel_offset];
+            uint8_t g = data[pixel_offset + 1];
+            uint8_t b = data[pixel_offset + 2];
+            uint8_t a = data[pixel_offset + 3]; // Preserve alpha
+
+            // Convert to float for calculations
+            float rf = r / 255.0f;
+            float gf = g / 255.0f;
+            float bf = b / 255.0f;
+
+            // Vintage effect combines several techniques:
+            // 1. Slight sepia tone
+            // 2. Reduced saturation
+            // 3. Soft contrast adjustment
+            // 4. Warm color temperature shift
+
+            // Apply sepia-like transformation but less intense
+            float vintage_r = rf * 0.9f + gf * 0.5f + bf * 0.3f;
+            float vintage_g = rf * 0.3f + gf * 0.8f + bf * 0.3f;
+            float vintage_b = rf * 0.2f + gf * 0.3f + bf * 0.7f;
+
+            // Reduce contrast slightly for soft look
+            vintage_r = 0.3f + vintage_r * 0.7f;
+            vintage_g = 0.3f + vintage_g * 0.7f;
+            vintage_b = 0.3f + vintage_b * 0.7f;
+
+            // Clamp to valid range
+            vintage_r = fmaxf(0.0f, fminf(1.0f, vintage_r));
+            vintage_g = fmaxf(0.0f, fminf(1.0f, vintage_g));
+            vintage_b = fmaxf(0.0f, fminf(1.0f, vintage_b));
+
+            // Mix with original based on intensity
+            float final_r = rf + (vintage_r - rf) * intensity;
+            float final_g = gf + (vintage_g - gf) * intensity;
+            float final_b = bf + (vintage_b - bf) * intensity;
+
+            // Clamp final values
+            final_r = fmaxf(0.0f, fminf(1.0f, final_r));
+            final_g = fmaxf(0.0f, fminf(1.0f, final_g));
+            final_b = fmaxf(0.0f, fminf(1.0f, final_b));
+
+            data[pixel_offset] = (uint8_t)(final_r * 255.0f);
+            data[pixel_offset + 1] = (uint8_t)(final_g * 255.0f);
+            data[pixel_offset + 2] = (uint8_t)(final_b * 255.0f);
+            data[pixel_offset + 3] = a; // Keep original alpha
+        }
+    }
+}
+
+void reference_filter_vignette(video_frame_t* frame, float intensity) {
+    if (!frame || !frame->data || intensity < 0.0f) return;
+
+    // Clamp intensity to valid range
+    if (intensity > 1.0f) intensity = 1.0f;
+
+    uint8_t* data = frame->data;
+    int width = frame->width;
+    int height = frame->height;
+
+    // Calculate center and maximum distance for vignette
+    float center_x = width * 0.5f;
+    float center_y = height * 0.5f;
+    float max_distance = sqrtf(center_x * center_x + center_y * center_y);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int pixel_offset = (y * width + x) * 4; // RGBA format
+
+            uint8_t r = data[pixel_offset];
+            uint8_t g = data[pixel_offset + 1];
+            uint8_t b = data[pixel_offset + 2];
+            uint8_t a = data[pixel_offset + 3]; // Preserve alpha
+
+            // Calculate distance from center
+            float dx = x - center_x;
+            float dy = y - center_y;
+            float distance = sqrtf(dx * dx + dy * dy);
+
+            // Calculate vignette factor (0 = black, 1 = no effect)
+            float distance_ratio = distance / max_distance;
+
+            // Create smooth falloff - adjust the power for different vignette curves
+            float vignette_factor = 1.0f - powf(distance_ratio, 1.5f);
+
+            // Ensure vignette factor is in valid range
+            vignette_factor = fmaxf(0.0f, fminf(1.0f, vignette_factor));
+
+            // Apply vignette effect with intensity control
+            float final_vignette = 1.0f - (1.0f - vignette_factor) * intensity;
+
+            // Convert to float and apply vignette
+            float rf = (r / 255.0f) * final_vignette;
+            float gf = (g / 255.0f) * final_vignette;
+            float bf = (b / 255.0f) * final_vignette;
+
+            // Clamp and convert back
+            rf = fmaxf(0.0f, fminf(1.0f, rf));
+            gf = fmaxf(0.0f, fminf(1.0f, gf));
+            bf = fmaxf(0.0f, fminf(1.0f, bf));
+
+            data[pixel_offset] = (uint8_t)(rf * 255.0f);
+            data[pixel_offset + 1] = (uint8_t)(gf * 255.0f);
+            data[pixel_offset + 2] = (uint8_t)(bf * 255.0f);
+            data[pixel_offset + 3] = a; // Keep original alpha
+        }
+    }
+}
+
+// ============================================================================
+// Transitions
+// ============================================================================
+
+void reference_transition_fade(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
+    if (!frame1 || !frame2 || !output) return;
+
+    int width = output->width;
+    int height = output->height;
+
+    // Ensure progress is between 0 and 1
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4; // RGBA format
+
+            // Get pixel values from both frames
+            uint8_t r1 = frame1->data[idx];
+            uint8_t g1 = frame1->data[idx + 1];
+            uint8_t b1 = frame1->data[idx + 2];
+            uint8_t a1 = frame1->data[idx + 3];
+
+            uint8_t r2 = frame2->data[idx];
+            uint8_t g2 = frame2->data[idx + 1];
+            uint8_t b2 = frame2->data[idx + 2];
+            uint8_t a2 = frame2->data[idx + 3];
+
+            // Linear interpolation between frames
+            float alpha1 = 1.0f - progress;
+            float alpha2 = progress;
+
+            output->data[idx] = (uint8_t)(r1 * alpha1 + r2 * alpha2);
+            output->data[idx + 1] = (uint8_t)(g1 * alpha1 + g2 * alpha2);
+            output->data[idx + 2] = (uint8_t)(b1 * alpha1 + b2 * alpha2);
+            output->data[idx + 3] = (uint8_t)(a1 * alpha1 + a2 * alpha2);
+        }
+    }
+}
+
+void reference_transition_dissolve(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
+    if (!frame1 || !frame2 || !output) return;
+
+    int width = output->width;
+    int height = output->height;
+
+    // Ensure progress is between 0 and 1
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+
+    // Use a simple pseudo-random pattern for dissolve effect
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4; // RGBA format
+
+            // Create pseudo-random threshold based on pixel position
+            float threshold = (float)((x * 31 + y * 17) % 100) / 100.0f;
+
+            // Choose which frame to use based on progress and threshold
+            if (progress > threshold) {
+                // Use frame2
+                output->data[idx] = frame2->data[idx];
+                output->data[idx + 1] = frame2->data[idx + 1];
+                output->data[idx + 2] = frame2->data[idx + 2];
+                output->data[idx + 3] = frame2->data[idx + 3];
+            } else {
+                // Use frame1
+                output->data[idx] = frame1->data[idx];
+                output->data[idx + 1] = frame1->data[idx + 1];
+                output->data[idx + 2] = frame1->data[idx + 2];
+                output->data[idx + 3] = frame1->data[idx + 3];
+            }
+        }
+    }
+}
+
+void reference_transition_wipe_left(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
+    if (!frame1 || !frame2 || !output) return;
+
+    int width = output->width;
+    int height = output->height;
+
+    // Ensure progress is between 0 and 1
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+
+    // Calculate the wipe boundary
+    int wipe_x = (int)(progress * width);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4; // RGBA format
+
+            if (x < wipe_x) {
+                // Show frame2 (new frame)
+                output->data[idx] = frame2->data[idx];
+                output->data[idx + 1] = frame2->data[idx + 1];
+                output->data[idx + 2] = frame2->data[idx + 2];
+                output->data[idx + 3] = frame2->data[idx + 3];
+            } else {
+                // Show frame1 (old frame)
+                output->data[idx] = frame1->data[idx];
+                output->data[idx + 1] = frame1->data[idx + 1];
+                output->data[idx + 2] = frame1->data[idx + 2];
+                output->data[idx + 3] = frame1->data[idx + 3];
+            }
+        }
+    }
+}
+
+void reference_transition_wipe_right(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
+    if (!frame1 || !frame2 || !output) return;
+
+    int width = output->width;
+    int height = output->height;
+
+    // Ensure progress is between 0 and 1
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+
+    // Calculate the wipe boundary (from right)
+    int wipe_x = width - (int)(progress * width);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4; // RGBA format
+
+            if (x >= wipe_x) {
+                // Show frame2 (new frame)
+                output->data[idx] = frame2->data[idx];
+                output->data[idx + 1] = frame2->data[idx + 1];
+                output->data[idx + 2] = frame2->data[idx + 2];
+                output->data[idx + 3] = frame2->data[idx + 3];
+            } else {
+                // Show frame1 (old frame)
+                output->data[idx] = frame1->data[idx];
+                output->data[idx + 1] = frame1->data[idx + 1];
+                output->data[idx + 2] = frame1->data[idx + 2];
+                output->data[idx + 3] = frame1->data[idx + 3];
+            }
+        }
+    }
+}
+
+void reference_transition_wipe_up(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
+    if (!frame1 || !frame2 || !output) return;
+
+    int width = output->width;
+    int height = output->height;
+
+    // Ensure progress is between 0 and 1
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+
+    // Calculate the wipe boundary (from bottom up)
+    int wipe_y = height - (int)(progress * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4; // RGBA format
+
+            if (y >= wipe_y) {
+                // Show frame2 (new frame)
+                output->data[idx] = frame2->data[idx];
+                output->data[idx + 1] = frame2->data[idx + 1];
+                output->data[idx + 2] = frame2->data[idx + 2];
+                output->data[idx + 3] = frame2->data[idx + 3];
+            } else {
+                // Show frame1 (old frame)
+                output->data[idx] = frame1->data[idx];
+                output->data[idx + 1] = frame1->data[idx + 1];
+                output->data[idx + 2] = frame1->data[idx + 2];
+                output->data[idx + 3] = frame1->data[idx + 3];
+            }
+        }
+    }
+}
+
+void reference_transition_wipe_down(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
+    if (!frame1 || !frame2 || !output) return;
+
+    int width = output->width;
+    int height = output->height;
+
+    // Ensure progress is between 0 and 1
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+
+    // Calculate the wipe boundary (from top down)
+    int wipe_y = (int)(progress * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 4; // RGBA format
+
+            if (y < wipe_y) {
+                // Show frame2 (new frame)
+                output->data[idx] = frame2->data[idx];
+                output->data[idx + 1] = frame2->data[idx + 1];
+                output->data[idx + 2] = frame2->data[idx + 2];
+                output->data[idx + 3] = frame2->data[idx + 3];
+            } else {
+                // Show frame1 (old frame)
+                output->data[idx] = frame1->data[idx];
+                output->data[idx + 1] = frame1->data[idx + 1];
+                output->data[idx + 2] = frame1->data[idx + 2];
+                output->data[idx + 3] = frame1->data[idx + 3];
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Conversions
+// ============================================================================
+
+void reference_convert_rgb_to_yuv420(uint8_t* rgb_data, uint8_t* yuv_data, int width, int height) {
+    if (!rgb_data || !yuv_data || width <= 0 || height <= 0) return;
+
+    int y_size = width * height;
+    int uv_width = (width + 1) / 2;
+    int uv_size = uv_width * ((height + 1) / 2);
+
+    uint8_t* y_plane = yuv_data;
+    uint8_t* u_plane = yuv_data + y_size;
+    uint8_t* v_plane = yuv_data + y_size + uv_size;
+
+    // Convert RGB to YUV
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int rgb_idx = (y * width + x) * 3;
+            int y_idx = y * width + x;
+
+            uint8_t r = rgb_data[rgb_idx + 0];
+            uint8_t g = rgb_data[rgb_idx + 1];
+            uint8_t b = rgb_data[rgb_idx + 2];
+
+            // Calculate Y component
+            float y_val = RGB_TO_YUV_MATRIX[0] * r + RGB_TO_YUV_MATRIX[1] * g + RGB_TO_YUV_MATRIX[2] * b;
+            y_plane[y_idx] = clamp_uint8(y_val);
+
+            // Calculate U and V components (subsampled 4:2:0)
+            if ((y % 2 == 0) && (x % 2 == 0)) {
+                int uv_idx = (y / 2) * uv_width + (x / 2);
+
+                float u_val = RGB_TO_YUV_MATRIX[3] * r + RGB_TO_YUV_MATRIX[4] * g + RGB_TO_YUV_MATRIX[5] * b + 128.0f;
+                float v_val = RGB_TO_YUV_MATRIX[6] * r + RGB_TO_YUV_MATRIX[7] * g + RGB_TO_YUV_MATRIX[8] * b + 128.0f;
+
+                u_plane[uv_idx] = clamp_uint8(u_val);
+                v_plane[uv_idx] = clamp_uint8(v_val);
+            }
+        }
+    }
+
+}
+
+void reference_convert_yuv420_to_rgb(uint8_t* yuv_data, uint8_t* rgb_data, int width, int height) {
+    if (!yuv_data || !rgb_data || width <= 0 || height <= 0) return;
+
+    int y_size = width * height;
+    int uv_width = (width + 1) / 2;
+    int uv_size = uv_width * ((height + 1) / 2);
+
+    uint8_t* y_plane = yuv_data;
+    uint8_t* u_plane = yuv_data + y_size;
+    uint8_t* v_plane = yuv_data + y_size + uv_size;
+
+    // Convert YUV to RGB
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int y_idx = y * width + x;
+            int uv_idx = (y / 2) * uv_width + (x / 2);
+            int rgb_idx = (y * width + x) * 3;
+
+            float y_val = (float)y_plane[y_idx];
+            float u_val = (float)u_plane[uv_idx] - 128.0f;
+            float v_val = (float)v_plane[uv_idx] - 128.0f;
+
+            // Calculate RGB components
+            float r_val = YUV_TO_RGB_MATRIX[0] * y_val + YUV_TO_RGB_MATRIX[1] * u_val + YUV_TO_RGB_MATRIX[2] * v_val;
+            float g_val = YUV_TO_RGB_MATRIX[3] * y_val + YUV_TO_RGB_MATRIX[4] * u_val + YUV_TO_RGB_MATRIX[5] * v_val;
+            float b_val = YUV_TO_RGB_MATRIX[6] * y_val + YUV_TO_RGB_MATRIX[7] * u_val + YUV_TO_RGB_MATRIX[8] * v_val;
+
+            rgb_data[rgb_idx + 0] = clamp_uint8(r_val);
+            rgb_data[rgb_idx + 1] = clamp_uint8(g_val);
+            rgb_data[rgb_idx + 2] = clamp_uint8(b_val);
+        }
+    }
+
+}
+
+void reference_convert_rgba_to_rgb(uint8_t* rgba_data, uint8_t* rgb_data, int width, int height) {
+    if (!rgba_data || !rgb_data || width <= 0 || height <= 0) return;
+
+    int pixel_count = width * height;
+
+    for (int i = 0; i < pixel_count; i++) {
+        rgb_data[i * 3 + 0] = rgba_data[i * 4 + 0]; // R
+        rgb_data[i * 3 + 1] = rgba_data[i * 4 + 1]; // G
+        rgb_data[i * 3 + 2] = rgba_data[i * 4 + 2]; // B
+        // Skip alpha channel
+    }
+
+}
+
+void reference_convert_rgb_to_rgba(uint8_t* rgb_data, uint8_t* rgba_data, int width, int height, uint8_t alpha) {
+    if (!rgb_data || !rgba_data || width <= 0 || height <= 0) return;
+
+    int pixel_count = width * height;
+
+    for (int i = 0; i < pixel_count; i++) {
+        rgba_data[i * 4 + 0] = rgb_data[i * 3 + 0]; // R
+        rgba_data[i * 4 + 1] = rgb_data[i * 3 + 1]; // G
+        rgba_data[i * 4 + 2] = rgb_data[i * 3 + 2]; // B
+        rgba_data[i * 4 + 3] = alpha;                // A
+    }
+
+}
+
+// ============================================================================
+// Resampling
+// ============================================================================
+
+static uint32_t interpolate_pixel(uint8_t* data, int width, int height, float x, float y) {
+    int x1 = (int)floor(x);
+    int y1 = (int)floor(y);
+    int x2 = x1 + 1;
+    int y2 = y1 + 1;
+
+    // Clamp coordinates
+    x1 = x1 < 0 ? 0 : (x1 >= width ? width - 1 : x1);
+    y1 = y1 < 0 ? 0 : (y1 >= height ? height - 1 : y1);
+    x2 = x2 < 0 ? 0 : (x2 >= width ? width - 1 : x2);
+    y2 = y2 < 0 ? 0 : (y2 >= height ? height - 1 : y2);
+
+    float fx = x - x1;
+    float fy = y - y1;
+
+    // Get pixel values (assuming RGBA format)
+    uint32_t* pixels = (uint32_t*)data;
+    uint32_t p11 = pixels[y1 * width + x1];
+    uint32_t p12 = pixels[y1 * width + x2];
+    uint32_t p21 = pixels[y2 * width + x1];
+    uint32_t p22 = pixels[y2 * width + x2];
+
+    // Extract components
+    uint8_t r11 = p11 & 0xFF;
+    uint8_t g11 = (p11 >> 8) & 0xFF;
+    uint8_t b11 = (p11 >> 16) & 0xFF;
+    uint8_t a11 = (p11 >> 24) & 0xFF;
+
+    uint8_t r12 = p12 & 0xFF;
+    uint8_t g12 = (p12 >> 8) & 0xFF;
+    uint8_t b12 = (p12 >> 16) & 0xFF;
+    uint8_t a12 = (p12 >> 24) & 0xFF;
+
+    uint8_t r21 = p21 & 0xFF;
+    uint8_t g21 = (p21 >> 8) & 0xFF;
+    uint8_t b21 = (p21 >> 16) & 0xFF;
+    uint8_t a21 = (p21 >> 24) & 0xFF;
+
+    uint8_t r22 = p22 & 0xFF;
+    uint8_t g22 = (p22 >> 8) & 0xFF;
+    uint8_t b22 = (p22 >> 16) & 0xFF;
+    uint8_t a22 = (p22 >> 24) & 0xFF;
+
+    // Interpolate
+    uint8_t r = (uint8_t)(r11 * (1-fx) * (1-fy) + r12 * fx * (1-fy) + r21 * (1-fx) * fy + r22 * fx * fy);
+    uint8_t g = (uint8_t)(g11 * (1-fx) * (1-fy) + g12 * fx * (1-fy) + g21 * (1-fx) * fy + g22 * fx * fy);
+    uint8_t b = (uint8_t)(b11 * (1-fx) * (1-fy) + b12 * fx * (1-fy) + b21 * (1-fx) * fy + b22 * fx * fy);
+    uint8_t a = (uint8_t)(a11 * (1-fx) * (1-fy) + a12 * fx * (1-fy) + a21 * (1-fx) * fy + a22 * fx * fy);
+
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+void reference_frame_resize(video_frame_t* src, video_frame_t* dst, int new_width, int new_height) {
+    if (!src || !dst || !src->data || new_width <= 0 || new_height <= 0) return;
+
+    // Allocate destination data if needed
+    if (!dst->data) {
+        dst->data = (uint8_t*)malloc(new_width * new_height * 4); // RGBA
+        if (!dst->data) return;
+    }
+
+    dst->width = new_width;
+    dst->height = new_height;
+    dst->stride = new_width * 4;
+    dst->format = src->format;
+    dst->timestamp = src->timestamp;
+    dst->frame_number = src->frame_number;
+
+    // Scale factors
+    float x_scale = (float)src->width / new_width;
+    float y_scale = (float)src->height / new_height;
+
+    uint32_t* dst_pixels = (uint32_t*)dst->data;
+
+    for (int y = 0; y < new_height; y++) {
+        for (int x = 0; x < new_width; x++) {
+            float src_x = x * x_scale;
+            float src_y = y * y_scale;
+
+            uint32_t pixel = interpolate_pixel(src->data, src->width, src->height, src_x, src_y);
+            dst_pixels[y * new_width + x] = pixel;
+        }
+    }
+}
+
+void reference_frame_downscale_area(video_frame_t* src, video_frame_t* dst, int factor) {
+    if (!src || !dst || !src->data || !dst->data || factor < 1) return;
+
+    int new_width = (src->width + factor - 1) / factor;
+    int new_height = (src->height + factor - 1) / factor;
+
+    dst->width = new_width;
+    dst->height = new_height;
+    dst->stride = new_width * 4;
+    dst->format = src->format;
+    dst->timestamp = src->timestamp;
+    dst->frame_number = src->frame_number;
+
+    uint8_t* src_data = src->data;
+    uint8_t* dst_data = dst->data;
+
+    for (int y = 0; y < new_height; y++) {
+        int y0 = y * factor;
+        int y1 = y0 + factor > src->height ? src->height : y0 + factor;
+
+        for (int x = 0; x < new_width; x++) {
+            int x0 = x * factor;
+            int x1 = x0 + factor > src->width ? src->width : x0 + factor;
+
+            uint32_t sum[4] = {0, 0, 0, 0};
+            for (int sy = y0; sy < y1; sy++) {
+                uint8_t* row = src_data + ((size_t)sy * src->width + x0) * 4;
+                for (int sx = x0; sx < x1; sx++, row += 4) {
+                    sum[0] += row[0];
+                    sum[1] += row[1];
+                    sum[2] += row[2];
+                    sum[3] += row[3];
+                }
+            }
+
+            uint32_t count = (uint32_t)((y1 - y0) * (x1 - x0));
+            uint8_t* out = dst_data + ((size_t)y * new_width + x) * 4;
+            for (int c = 0; c < 4; c++) {
+                out[c] = (uint8_t)((sum[c] + count / 2) / count);
+            }
+        }
+    }
+}
+
+void reference_frame_upscale(video_frame_t* src, video_frame_t* dst, int new_width, int new_height) {
+    if (!src || !dst || !src->data || !dst->data || new_width <= 0 || new_height <= 0) return;
+
+    int* x0_tab = (int*)malloc(new_width * 2 * sizeof(int));
+    if (!x0_tab) return;
+    int* fx_tab = x0_tab + new_width;
+
+    int src_width = src->width;
+    int src_height = src->height;
+
+    // Pixel-center aligned source positions in 8.8 fixed point
+    for (int x = 0; x < new_width; x++) {
+        int pos = (int)(((x + 0.5f) * src_width / new_width - 0.5f) * 256.0f);
+        if (pos < 0) pos = 0;
+        if (pos > (src_width - 1) * 256) pos = (src_width - 1) * 256;
+        x0_tab[x] = pos >> 8;
+        fx_tab[x] = pos & 0xFF;
+    }
+
+    dst->width = new_width;
+    dst->height = new_height;
+    dst->stride = new_width * 4;
+    dst->format = src->format;
+    dst->timestamp = src->timestamp;
+    dst->frame_number = src->frame_number;
+
+    for (int y = 0; y < new_height; y++) {
+        int pos = (int)(((y + 0.5f) * src_height / new_height - 0.5f) * 256.0f);
+        if (pos < 0) pos = 0;
+        if (pos > (src_height - 1) * 256) pos = (src_height - 1) * 256;
+        int y0 = pos >> 8;
+        int y1 = y0 + 1 < src_height ? y0 + 1 : y0;
+        int fy = pos & 0xFF;
+
+        uint8_t* row0 = src->data + (size_t)y0 * src_width * 4;
+        uint8_t* row1 = src->data + (size_t)y1 * src_width * 4;
+        uint8_t* out = dst->data + (size_t)y * new_width * 4;
+
+        for (int x = 0; x < new_width; x++, out += 4) {
+            int x0 = x0_tab[x];
+            int x1 = x0 + 1 < src_width ? x0 + 1 : x0;
+            int fx = fx_tab[x];
+
+            for (int c = 0; c < 4; c++) {
+                int top = row0[x0 * 4 + c] * (256 - fx) + row0[x1 * 4 + c] * fx;
+                int bottom = row1[x0 * 4 + c] * (256 - fx) + row1[x1 * 4 + c] * fx;
+                out[c] = (uint8_t)((top * (256 - fy) + bottom * fy + 32768) >> 16);
+            }
+        }
+    }
+
+    free(x0_tab);
+}
@@ -1,11 +1,12 @@
 #include "transitions.h"
-#include <stdio.h>
+#include "render_scheduler.h"
+#include "engine_log.h"
 #include <math.h>
 #include <stdlib.h>
 
 void transition_dissolve(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
     if (!frame1 || !frame2 || !output) {
-        printf("❌ Invalid frames for dissolve transition\n");
+        LOG_WARN("Invalid frames for dissolve transition");
         return;
     }
     
@@ -15,10 +16,12 @@ void transition_dissolve(video_frame_t* frame1, video_frame_t* frame2, video_fra
     // Ensure progress is between 0 and 1
     progress = fmaxf(0.0f, fminf(1.0f, progress));
     
-    printf("🌫️ Applying dissolve transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applying dissolve transition (progress: %.2f) to %dx%d frames", progress, width, height);
     
     // Use a simple pseudo-random pattern for dissolve effect
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int idx = (y * width + x) * 4; // RGBA format
             
@@ -41,6 +44,4 @@ void transition_dissolve(video_frame_t* frame1, video_frame_t* frame2, video_fra
             }
         }
     }
-    
-    printf("✅ Dissolve transition applied successfully\n");
 }
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include "transitions.h"
-#include <stdio.h>
+#include "render_scheduler.h"
+#include "engine_log.h"
 #include <math.h>
 
 void transition_fade(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
     if (!frame1 || !frame2 || !output) {
-        printf("❌ Invalid frames for fade transition\n");
+        LOG_WARN("Invalid frames for fade transition");
         return;
     }
     
@@ -14,9 +15,11 @@ void transition_fade(video_frame_t* frame1, video_frame_t* frame2, video_frame_t
     // Ensure progress is between 0 and 1
     progress = fmaxf(0.0f, fminf(1.0f, progress));
     
-    printf("🎭 Applying fade transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applying fade transition (progress: %.2f) to %dx%d frames", progress, width, height);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int idx = (y * width + x) * 4; // RGBA format
             
@@ -41,6 +44,4 @@ void transition_fade(video_frame_t* frame1, video_frame_t* frame2, video_frame_t
             output->data[idx + 3] = (uint8_t)(a1 * alpha1 + a2 * alpha2);
         }
     }
-    
-    printf("✅ Fade transition applied successfully\n");
 }
\ No newline at end of file
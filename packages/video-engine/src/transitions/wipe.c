@@ -1,10 +1,11 @@
 #include "transitions.h"
-#include <stdio.h>
+#include "render_scheduler.h"
+#include "engine_log.h"
 #include <math.h>
 
 void transition_wipe_left(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
     if (!frame1 || !frame2 || !output) {
-        printf("❌ Invalid frames for wipe left transition\n");
+        LOG_WARN("Invalid frames for wipe left transition");
         return;
     }
     
@@ -14,12 +15,14 @@ void transition_wipe_left(video_frame_t* frame1, video_frame_t* frame2, video_fr
     // Ensure progress is between 0 and 1
     progress = fmaxf(0.0f, fminf(1.0f, progress));
     
-    printf("👈 Applying wipe left transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applying wipe left transition (progress: %.2f) to %dx%d frames", progress, width, height);
     
     // Calculate the wipe boundary
     int wipe_x = (int)(progress * width);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int idx = (y * width + x) * 4; // RGBA format
             
@@ -38,13 +41,11 @@ void transition_wipe_left(video_frame_t* frame1, video_frame_t* frame2, video_fr
             }
         }
     }
-    
-    printf("✅ Wipe left transition applied successfully\n");
 }
 
 void transition_wipe_right(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
     if (!frame1 || !frame2 || !output) {
-        printf("❌ Invalid frames for wipe right transition\n");
+        LOG_WARN("Invalid frames for wipe right transition");
         return;
     }
     
@@ -54,12 +55,14 @@ void transition_wipe_right(video_frame_t* frame1, video_frame_t* frame2, video_f
     // Ensure progress is between 0 and 1
     progress = fmaxf(0.0f, fminf(1.0f, progress));
     
-    printf("👉 Applying wipe right transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applying wipe right transition (progress: %.2f) to %dx%d frames", progress, width, height);
     
     // Calculate the wipe boundary (from right)
     int wipe_x = width - (int)(progress * width);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int idx = (y * width + x) * 4; // RGBA format
             
@@ -78,13 +81,11 @@ void transition_wipe_right(video_frame_t* frame1, video_frame_t* frame2, video_f
             }
         }
     }
-    
-    printf("✅ Wipe right transition applied successfully\n");
 }
 
 void transition_wipe_up(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
     if (!frame1 || !frame2 || !output) {
-        printf("❌ Invalid frames for wipe up transition\n");
+        LOG_WARN("Invalid frames for wipe up transition");
         return;
     }
     
@@ -94,12 +95,14 @@ void transition_wipe_up(video_frame_t* frame1, video_frame_t* frame2, video_fram
     // Ensure progress is between 0 and 1
     progress = fmaxf(0.0f, fminf(1.0f, progress));
     
-    printf("👆 Applying wipe up transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applying wipe up transition (progress: %.2f) to %dx%d frames", progress, width, height);
     
     // Calculate the wipe boundary (from bottom up)
     int wipe_y = height - (int)(progress * height);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int idx = (y * width + x) * 4; // RGBA format
             
@@ -118,13 +121,11 @@ void transition_wipe_up(video_frame_t* frame1, video_frame_t* frame2, video_fram
             }
         }
     }
-    
-    printf("✅ Wipe up transition applied successfully\n");
 }
 
 void transition_wipe_down(video_frame_t* frame1, video_frame_t* frame2, video_frame_t* output, float progress) {
     if (!frame1 || !frame2 || !output) {
-        printf("❌ Invalid frames for wipe down transition\n");
+        LOG_WARN("Invalid frames for wipe down transition");
         return;
     }
     
@@ -134,12 +135,14 @@ void transition_wipe_down(video_frame_t* frame1, video_frame_t* frame2, video_fr
     // Ensure progress is between 0 and 1
     progress = fmaxf(0.0f, fminf(1.0f, progress));
     
-    printf("👇 Applying wipe down transition (progress: %.2f) to %dx%d frames\n", progress, width, height);
+    LOG_FRAME("Applying wipe down transition (progress: %.2f) to %dx%d frames", progress, width, height);
     
     // Calculate the wipe boundary (from top down)
     int wipe_y = (int)(progress * height);
     
     for (int y = 0; y < height; y++) {
+        if (y % RENDER_CHECKPOINT_ROWS == 0 && !render_checkpoint()) break;
+
         for (int x = 0; x < width; x++) {
             int idx = (y * width + x) * 4; // RGBA format
             
@@ -158,6 +161,4 @@ void transition_wipe_down(video_frame_t* frame1, video_frame_t* frame2, video_fr
             }
         }
     }
-    
-    printf("✅ Wipe down transition applied successfully\n");
 }
\ No newline at end of file
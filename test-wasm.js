@@ -1,31 +1,303 @@
-// Quick test script for WASM module
-import VideoEngine from './packages/frontend/src/wasm/video-engine.js';
-
-async function test() {
-  try {
-    console.log('Testing WASM module...');
-    const wasmModule = await VideoEngine();
-    
-    console.log('WASM module loaded successfully!');
-    console.log('Available functions:', Object.keys(wasmModule).filter(key => typeof wasmModule[key] === 'function').slice(0, 10));
-    
-    // Test basic functionality
-    const version = wasmModule.ccall('video_engine_version', 'string', [], []);
-    console.log('Engine version:', version);
-    
-    // Test decoder creation
-    const decoderPtr = wasmModule.ccall('js_video_decoder_create', 'number', [], []);
-    console.log('Decoder created:', decoderPtr);
-    
-    if (decoderPtr) {
-      wasmModule.ccall('js_video_decoder_destroy', 'void', ['number'], [decoderPtr]);
-      console.log('Decoder destroyed successfully');
+// WASM benchmark runner: loads the built video engine in Node, checks that it
+// starts, then times each benchmark case through the same js_ bindings and
+// marshalling pattern the frontend uses (js_malloc, HEAPU8.set, ccall, copy
+// back, js_free).
+//
+//   node test-wasm.js [--size 1920x1080]... [--iterations 20] [--warmup 3]
+//                     [--cases blur,fade] [--native native.jsonl] [--json out.jsonl]
+//                     [--module path/to/video-engine.js]
+//
+// Case names and parameters match src/core/engine_benchmark.c, so results
+// join with the native benchmark (--native) on case and frame size.
+//
+// The default --module is the committed build, which predates the
+// command-buffer engine: its numbers measure the old kernels. Rebuild the
+// module with emcc and pass it with --module before quoting results.
+import { writeFileSync, readFileSync } from 'node:fs';
+import { resolve } from 'node:path';
+import { pathToFileURL } from 'node:url';
+import { performance } from 'node:perf_hooks';
+
+const FORMAT_RGBA = 1;
+const FILTER_SHARPEN = 5;
+
+// Keep in sync with bench_case_names in engine_benchmark.c
+const CASES = [
+  { name: 'color_correction', call: (m, f) => m.ccall('js_apply_color_correction_direct', null,
+      ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number'],
+      [f.ptr, f.width, f.height, 0.1, 0.2, 0.1, 10.0, 1.0, 0.0]) },
+  { name: 'blur', call: (m, f) => filter(m, 'js_apply_blur_filter', f, 3.0) },
+  { name: 'sharpen', call: (m, f) => filter(m, 'js_apply_sharpen_filter', f, 0.5) },
+  { name: 'noise_reduction', call: (m, f) => filter(m, 'js_apply_noise_reduction', f, 0.5) },
+  { name: 'transform', call: (m, f) => m.ccall('js_apply_transform', null,
+      ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number'],
+      [f.ptr, f.width, f.height, 110.0, 15.0, 0, 0, 0, 0, 100, 100]) },
+  { name: 'sepia', call: (m, f) => filter(m, 'js_apply_sepia_filter', f, 0.8) },
+  { name: 'black_and_white', call: (m, f) => filter(m, 'js_apply_black_and_white_filter', f, 0.8) },
+  { name: 'vintage', call: (m, f) => filter(m, 'js_apply_vintage_filter', f, 0.8) },
+  { name: 'vignette', call: (m, f) => filter(m, 'js_apply_vignette_filter', f, 0.8) },
+  { name: 'edge_detection', call: (m, f) => filter(m, 'js_apply_edge_detection_filter', f, 0.8) },
+  { name: 'fade', transition: true, call: (m, f) => transition(m, 'js_apply_fade_transition', f, 0.5) },
+  { name: 'dissolve', transition: true, call: (m, f) => transition(m, 'js_apply_dissolve_transition', f, 0.5) },
+  { name: 'wipe_left', transition: true, call: (m, f) => transition(m, 'js_apply_wipe_left_transition', f, 0.5) },
+  { name: 'effects_chain', chain: true, call: (m, f) => m.ccall('js_effects_process_frame', 'number',
+      ['number', 'number', 'number', 'number', 'number', 'number'],
+      [f.engine, f.ptr, f.width, f.height, FORMAT_RGBA, 0.0]) },
+];
+
+function filter(m, name, f, amount) {
+  m.ccall(name, null, ['number', 'number', 'number', 'number'], [f.ptr, f.width, f.height, amount]);
+}
+
+function transition(m, name, f, progress) {
+  m.ccall(name, null, ['number', 'number', 'number', 'number', 'number', 'number'],
+    [f.ptr, f.otherPtr, f.outputPtr, f.width, f.height, progress]);
+}
+
+function parseArgs(argv) {
+  const options = {
+    sizes: [],
+    iterations: 20,
+    warmup: 3,
+    cases: null,
+    native: null,
+    json: null,
+    module: './packages/frontend/src/wasm/video-engine.js',
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--size': {
+        const [width, height] = value.split('x').map(Number);
+        options.sizes.push({ width, height });
+        i++;
+        break;
+      }
+      case '--iterations': options.iterations = Number(value); i++; break;
+      case '--warmup': options.warmup = Number(value); i++; break;
+      case '--cases': options.cases = value.split(','); i++; break;
+      case '--native': options.native = value; i++; break;
+      case '--json': options.json = value; i++; break;
+      case '--module': options.module = value; i++; break;
+      default: throw new Error(`Unknown argument: ${argv[i]}`);
+    }
+  }
+
+  if (options.sizes.length === 0) {
+    options.sizes = [{ width: 1280, height: 720 }, { width: 1920, height: 1080 }];
+  }
+  return options;
+}
+
+function hasExport(m, name) {
+  return typeof m[`_${name}`] === 'function';
+}
+
+function median(samples) {
+  const sorted = [...samples].sort((a, b) => a - b);
+  return sorted[Math.floor(sorted.length / 2)];
+}
+
+function mean(samples) {
+  return samples.reduce((sum, s) => sum + s, 0) / samples.length;
+}
+
+// Deterministic frame content so runs are comparable
+function makeFrame(size, seed) {
+  const data = new Uint8Array(size);
+  let state = seed >>> 0;
+  for (let i = 0; i < size; i++) {
+    state ^= state << 13; state >>>= 0;
+    state ^= state >>> 17;
+    state ^= state << 5; state >>>= 0;
+    data[i] = state & 0xff;
+  }
+  return data;
+}
+
+// Load the module and exercise a few bindings before timing anything
+async function smokeTest(modulePath) {
+  const { default: VideoEngine } = await import(pathToFileURL(resolve(modulePath)).href);
+  const m = await VideoEngine();
+
+  const version = m.ccall('video_engine_version', 'string', [], []);
+  const decoderPtr = m.ccall('js_video_decoder_create', 'number', [], []);
+  if (!decoderPtr) throw new Error('js_video_decoder_create failed');
+  m.ccall('js_video_decoder_destroy', null, ['number'], [decoderPtr]);
+
+  console.log(`Video engine ${version} loaded from ${modulePath}`);
+  if (typeof m._js_engine_submit_commands !== 'function') {
+    console.warn('Warning: this module predates the command-buffer engine; results measure the old kernels');
+  }
+  return m;
+}
+
+function createChainEngine(m) {
+  const engine = m.ccall('js_effects_engine_create', 'number', [], []);
+  if (!engine) throw new Error('js_effects_engine_create failed');
+  m.ccall('js_effect_chain_add_color_correction', 'number',
+    ['number', 'number', 'number', 'number', 'number'], [engine, 0.1, 0.2, 0.1, 0.0]);
+  m.ccall('js_effect_chain_add_blur', 'number', ['number', 'number', 'number'], [engine, 2.0, 0]);
+  m.ccall('js_effect_chain_add_filter', 'number', ['number', 'number', 'number'], [engine, FILTER_SHARPEN, 0.5]);
+  return engine;
+}
+
+// Time one case end to end the way the frontend pays for a frame: allocate,
+// copy in, call, copy out, free. HEAPU8 is re-read after every call because
+// memory growth replaces the view.
+function runCase(m, testCase, width, height, options, inputs) {
+  const size = width * height * 4;
+  const engine = testCase.chain ? createChainEngine(m) : 0;
+  const phases = { alloc: [], upload: [], call: [], download: [], free: [], total: [] };
+  let output = null;
+
+  for (let i = 0; i < options.warmup + options.iterations; i++) {
+    const t0 = performance.now();
+    const f = { width, height, engine, ptr: m.ccall('js_malloc', 'number', ['number'], [size]) };
+    if (testCase.transition) {
+      f.otherPtr = m.ccall('js_malloc', 'number', ['number'], [size]);
+      f.outputPtr = m.ccall('js_malloc', 'number', ['number'], [size]);
+    }
+    if (!f.ptr || (testCase.transition && (!f.otherPtr || !f.outputPtr))) {
+      throw new Error(`js_malloc(${size}) failed`);
     }
-    
-    console.log('✅ WASM module test completed successfully!');
-  } catch (error) {
-    console.error('❌ WASM module test failed:', error);
+
+    const t1 = performance.now();
+    m.HEAPU8.set(inputs[0], f.ptr);
+    if (testCase.transition) m.HEAPU8.set(inputs[1], f.otherPtr);
+
+    const t2 = performance.now();
+    testCase.call(m, f);
+
+    const t3 = performance.now();
+    const resultPtr = testCase.transition ? f.outputPtr : f.ptr;
+    output = m.HEAPU8.slice(resultPtr, resultPtr + size);
+
+    const t4 = performance.now();
+    m.ccall('js_free', null, ['number'], [f.ptr]);
+    if (testCase.transition) {
+      m.ccall('js_free', null, ['number'], [f.otherPtr]);
+      m.ccall('js_free', null, ['number'], [f.outputPtr]);
+    }
+    const t5 = performance.now();
+
+    if (i < options.warmup) continue;
+    phases.alloc.push(t1 - t0);
+    phases.upload.push(t2 - t1);
+    phases.call.push(t3 - t2);
+    phases.download.push(t4 - t3);
+    phases.free.push(t5 - t4);
+    phases.total.push(t5 - t0);
+  }
+
+  if (engine) m.ccall('js_effects_engine_destroy', null, ['number'], [engine]);
+
+  const total = median(phases.total);
+  const marshal = median(phases.alloc) + median(phases.upload) + median(phases.download) + median(phases.free);
+  return {
+    runtime: 'wasm',
+    case: testCase.name,
+    width,
+    height,
+    iterations: options.iterations,
+    min_ms: Math.min(...phases.total),
+    median_ms: total,
+    mean_ms: mean(phases.total),
+    fps: 1000 / total,
+    mpix_per_s: (width * height) / (total * 1000),
+    call_ms: median(phases.call),
+    marshal_ms: marshal,
+    upload_ms: median(phases.upload),
+    download_ms: median(phases.download),
+    kernel_ms: kernelTime(m, testCase.name, width, height, options.iterations),
+    checksum: output ? output.reduce((sum, v) => (sum + v) >>> 0, 0) : 0,
+  };
+}
+
+// Kernel-only time measured inside WASM, when the build exports it
+function kernelTime(m, name, width, height, iterations) {
+  if (!hasExport(m, 'js_engine_benchmark_run')) return null;
+
+  const count = m.ccall('js_engine_benchmark_case_count', 'number', [], []);
+  for (let i = 0; i < count; i++) {
+    if (m.ccall('js_engine_benchmark_case_name', 'string', ['number'], [i]) !== name) continue;
+    const ptr = m.ccall('js_engine_benchmark_run', 'number',
+      ['number', 'number', 'number', 'number'], [i, width, height, iterations]);
+    return ptr ? new Float64Array(m.HEAPU8.buffer, ptr, 4)[1] : null;
+  }
+  return null;
+}
+
+function loadNative(path) {
+  const results = new Map();
+  if (!path) return results;
+
+  for (const line of readFileSync(path, 'utf8').split('\n')) {
+    if (!line.trim()) continue;
+    const r = JSON.parse(line);
+    results.set(`${r.case}@${r.width}x${r.height}`, r);
+  }
+  return results;
+}
+
+function format(value, digits = 2) {
+  return value === null || value === undefined ? '-' : value.toFixed(digits);
+}
+
+function printTable(results, native) {
+  const header = ['case', 'size', 'native ms', 'kernel ms', 'call ms', 'marshal ms', 'total ms', 'fps', 'vs native'];
+  const rows = results.map((r) => {
+    const n = native.get(`${r.case}@${r.width}x${r.height}`);
+    return [
+      r.case,
+      `${r.width}x${r.height}`,
+      format(n?.median_ms),
+      format(r.kernel_ms),
+      format(r.call_ms),
+      format(r.marshal_ms),
+      format(r.median_ms),
+      format(r.fps, 1),
+      n ? `${(r.median_ms / n.median_ms).toFixed(2)}x` : '-',
+    ];
+  });
+
+  const widths = header.map((h, i) => Math.max(h.length, ...rows.map((row) => row[i].length)));
+  const line = (cells) => cells.map((c, i) => (i < 2 ? c.padEnd(widths[i]) : c.padStart(widths[i]))).join('  ');
+  console.log(line(header));
+  console.log(widths.map((w) => '-'.repeat(w)).join('  '));
+  rows.forEach((row) => console.log(line(row)));
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const m = await smokeTest(options.module);
+  const native = loadNative(options.native);
+  const cases = CASES.filter((c) => !options.cases || options.cases.includes(c.name));
+  const results = [];
+
+  if (!hasExport(m, 'js_engine_benchmark_run')) {
+    console.log('Module has no js_engine_benchmark_run; kernel-only column skipped');
+  }
+
+  for (const { width, height } of options.sizes) {
+    const size = width * height * 4;
+    const inputs = [makeFrame(size, 0x9e3779b9), makeFrame(size, 0x85ebca6b)];
+
+    for (const testCase of cases) {
+      results.push(runCase(m, testCase, width, height, options, inputs));
+    }
+  }
+
+  printTable(results, native);
+
+  if (options.json) {
+    writeFileSync(options.json, results.map((r) => JSON.stringify(r)).join('\n') + '\n');
+    console.log(`Wrote ${results.length} results to ${options.json}`);
   }
 }
 
-test();
\ No newline at end of file
+main().catch((error) => {
+  console.error('❌ WASM benchmark failed:', error);
+  process.exitCode = 1;
+});